@@ -6,7 +6,10 @@
 
 #include <array>
 #include <cassert>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "iteratorfacades.hh"
 
@@ -43,6 +46,8 @@ namespace Dune
    * std::array is allocated. In contrast to
    * std::vector this approach prevents data copying. On the outside
    * we provide the same interface as the stl random access containers.
+   * Each list exclusively owns its arrays, i.e. copying a list copies
+   * the entries while moving a list only transfers the arrays.
    *
    * While the concept sounds quite similar to std::deque there are slight
    * but crucial differences:
@@ -151,6 +156,28 @@ namespace Dune
      */
     inline void push_back(const_reference entry);
 
+    /**
+     * @brief Append an entry to the list.
+     * @param entry The new entry to move from.
+     */
+    inline void push_back(MemberType&& entry);
+
+    /**
+     * @brief Append a range of entries to the list.
+     * @param first Iterator positioned at the first new entry.
+     * @param last Iterator positioned after the last new entry.
+     */
+    template<class InputIterator>
+    inline void push_back(InputIterator first, InputIterator last);
+
+    /**
+     * @brief Make sure that n entries can be appended without allocation.
+     *
+     * The size of the list is not changed.
+     * @param n The number of entries to reserve space for.
+     */
+    inline void reserve(size_type n);
+
     /**
      * @brief Get the element at specific position.
      * @param i The index of the position.
@@ -175,8 +202,8 @@ namespace Dune
      * @brief Purge the list.
      *
      * If there are empty chunks at the front all nonempty
-     * chunks will be moved towards the front and the capacity
-     * increases.
+     * chunks will be moved towards the front and the slots
+     * of the empty chunks are released.
      */
     inline void purge();
 
@@ -185,33 +212,70 @@ namespace Dune
      */
     inline void clear();
     /**
-     * @brief Constructs an Array list with one chunk.
+     * @brief Constructs an empty Array list.
      */
     ArrayList();
 
+    /**
+     * @brief Copy constructor, copies all entries.
+     */
+    ArrayList(const ArrayList& other);
+
+    /**
+     * @brief Move constructor, takes over the chunks of the other list.
+     *
+     * The other list is left empty.
+     */
+    ArrayList(ArrayList&& other) noexcept;
+
+    /**
+     * @brief Copy assignment, copies all entries.
+     */
+    ArrayList& operator=(const ArrayList& other);
+
+    /**
+     * @brief Move assignment, takes over the chunks of the other list.
+     *
+     * The other list is left empty.
+     */
+    ArrayList& operator=(ArrayList&& other) noexcept;
+
+    /**
+     * @brief Swap the contents with another list.
+     */
+    void swap(ArrayList& other) noexcept;
+
+    ~ArrayList();
+
   private:
 
     /**
-     * @brief The allocators for the smart pointer.
+     * @brief The type of a chunk.
      */
-    typedef typename A::template rebind<std::shared_ptr<std::array<MemberType,chunkSize_> > >::other
-    SmartPointerAllocator;
+    typedef std::array<MemberType,chunkSize_> Chunk;
 
     /**
      * @brief The allocator for the fixed array.
      */
-    typedef typename A::template rebind<std::array<MemberType,chunkSize_> >::other
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Chunk>
     ArrayAllocator;
 
+    /**
+     * @brief The allocator for the list of chunks.
+     */
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Chunk*>
+    ChunkPointerAllocator;
+
     /**
      * @brief The iterator needs access to the private variables.
      */
     friend class ArrayListIterator<T,N,A>;
     friend class ConstArrayListIterator<T,N,A>;
 
+    /** @brief The allocator for the data chunks. */
+    ArrayAllocator allocator_;
     /** @brief the data chunks of our list. */
-    std::vector<std::shared_ptr<std::array<MemberType,chunkSize_> >,
-        SmartPointerAllocator> chunks_;
+    std::vector<Chunk*, ChunkPointerAllocator> chunks_;
     /** @brief The current data capacity.
      * This is the capacity that the list could have theoretically
      * with this number of chunks. That is chunks * chunkSize.
@@ -244,6 +308,16 @@ namespace Dune
      * @return The element at that position.
      */
     inline const_reference elementAt(size_type i) const;
+
+    /**
+     * @brief Append a new chunk to the list.
+     */
+    inline void appendChunk();
+
+    /**
+     * @brief Release chunk i and mark it as empty.
+     */
+    inline void releaseChunk(size_type i);
   };
 
 
@@ -469,12 +543,100 @@ namespace Dune
   template<class T, int N, class A>
   ArrayList<T,N,A>::ArrayList()
     : capacity_(0), size_(0), start_(0)
+  {}
+
+  template<class T, int N, class A>
+  ArrayList<T,N,A>::ArrayList(const ArrayList& other)
+    : allocator_(std::allocator_traits<ArrayAllocator>::
+                 select_on_container_copy_construction(other.allocator_)),
+      capacity_(0), size_(0), start_(0)
+  {
+    push_back(other.begin(), other.end());
+  }
+
+  template<class T, int N, class A>
+  ArrayList<T,N,A>::ArrayList(ArrayList&& other) noexcept
+    : allocator_(std::move(other.allocator_)),
+      chunks_(std::move(other.chunks_)),
+      capacity_(other.capacity_), size_(other.size_), start_(other.start_)
+  {
+    other.chunks_.clear();
+    other.capacity_=0;
+    other.size_=0;
+    other.start_=0;
+  }
+
+  template<class T, int N, class A>
+  ArrayList<T,N,A>& ArrayList<T,N,A>::operator=(const ArrayList& other)
+  {
+    if(this!=&other) {
+      ArrayList tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  template<class T, int N, class A>
+  ArrayList<T,N,A>& ArrayList<T,N,A>::operator=(ArrayList&& other) noexcept
+  {
+    if(this!=&other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::swap(ArrayList& other) noexcept
+  {
+    using std::swap;
+    swap(allocator_, other.allocator_);
+    swap(chunks_, other.chunks_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(start_, other.start_);
+  }
+
+  template<class T, int N, class A>
+  ArrayList<T,N,A>::~ArrayList()
   {
-    chunks_.reserve(100);
+    clear();
+  }
+
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::appendChunk()
+  {
+    typedef std::allocator_traits<ArrayAllocator> Traits;
+    // make room first to not leak the chunk if this throws
+    chunks_.push_back(nullptr);
+    Chunk* chunk = Traits::allocate(allocator_, 1);
+    try {
+      Traits::construct(allocator_, chunk);
+    }
+    catch(...) {
+      Traits::deallocate(allocator_, chunk, 1);
+      chunks_.pop_back();
+      throw;
+    }
+    chunks_.back() = chunk;
+    capacity_ += chunkSize_;
+  }
+
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::releaseChunk(size_type i)
+  {
+    typedef std::allocator_traits<ArrayAllocator> Traits;
+    if(chunks_[i]) {
+      Traits::destroy(allocator_, chunks_[i]);
+      Traits::deallocate(allocator_, chunks_[i], 1);
+      chunks_[i] = nullptr;
+    }
   }
 
   template<class T, int N, class A>
   void ArrayList<T,N,A>::clear(){
+    for(size_type i=0; i<chunks_.size(); ++i)
+      releaseChunk(i);
     capacity_=0;
     size_=0;
     start_=0;
@@ -492,14 +654,42 @@ namespace Dune
   {
     size_t index=start_+size_;
     if(index==capacity_)
-    {
-      chunks_.push_back(std::make_shared<std::array<MemberType,chunkSize_> >());
-      capacity_ += chunkSize_;
-    }
+      appendChunk();
     elementAt(index)=entry;
     ++size_;
   }
 
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::push_back(MemberType&& entry)
+  {
+    size_t index=start_+size_;
+    if(index==capacity_)
+      appendChunk();
+    elementAt(index)=std::move(entry);
+    ++size_;
+  }
+
+  template<class T, int N, class A>
+  template<class InputIterator>
+  void ArrayList<T,N,A>::push_back(InputIterator first, InputIterator last)
+  {
+    typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+    if(std::is_base_of<std::forward_iterator_tag, Category>::value)
+      reserve(size_+std::distance(first, last));
+    for(; first!=last; ++first)
+      push_back(*first);
+  }
+
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::reserve(size_type n)
+  {
+    if(start_+n<=capacity_)
+      return;
+    chunks_.reserve((start_+n+chunkSize_-1)/chunkSize_);
+    while(capacity_<start_+n)
+      appendChunk();
+  }
+
   template<class T, int N, class A>
   typename ArrayList<T,N,A>::reference ArrayList<T,N,A>::operator[](size_type i)
   {
@@ -516,14 +706,14 @@ namespace Dune
   template<class T, int N, class A>
   typename ArrayList<T,N,A>::reference ArrayList<T,N,A>::elementAt(size_type i)
   {
-    return chunks_[i/chunkSize_]->operator[](i%chunkSize_);
+    return (*chunks_[i/chunkSize_])[i%chunkSize_];
   }
 
 
   template<class T, int N, class A>
   typename ArrayList<T,N,A>::const_reference ArrayList<T,N,A>::elementAt(size_type i) const
   {
-    return chunks_[i/chunkSize_]->operator[](i%chunkSize_);
+    return (*chunks_[i/chunkSize_])[i%chunkSize_];
   }
 
   template<class T, int N, class A>
@@ -553,19 +743,16 @@ namespace Dune
   template<class T, int N, class A>
   void ArrayList<T,N,A>::purge()
   {
-    // Distance to copy to the left.
+    // Number of empty chunks at the front.
     size_t distance = start_/chunkSize_;
     if(distance>0) {
-      // Number of chunks with entries in it;
-      size_t chunks = ((start_%chunkSize_ + size_)/chunkSize_ );
-
-      // Copy chunks to the left.
-      std::copy(chunks_.begin()+distance,
-                chunks_.begin()+(distance+chunks), chunks_.begin());
+      // The empty chunks have already been released, only the
+      // remaining chunk pointers need to move to the left.
+      chunks_.erase(chunks_.begin(), chunks_.begin()+distance);
 
       // Calculate new parameters
-      start_ = start_ % chunkSize_;
-      //capacity += distance * chunkSize_;
+      start_ -= distance * chunkSize_;
+      capacity_ -= distance * chunkSize_;
     }
   }
 
@@ -702,7 +889,7 @@ namespace Dune
     // Deallocate memory not needed any more.
     for(size_t chunk=0; chunk<chunks; chunk++) {
       --posChunkStart;
-      list_->chunks_[posChunkStart].reset();
+      list_->releaseChunk(posChunkStart);
     }
 
     // Capacity stays the same as the chunks before us
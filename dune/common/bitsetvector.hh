@@ -9,8 +9,10 @@
 
 #include <vector>
 #include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <algorithm>
+#include <memory>
 
 #include <dune/common/boundschecking.hh>
 #include <dune/common/genericiterator.hh>
@@ -21,6 +23,96 @@ namespace Dune {
   template <int block_size, class Alloc> class BitSetVector;
   template <int block_size, class Alloc> class BitSetVectorReference;
 
+  namespace Impl {
+
+    //! number of bits set in a word
+    inline int popCount(std::uint64_t w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(w);
+#else
+      w = w - ((w >> 1) & 0x5555555555555555ull);
+      w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+      w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+      return (w * 0x0101010101010101ull) >> 56;
+#endif
+    }
+
+    //! index of the lowest bit set in a nonzero word
+    inline int countTrailingZeros(std::uint64_t w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(w);
+#else
+      int n = 0;
+      for (; !(w & 1); w >>= 1)
+        ++n;
+      return n;
+#endif
+    }
+
+    //! word with the lowest len bits set, 0 < len <= 64
+    inline std::uint64_t lowBits(std::size_t len)
+    {
+      return len < 64 ? (std::uint64_t(1) << len) - 1 : ~std::uint64_t(0);
+    }
+
+    //! the bits [off, off+len) of a std::bitset, 0 < len <= 64
+    template<std::size_t n>
+    std::uint64_t bitsetChunk(const std::bitset<n>& b, std::size_t off, std::size_t len)
+    {
+      if (n <= 64)
+        return b.to_ullong() >> off & lowBits(len);
+      return ((b >> off) & std::bitset<n>(lowBits(len))).to_ullong();
+    }
+
+    /**
+       \brief A proxy class that acts as a mutable reference to a single
+       bit in a BitSetVector.
+     */
+    class BitSetVectorBitReference
+    {
+    public:
+      BitSetVectorBitReference(std::uint64_t& word, std::uint64_t mask) :
+        word_(&word), mask_(mask)
+      {}
+
+      operator bool() const
+      {
+        return (*word_ & mask_) != 0;
+      }
+
+      BitSetVectorBitReference& operator=(bool b)
+      {
+        if (b)
+          *word_ |= mask_;
+        else
+          *word_ &= ~mask_;
+        return *this;
+      }
+
+      BitSetVectorBitReference& operator=(const BitSetVectorBitReference& b)
+      {
+        return *this = bool(b);
+      }
+
+      bool operator~() const
+      {
+        return !bool(*this);
+      }
+
+      void flip()
+      {
+        *word_ ^= mask_;
+      }
+
+    private:
+      std::uint64_t* word_;
+      std::uint64_t mask_;
+    };
+
+  } // end namespace Impl
+
   /**
      \brief A proxy class that acts as a const reference to a single
      bitset in a BitSetVector.
@@ -54,8 +146,8 @@ namespace Dune {
     typedef std::bitset<block_size> bitset;
 
     // bitset interface typedefs
-    typedef typename std::vector<bool, Alloc>::const_reference reference;
-    typedef typename std::vector<bool, Alloc>::const_reference const_reference;
+    typedef bool reference;
+    typedef bool const_reference;
     typedef size_t size_type;
 
     //! Returns a copy of *this shifted left by n bits.
@@ -92,15 +184,18 @@ namespace Dune {
     size_type count() const
     {
       size_type n = 0;
-      for(size_type i=0; i<block_size; ++i)
-        n += getBit(i);
+      for (size_type off = 0; off < block_size; off += 64)
+        n += Impl::popCount(getChunk(off));
       return n;
     }
 
     //! Returns true if any bits are set.
     bool any() const
     {
-      return count();
+      for (size_type off = 0; off < block_size; off += 64)
+        if (getChunk(off))
+          return true;
+      return false;
     }
 
     //! Returns true if no bits are set.
@@ -112,8 +207,8 @@ namespace Dune {
     //! Returns true if all bits are set
     bool all() const
     {
-      for(size_type i=0; i<block_size; ++i)
-        if(not test(i))
+      for (size_type off = 0; off < block_size; off += 64)
+        if (getChunk(off) != Impl::lowBits(chunkLength(off)))
           return false;
       return true;
     }
@@ -183,13 +278,36 @@ namespace Dune {
       return blockBitField.getBit(block_number,i);
     }
 
+    //! number of bits in the chunk of this block starting at bit off
+    static size_type chunkLength(size_type off)
+    {
+      return std::min<size_type>(64, block_size - off);
+    }
+
+    //! the bits [off, off+64) of this block
+    std::uint64_t getChunk(size_type off) const
+    {
+      return blockBitField.getBits(block_number*size_type(block_size)+off, chunkLength(off));
+    }
+
+    //! the bits [off, off+64) of another block or a bitset
+    static std::uint64_t getChunk(const BitSetVectorConstReference& bs, size_type off)
+    {
+      return bs.getChunk(off);
+    }
+
+    static std::uint64_t getChunk(const bitset& bs, size_type off)
+    {
+      return Impl::bitsetChunk(bs, off, chunkLength(off));
+    }
+
     template<class BS>
     bool equals(const BS & bs) const
     {
-      bool eq = true;
-      for(int i=0; i<block_size; ++i)
-        eq &= (getBit(i) == bs[i]);
-      return eq;
+      for (size_type off = 0; off < block_size; off += 64)
+        if (getChunk(off) != getChunk(bs, off))
+          return false;
+      return true;
     }
 
   private:
@@ -235,9 +353,9 @@ namespace Dune {
     //! bitset interface typedefs
     //! \{
     //! A proxy class that acts as a reference to a single bit.
-    typedef typename std::vector<bool, Alloc>::reference reference;
+    typedef Impl::BitSetVectorBitReference reference;
     //! A proxy class that acts as a const reference to a single bit.
-    typedef typename std::vector<bool, Alloc>::const_reference const_reference;
+    typedef bool const_reference;
     //! \}
 
     //! size_type typedef (an unsigned integral type)
@@ -246,118 +364,120 @@ namespace Dune {
     //! Assignment from bool, sets each bit in the bitset to b
     BitSetVectorReference& operator=(bool b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b;
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, b ? ~std::uint64_t(0) : std::uint64_t(0));
       return (*this);
     }
 
     //! Assignment from bitset
     BitSetVectorReference& operator=(const bitset & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(b, off));
       return (*this);
     }
 
     //! Assignment from BitSetVectorConstReference
     BitSetVectorReference& operator=(const BitSetVectorConstReference & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(b, off));
       return (*this);
     }
 
     //! Assignment from BitSetVectorReference
     BitSetVectorReference& operator=(const BitSetVectorReference & b)
     {
-      for(int i=0; i<block_size; ++i)
-        getBit(i) = b.test(i);
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(b, off));
       return (*this);
     }
 
     //! Bitwise and (for bitset).
     BitSetVectorReference& operator&=(const bitset& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) & x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) & getChunk(x, off));
       return *this;
     }
 
     //! Bitwise and (for BitSetVectorConstReference and BitSetVectorReference)
     BitSetVectorReference& operator&=(const BitSetVectorConstReference& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) & x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) & getChunk(x, off));
       return *this;
     }
 
     //! Bitwise inclusive or (for bitset)
     BitSetVectorReference& operator|=(const bitset& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) | x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) | getChunk(x, off));
       return *this;
     }
 
     //! Bitwise inclusive or (for BitSetVectorConstReference and BitSetVectorReference)
     BitSetVectorReference& operator|=(const BitSetVectorConstReference& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) | x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) | getChunk(x, off));
       return *this;
     }
 
     //! Bitwise exclusive or (for bitset).
     BitSetVectorReference& operator^=(const bitset& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) ^ x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) ^ getChunk(x, off));
       return *this;
     }
 
     //! Bitwise exclusive or (for BitSetVectorConstReference and BitSetVectorReference)
     BitSetVectorReference& operator^=(const BitSetVectorConstReference& x)
     {
-      for (size_type i=0; i<block_size; i++)
-        getBit(i) = (test(i) ^ x.test(i));
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, getChunk(off) ^ getChunk(x, off));
       return *this;
     }
 
     //! Left shift.
     BitSetVectorReference& operator<<=(size_type n)
     {
-      for (size_type i=0; i<block_size-n; i++)
-        getBit(i) = test(i+n);
-      return *this;
+      // bit i is replaced by bit i+n, the upper n bits are kept
+      const bitset b = *this;
+      const bitset mask = ~bitset() >> n;
+      return *this = ((b >> n) & mask) | (b & ~mask);
     }
 
     //! Right shift.
     BitSetVectorReference& operator>>=(size_type n)
     {
-      for (size_type i=0; i<block_size-n; i++)
-        getBit(i+n) = test(i);
-      return *this;
+      // bit i+n is replaced by bit i, the lower n bits are kept
+      const bitset b = *this;
+      const bitset mask = ~bitset() << n;
+      return *this = ((b << n) & mask) | (b & ~mask);
     }
 
     // Sets every bit.
     BitSetVectorReference& set()
     {
-      for (size_type i=0; i<block_size; i++)
-        set(i);
-      return *this;
+      return *this = true;
     }
 
     //! Flips the value of every bit.
     BitSetVectorReference& flip()
     {
-      for (size_type i=0; i<block_size; i++)
-        flip(i);
+      for (size_type off = 0; off < block_size; off += 64)
+        setChunk(off, ~getChunk(off));
       return *this;
     }
 
     //! Clears every bit.
     BitSetVectorReference& reset()
-    {}
+    {
+      return *this = false;
+    }
 
     //! Sets bit n if val is nonzero, and clears bit n if val is zero.
     BitSetVectorReference& set(size_type n, int val = 1)
@@ -392,11 +512,19 @@ namespace Dune {
     BitSetVector& blockBitField;
 
     using BitSetVectorConstReference::getBit;
+    using BitSetVectorConstReference::getChunk;
+    using BitSetVectorConstReference::chunkLength;
 
     reference getBit(size_type i)
     {
       return blockBitField.getBit(this->block_number,i);
     }
+
+    //! overwrite the bits [off, off+64) of this block
+    void setChunk(size_type off, std::uint64_t value)
+    {
+      blockBitField.setBits(this->block_number*size_type(block_size)+off, chunkLength(off), value);
+    }
   };
 
   /**
@@ -428,13 +556,21 @@ namespace Dune {
 
   /**
      \brief A dynamic %array of blocks of booleans
+
+     The bits of all blocks are stored contiguously in 64-bit words, so
+     operations on whole blocks or on the whole vector process up to 64
+     bits at once.
    */
   template <int block_size, class Allocator=std::allocator<bool> >
-  class BitSetVector : private std::vector<bool, Allocator>
+  class BitSetVector
   {
-    /** \brief The implementation class: an unblocked bitfield */
+    /** \brief An unblocked bitfield, which can be converted to a BitSetVector */
     typedef std::vector<bool, Allocator> BlocklessBaseClass;
 
+    /** \brief The storage: a vector of words */
+    typedef std::vector<std::uint64_t,
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint64_t> > WordVector;
+
   public:
     //! container interface typedefs
     //! \{
@@ -489,55 +625,71 @@ namespace Dune {
 
     //! Default constructor
     BitSetVector() :
-      BlocklessBaseClass()
+      size_(0)
     {}
 
     //! Construction from an unblocked bitfield
     BitSetVector(const BlocklessBaseClass& blocklessBitField) :
-      BlocklessBaseClass(blocklessBitField)
+      size_(blocklessBitField.size()/block_size),
+      words_(numWords(size_))
     {
       if (blocklessBitField.size()%block_size != 0)
         DUNE_THROW(RangeError, "Vector size is not a multiple of the block size!");
+      for (size_type k=0; k<blocklessBitField.size(); ++k)
+        if (blocklessBitField[k])
+          words_[k/64] |= std::uint64_t(1) << (k%64);
     }
 
     /** Constructor with a given length
         \param n Number of blocks
      */
     explicit BitSetVector(int n) :
-      BlocklessBaseClass(n*block_size)
+      size_(n),
+      words_(numWords(n))
     {}
 
     //! Constructor which initializes the field with true or false
     BitSetVector(int n, bool v) :
-      BlocklessBaseClass(n*block_size,v)
-    {}
+      size_(n),
+      words_(numWords(n), v ? ~std::uint64_t(0) : std::uint64_t(0))
+    {
+      clearTail();
+    }
 
     //! Erases all of the elements.
     void clear()
     {
-      BlocklessBaseClass::clear();
+      size_ = 0;
+      words_.clear();
     }
 
     //! Resize field
     void resize(int n, bool v = bool())
     {
-      BlocklessBaseClass::resize(n*block_size, v);
+      const size_type oldBits = size_*block_size;
+      size_ = n;
+      words_.resize(numWords(n), 0);
+      clearTail();
+      if (v)
+        for (size_type k=oldBits; k<size_*block_size; k+=64)
+          setBits(k, std::min<size_type>(64, size_*block_size-k), ~std::uint64_t(0));
     }
 
     /** \brief Return the number of blocks */
     size_type size() const
     {
-      return BlocklessBaseClass::size()/block_size;
+      return size_;
     }
 
     //! Sets all entries to <tt> true </tt>
     void setAll() {
-      this->assign(BlocklessBaseClass::size(), true);
+      std::fill(words_.begin(), words_.end(), ~std::uint64_t(0));
+      clearTail();
     }
 
     //! Sets all entries to <tt> false </tt>
     void unsetAll() {
-      this->assign(BlocklessBaseClass::size(), false);
+      std::fill(words_.begin(), words_.end(), std::uint64_t(0));
     }
 
     /** \brief Return reference to i-th block */
@@ -567,7 +719,10 @@ namespace Dune {
     //! Returns the number of bits that are set.
     size_type count() const
     {
-      return std::count(BlocklessBaseClass::begin(), BlocklessBaseClass::end(), true);
+      size_type n = 0;
+      for (std::uint64_t w : words_)
+        n += Impl::popCount(w);
+      return n;
     }
 
     //! Returns the number of set bits, while each block is masked with 1<<i
@@ -580,6 +735,88 @@ namespace Dune {
       return n;
     }
 
+    /** \brief Call f(i,j) for every set bit j of every block i, in ascending order */
+    template<class F>
+    void forEachSetBit(F&& f) const
+    {
+      for (size_type w=0; w<words_.size(); ++w)
+        for (std::uint64_t bits = words_[w]; bits; bits &= bits-1)
+        {
+          const size_type k = w*64 + Impl::countTrailingZeros(bits);
+          f(k/block_size, k%block_size);
+        }
+    }
+
+    //! Bitwise and with another vector of the same size
+    BitSetVector& operator&=(const BitSetVector& other)
+    {
+      DUNE_ASSERT_BOUNDS(size() == other.size());
+      for (size_type w=0; w<words_.size(); ++w)
+        words_[w] &= other.words_[w];
+      return *this;
+    }
+
+    //! Bitwise inclusive or with another vector of the same size
+    BitSetVector& operator|=(const BitSetVector& other)
+    {
+      DUNE_ASSERT_BOUNDS(size() == other.size());
+      for (size_type w=0; w<words_.size(); ++w)
+        words_[w] |= other.words_[w];
+      return *this;
+    }
+
+    //! Bitwise exclusive or with another vector of the same size
+    BitSetVector& operator^=(const BitSetVector& other)
+    {
+      DUNE_ASSERT_BOUNDS(size() == other.size());
+      for (size_type w=0; w<words_.size(); ++w)
+        words_[w] ^= other.words_[w];
+      return *this;
+    }
+
+    //! Flips all bits
+    BitSetVector& flip()
+    {
+      for (std::uint64_t& w : words_)
+        w = ~w;
+      clearTail();
+      return *this;
+    }
+
+    //! Returns a copy with all bits flipped
+    BitSetVector operator~() const
+    {
+      BitSetVector b(*this);
+      return b.flip();
+    }
+
+    friend BitSetVector operator&(BitSetVector a, const BitSetVector& b)
+    {
+      return a &= b;
+    }
+
+    friend BitSetVector operator|(BitSetVector a, const BitSetVector& b)
+    {
+      return a |= b;
+    }
+
+    friend BitSetVector operator^(BitSetVector a, const BitSetVector& b)
+    {
+      return a ^= b;
+    }
+
+    //! Equality of two vectors
+    friend bool operator==(const BitSetVector& a, const BitSetVector& b)
+    {
+      return a.size_ == b.size_ && a.words_ == b.words_;
+    }
+
+    //! Inequality of two vectors
+    friend bool operator!=(const BitSetVector& a, const BitSetVector& b)
+    {
+      return ! (a == b);
+    }
+
     //! Send bitfield to an output stream
     friend std::ostream& operator<< (std::ostream& s, const BitSetVector& v)
     {
@@ -590,27 +827,69 @@ namespace Dune {
 
   private:
 
+    static size_type numWords(size_type blocks)
+    {
+      return (blocks*block_size + 63) / 64;
+    }
+
+    //! Clear the unused bits of the last word, so that whole words can be counted
+    void clearTail()
+    {
+      const size_type used = (size_*block_size) % 64;
+      if (used)
+        words_.back() &= Impl::lowBits(used);
+    }
+
+    //! Get the bits [k, k+len), 0 < len <= 64
+    std::uint64_t getBits(size_type k, size_type len) const
+    {
+      const size_type w = k/64, o = k%64;
+      std::uint64_t v = words_[w] >> o;
+      if (o + len > 64)
+        v |= words_[w+1] << (64-o);
+      return v & Impl::lowBits(len);
+    }
+
+    //! Set the bits [k, k+len) to value, 0 < len <= 64
+    void setBits(size_type k, size_type len, std::uint64_t value)
+    {
+      const size_type w = k/64, o = k%64;
+      const std::uint64_t mask = Impl::lowBits(len);
+      value &= mask;
+      words_[w] = (words_[w] & ~(mask << o)) | (value << o);
+      if (o + len > 64)
+        words_[w+1] = (words_[w+1] & ~(mask >> (64-o))) | (value >> (64-o));
+    }
+
     //! Get a representation as value_type
     value_type getRepr(int i) const
     {
       value_type bits;
-      for(int j=0; j<block_size; ++j)
-        bits.set(j, getBit(i,j));
+      for (size_type off = 0; off < block_size; off += 64)
+      {
+        const size_type len = std::min<size_type>(64, block_size - off);
+        bits |= value_type(getBits(i*size_type(block_size)+off, len)) << off;
+      }
       return bits;
     }
 
-    typename std::vector<bool>::reference getBit(size_type i, size_type j) {
+    Impl::BitSetVectorBitReference getBit(size_type i, size_type j) {
       DUNE_ASSERT_BOUNDS(j < block_size);
       DUNE_ASSERT_BOUNDS(i < size());
-      return BlocklessBaseClass::operator[](i*block_size+j);
+      const size_type k = i*block_size+j;
+      return Impl::BitSetVectorBitReference(words_[k/64], std::uint64_t(1) << (k%64));
     }
 
-    typename std::vector<bool>::const_reference getBit(size_type i, size_type j) const {
+    bool getBit(size_type i, size_type j) const {
       DUNE_ASSERT_BOUNDS(j < block_size);
       DUNE_ASSERT_BOUNDS(i < size());
-      return BlocklessBaseClass::operator[](i*block_size+j);
+      const size_type k = i*block_size+j;
+      return (words_[k/64] >> (k%64)) & 1;
     }
 
+    size_type size_;
+    WordVector words_;
+
     friend class BitSetVectorReference<block_size,Allocator>;
     friend class BitSetVectorConstReference<block_size,Allocator>;
   };
@@ -0,0 +1,304 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_COMMON_CONCURRENTLRU_HH
+#define DUNE_COMMON_CONCURRENTLRU_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/lru.hh>
+
+/** @file
+    @brief LRU cache which can be shared between threads
+ */
+
+namespace Dune {
+
+  /**
+      @brief LRU Cache which can be used concurrently by several threads
+
+      The entries are distributed over a number of shards by their
+      hash. Each shard is a fixed_lru guarded by its own mutex, so
+      threads working on different shards do not block each other.
+      The recency order is kept per shard, i.e. the least recently
+      used entry of the shard a new key belongs to is evicted.
+
+      As entries may be evicted by other threads at any time, data is
+      always returned by value and no iterators are provided.
+
+      get_or_compute() computes missing entries outside of the locks.
+      Threads asking for a key whose computation is already running
+      wait for its result instead of computing it again.
+
+      _Key and _Tp have to be default constructible and assignable,
+      _Tp has to be copy constructible.
+   */
+  template <typename _Key, typename _Tp,
+      typename _Hash = Dune::hash<_Key>,
+      typename _KeyEqual = std::equal_to<_Key> >
+  class concurrent_lru
+  {
+    typedef fixed_lru<_Key, _Tp, _Hash, _KeyEqual> shard_cache;
+
+  public:
+    typedef _Key key_type;
+    typedef _Tp value_type;
+    typedef std::size_t size_type;
+    //! called with key and data of an entry evicted to make room for a new one
+    typedef std::function<void(const key_type &, value_type &)> eviction_callback;
+
+    //! number of hits, misses and evictions since construction or the last reset
+    struct statistics
+    {
+      std::size_t hits;
+      std::size_t misses;
+      std::size_t evictions;
+    };
+
+    /**
+     * @brief Create an empty cache
+     *
+     * @param capacity  maximal number of entries, rounded up to a
+     *                  multiple of the number of shards
+     * @param shards    number of independently locked parts
+     * @param on_evict  called for every entry evicted by an insertion.
+     *                  It is called with the lock of the shard held and
+     *                  must not access the cache.
+     */
+    explicit concurrent_lru (size_type capacity, size_type shards = 16,
+                             eviction_callback on_evict = eviction_callback(),
+                             const _Hash & hasher = _Hash(),
+                             const _KeyEqual & equal = _KeyEqual())
+      : _hasher(hasher), _on_evict(std::move(on_evict))
+    {
+      if (shards == 0)
+        DUNE_THROW(Dune::RangeError, "A concurrent_lru needs at least one shard");
+      const size_type per_shard = (capacity + shards - 1) / shards;
+      _shards.reserve(shards);
+      for (size_type s = 0; s < shards; ++s)
+        _shards.emplace_back(new shard(per_shard,
+          [this](const key_type & key, value_type & data)
+          {
+            _evictions.fetch_add(1, std::memory_order_relaxed);
+            if (_on_evict)
+              _on_evict(key, data);
+          }, hasher, equal));
+      reset_statistics();
+    }
+
+    // the shards refer back to the cache
+    concurrent_lru (const concurrent_lru &) = delete;
+    concurrent_lru & operator= (const concurrent_lru &) = delete;
+
+    /**
+     * @brief Look up the data stored under key
+     *
+     * The entry is not marked as most recent.
+     *
+     * @return true and a copy of the data in value if the key was found
+     */
+    bool find (const key_type & key, value_type & value) const
+    {
+      shard & s = shardOf(key);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      auto it = s.cache.find(key);
+      if (it == s.cache.end())
+      {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      _hits.fetch_add(1, std::memory_order_relaxed);
+      value = it->second;
+      return true;
+    }
+
+    /**
+     * @brief Insert a value into the cache
+     *
+     * Stores value under key and marks it as most recent. If this key
+     * is already present, the associated data is replaced.
+     */
+    void insert (const key_type & key, const value_type & data)
+    {
+      shard & s = shardOf(key);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      s.cache.insert(key, data);
+    }
+
+    /**
+     * @brief mark data associated with key as most recent
+     *
+     * @return copy of the stored data
+     * @throw RangeError if key is not in the cache
+     */
+    value_type touch (const key_type & key)
+    {
+      shard & s = shardOf(key);
+      std::lock_guard<std::mutex> lock(s.mutex);
+      auto it = s.cache.find(key);
+      if (it == s.cache.end())
+      {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        DUNE_THROW(Dune::RangeError,
+          "Failed to touch key " << key << ", it is not in the lru container");
+      }
+      _hits.fetch_add(1, std::memory_order_relaxed);
+      return s.cache.touch(key);
+    }
+
+    /**
+     * @brief Return the data stored under key, computing it if necessary
+     *
+     * On a miss compute() is called without holding any lock and the
+     * result is inserted. Concurrent calls for the same key wait for
+     * the running computation and count as hits. If compute() throws,
+     * the exception is passed to all waiting callers and nothing is
+     * inserted.
+     */
+    template<class F>
+    value_type get_or_compute (const key_type & key, F && compute)
+    {
+      shard & s = shardOf(key);
+      std::unique_lock<std::mutex> lock(s.mutex);
+      auto it = s.cache.find(key);
+      if (it != s.cache.end())
+      {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return s.cache.touch(key);
+      }
+      auto pending = s.pending.find(key);
+      if (pending != s.pending.end())
+      {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        std::shared_future<value_type> result = pending->second;
+        lock.unlock();
+        return result.get();
+      }
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      std::promise<value_type> promise;
+      s.pending.emplace(key, promise.get_future().share());
+      lock.unlock();
+
+      try {
+        value_type value = compute();
+        lock.lock();
+        s.cache.insert(key, value);
+        s.pending.erase(key);
+        lock.unlock();
+        promise.set_value(value);
+        return value;
+      }
+      catch (...) {
+        if (!lock.owns_lock())
+          lock.lock();
+        s.pending.erase(key);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+    }
+
+    /**
+     * @brief Retrieve number of entries in the cache
+     *
+     * The result is only a snapshot if other threads modify the cache.
+     */
+    size_type size() const
+    {
+      size_type n = 0;
+      for (const auto & s : _shards)
+      {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        n += s->cache.size();
+      }
+      return n;
+    }
+
+    //! Retrieve the maximal number of entries in the cache
+    size_type capacity() const
+    {
+      return _shards.size() * _shards.front()->cache.capacity();
+    }
+
+    //! Retrieve the number of shards
+    size_type shards() const
+    {
+      return _shards.size();
+    }
+
+    //! Remove all entries, entries being computed are still inserted
+    void clear()
+    {
+      for (auto & s : _shards)
+      {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->cache.clear();
+      }
+    }
+
+    //! Retrieve the number of hits, misses and evictions
+    statistics stats() const
+    {
+      statistics result;
+      result.hits = _hits.load(std::memory_order_relaxed);
+      result.misses = _misses.load(std::memory_order_relaxed);
+      result.evictions = _evictions.load(std::memory_order_relaxed);
+      return result;
+    }
+
+    //! Set the hit, miss and eviction counters to zero
+    void reset_statistics()
+    {
+      _hits.store(0, std::memory_order_relaxed);
+      _misses.store(0, std::memory_order_relaxed);
+      _evictions.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    struct shard
+    {
+      template<class E>
+      shard(size_type capacity, E && on_evict,
+            const _Hash & hasher, const _KeyEqual & equal)
+        : cache(capacity, std::forward<E>(on_evict), hasher, equal),
+          pending(0, hasher, equal)
+      {}
+
+      mutable std::mutex mutex;
+      shard_cache cache;
+      std::unordered_map<key_type, std::shared_future<value_type>, _Hash, _KeyEqual> pending;
+    };
+
+    // fixed_lru uses the upper bits of the Fibonacci hash, so use a
+    // different mixing here to keep the buckets of a shard well filled
+    shard & shardOf(const key_type & key) const
+    {
+      std::uint64_t h = _hasher(key);
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33;
+      return *_shards[h % _shards.size()];
+    }
+
+    std::vector<std::unique_ptr<shard> > _shards;
+    _Hash _hasher;
+    eviction_callback _on_evict;
+    mutable std::atomic<std::size_t> _hits;
+    mutable std::atomic<std::size_t> _misses;
+    std::atomic<std::size_t> _evictions;
+  };
+
+} // namespace Dune
+
+#endif // DUNE_COMMON_CONCURRENTLRU_HH
@@ -9,23 +9,276 @@
 #include <iostream>
 #include <unistd.h>
 #include <cstdlib>
+#include <cstring>
 
 namespace Dune
 {
   namespace DebugMemory
   {
     // system constant for page size
-    const std::ptrdiff_t page_size = sysconf(_SC_PAGESIZE);
+    std::ptrdiff_t system_page_size()
+    {
+      static const std::ptrdiff_t size = sysconf(_SC_PAGESIZE);
+      return size;
+    }
+
+    const std::ptrdiff_t page_size = system_page_size();
+
+    namespace
+    {
+      void memory_corruption(const char* msg)
+      {
+        std::cerr << "Abort - Memory Corruption: " << msg << std::endl;
+        std::abort();
+      }
+
+      // layout of a chunk of the FastAllocationManager:
+      // [free list link][front canary][data][back canary]
+      const std::size_t header_size = 2 * sizeof(std::uint64_t);
+      const std::size_t canary_size = sizeof(std::uint64_t);
+      const std::size_t min_chunk_size = 32;
+      const std::size_t slab_size = 64 * 1024;
+      const unsigned char poison = 0xdd;
+
+      // the canary depends on the position, so a chunk copied as a whole
+      // does not carry valid canaries
+      std::uint64_t canary(const void* p)
+      {
+        return 0x5a3c96e1d2b4f087ull ^ reinterpret_cast<std::uintptr_t>(p);
+      }
+
+      void*& link(void* chunk)
+      {
+        return *static_cast<void**>(chunk);
+      }
+
+      void* data(void* chunk)
+      {
+        return static_cast<char*>(chunk) + header_size;
+      }
+
+      void* chunk(void* data)
+      {
+        return static_cast<char*>(data) - header_size;
+      }
+
+      void protect(void* from, std::size_t len, int prot)
+      {
+        if (mprotect(from, len, prot) == -1)
+        {
+          std::cerr << "ERROR: Failed to change protection of memory range: "
+                    << from << ", "
+                    << static_cast<void*>(static_cast<char*>(from) + len)
+                    << std::endl;
+          std::abort();
+        }
+      }
+    }
 
     // implement member functions
     void AllocationManager::allocation_error(const char* msg)
     {
-      std::cerr << "Abort - Memory Corruption: " << msg << std::endl;
-      std::abort();
+      memory_corruption(msg);
+    }
+
+    FastAllocationManager::FastAllocationManager()
+      : slab_pos(nullptr), slab_end(nullptr),
+        quarantine_pos(0), sample_rate(1000), counter(0)
+    {
+      for (size_type b = 0; b < bins; ++b)
+        free_list[b] = nullptr;
+      for (size_type q = 0; q < quarantine_size; ++q)
+        quarantine[q] = std::make_pair(nullptr, 0);
+      if (const char* rate = std::getenv("DUNE_DEBUG_ALLOCATOR_SAMPLE_RATE"))
+        sample_rate = std::strtoul(rate, nullptr, 10);
+      chunks.reserve(1024);
+    }
+
+    FastAllocationManager::~FastAllocationManager()
+    {
+      bool error = false;
+      for (const auto & c : chunks)
+      {
+        std::cerr << "ERROR: found memory chunk still in use: " <<
+        c.second.bytes << " bytes at " << c.first << std::endl;
+        error = true;
+        if (c.second.bin == heap_bin)
+          std::free(chunk(c.first));
+        else if (c.second.bin == guarded_bin)
+          munmap(c.second.page_ptr, c.second.pages * system_page_size());
+      }
+      for (size_type q = 0; q < quarantine_size; ++q)
+        if (quarantine[q].first)
+          munmap(quarantine[q].first, quarantine[q].second * system_page_size());
+      for (pointer slab : slabs)
+        std::free(slab);
+      if (error)
+        memory_corruption("lost allocations");
+    }
+
+    FastAllocationManager::pointer
+    FastAllocationManager::allocateChunk(size_type bytes, size_type n, const std::type_info & t)
+    {
+      ChunkInfo ci;
+      ci.type = &t;
+      ci.size = n;
+      ci.bytes = bytes;
+      ci.page_ptr = nullptr;
+      ci.pages = 0;
+
+      pointer ptr;
+      if (sample_rate != 0 && ++counter >= sample_rate)
+      {
+        counter = 0;
+        ci.bin = guarded_bin;
+        ptr = allocateGuarded(bytes, ci.page_ptr, ci.pages);
+      }
+      else
+      {
+        // find the smallest size class holding data and canaries
+        const size_type chunk_size = header_size + bytes + canary_size;
+        ci.bin = 0;
+        while (ci.bin < bins && (min_chunk_size << ci.bin) < chunk_size)
+          ++ci.bin;
+        pointer c;
+        if (ci.bin < bins)
+          c = allocatePooled(ci.bin);
+        else
+        {
+          c = std::malloc(chunk_size);
+          if (!c)
+            throw std::bad_alloc();
+        }
+        ptr = data(c);
+        const std::uint64_t value = canary(ptr);
+        std::memcpy(static_cast<char*>(ptr) - canary_size, &value, canary_size);
+        std::memcpy(static_cast<char*>(ptr) + bytes, &value, canary_size);
+      }
+      chunks.emplace(ptr, ci);
+      return ptr;
+    }
+
+    FastAllocationManager::pointer
+    FastAllocationManager::allocatePooled(size_type bin)
+    {
+      const size_type chunk_size = min_chunk_size << bin;
+      pointer c = free_list[bin];
+      if (c)
+      {
+        free_list[bin] = link(c);
+        // verify that the chunk has not been written to since it was freed
+        const unsigned char* p = static_cast<const unsigned char*>(data(c));
+        for (size_type i = 0; i < chunk_size - header_size; ++i)
+          if (p[i] != poison)
+            memory_corruption("write access after free");
+        return c;
+      }
+      if (slab_pos == nullptr || slab_pos + chunk_size > slab_end)
+      {
+        // the remainder of the old slab is lost, which is at most one chunk
+        pointer slab = std::malloc(slab_size);
+        if (!slab)
+          throw std::bad_alloc();
+        slabs.push_back(slab);
+        slab_pos = static_cast<char*>(slab);
+        slab_end = slab_pos + slab_size;
+      }
+      c = slab_pos;
+      slab_pos += chunk_size;
+      return c;
+    }
+
+    FastAllocationManager::pointer
+    FastAllocationManager::allocateGuarded(size_type bytes, pointer & page_ptr, size_type & pages)
+    {
+      pages = bytes / system_page_size() + 2;
+      page_ptr = mmap(NULL, pages * system_page_size(),
+                      PROT_READ | PROT_WRITE,
+#ifdef __APPLE__
+                      MAP_ANON | MAP_PRIVATE,
+#else
+                      MAP_ANONYMOUS | MAP_PRIVATE,
+#endif
+                      -1, 0);
+      if (MAP_FAILED == page_ptr)
+        throw std::bad_alloc();
+      char* guard = static_cast<char*>(page_ptr) + (pages-1) * system_page_size();
+      // write protect memory behind the actual data
+      protect(guard, system_page_size(), PROT_NONE);
+      return guard - bytes;
+    }
+
+    void FastAllocationManager::checkCanaries(pointer ptr, size_type bytes) const
+    {
+      const std::uint64_t expected = canary(ptr);
+      std::uint64_t value;
+      std::memcpy(&value, static_cast<char*>(ptr) - canary_size, canary_size);
+      if (value != expected)
+        memory_corruption("canary in front of memory chunk overwritten");
+      std::memcpy(&value, static_cast<char*>(ptr) + bytes, canary_size);
+      if (value != expected)
+        memory_corruption("canary behind memory chunk overwritten");
+    }
+
+    void FastAllocationManager::deallocateChunk(pointer ptr, size_type n, const std::type_info & t) noexcept
+    {
+      ChunkMap::iterator it = chunks.find(ptr);
+      if (it == chunks.end())
+        memory_corruption("memory block not found");
+      const ChunkInfo ci = it->second;
+      if (n != 0 && n != ci.size)
+        memory_corruption("Assertion n == ci.size failed");
+      if (t != *(ci.type))
+        memory_corruption("Assertion typeid(T) == *(ci.type) failed");
+      chunks.erase(it);
+
+      if (ci.bin == guarded_bin)
+      {
+        // keep freed memory protected for a while to catch access after free
+        protect(ci.page_ptr, ci.pages * system_page_size(), PROT_NONE);
+        std::pair<pointer, size_type> & q = quarantine[quarantine_pos];
+        if (q.first)
+          munmap(q.first, q.second * system_page_size());
+        q = std::make_pair(ci.page_ptr, ci.pages);
+        quarantine_pos = (quarantine_pos + 1) % quarantine_size;
+        return;
+      }
+
+      checkCanaries(ptr, ci.bytes);
+      pointer c = chunk(ptr);
+      if (ci.bin == heap_bin)
+      {
+        std::free(c);
+        return;
+      }
+      std::memset(ptr, poison, (min_chunk_size << ci.bin) - header_size);
+      link(c) = free_list[ci.bin];
+      free_list[ci.bin] = c;
+    }
+
+    void FastAllocationManager::check() const
+    {
+      for (const auto & c : chunks)
+        if (c.second.bin != guarded_bin)
+          checkCanaries(c.first, c.second.bytes);
     }
 
     // global instance of AllocationManager
-    AllocationManager alloc_man;
+    AllocationManager& allocation_manager()
+    {
+      static AllocationManager manager;
+      return manager;
+    }
+
+    // global instance of FastAllocationManager
+    FastAllocationManager& fast_allocation_manager()
+    {
+      static FastAllocationManager manager;
+      return manager;
+    }
+
+    AllocationManager& alloc_man = allocation_manager();
+    FastAllocationManager& fast_alloc_man = fast_allocation_manager();
 
   }   // end namespace DebugMemory
 } // end namespace Dune
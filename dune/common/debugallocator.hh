@@ -5,7 +5,10 @@
 
 #include <dune/common/unused.hh>
 #include <exception>
+#include <functional>
 #include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <iostream>
 #include <cstring>
@@ -31,6 +34,10 @@ namespace Dune
   namespace DebugMemory
   {
 
+    // system constant for page size
+    std::ptrdiff_t system_page_size();
+
+    // the page size, only valid after static initialization of libdunecommon
     extern const std::ptrdiff_t page_size;
 
     struct AllocationManager
@@ -63,8 +70,12 @@ namespace Dune
         bool not_free;
       };
 
-      typedef MallocAllocator<AllocationInfo> Alloc;
-      typedef std::vector<AllocationInfo, Alloc> AllocationList;
+      // chunks are keyed by the address handed out, which allows to find
+      // the chunk of a pointer without searching
+      typedef MallocAllocator<std::pair<const pointer, AllocationInfo> > Alloc;
+      typedef std::unordered_map<pointer, AllocationInfo,
+                                 std::hash<pointer>, std::equal_to<pointer>,
+                                 Alloc> AllocationList;
       AllocationList allocation_list;
 
     private:
@@ -104,13 +115,13 @@ namespace Dune
         bool error = false;
         for (it=allocation_list.begin(); it!=allocation_list.end(); it++)
         {
-          if (it->not_free)
+          if (it->second.not_free)
           {
             std::cerr << "ERROR: found memory chunk still in use: " <<
-            it->capacity << " bytes at " << it->ptr << std::endl;
+            it->second.capacity << " bytes at " << it->second.ptr << std::endl;
             error = true;
           }
-          munmap(it->page_ptr, it->pages * page_size);
+          munmap(it->second.page_ptr, it->second.pages * system_page_size());
         }
         if (error)
           allocation_error("lost allocations");
@@ -123,10 +134,10 @@ namespace Dune
         AllocationInfo ai(typeid(T));
         ai.size = n;
         ai.capacity = n * sizeof(T);
-        ai.pages = (ai.capacity) / page_size + 2;
+        ai.pages = (ai.capacity) / system_page_size() + 2;
         ai.not_free = true;
-        size_type overlap = ai.capacity % page_size;
-        ai.page_ptr = mmap(NULL, ai.pages * page_size,
+        size_type overlap = ai.capacity % system_page_size();
+        ai.page_ptr = mmap(NULL, ai.pages * system_page_size(),
                            PROT_READ | PROT_WRITE,
 #ifdef __APPLE__
                            MAP_ANON | MAP_PRIVATE,
@@ -138,13 +149,13 @@ namespace Dune
         {
           throw std::bad_alloc();
         }
-        ai.ptr = static_cast<char*>(ai.page_ptr) + page_size - overlap;
+        ai.ptr = static_cast<char*>(ai.page_ptr) + system_page_size() - overlap;
         // write protect memory behind the actual data
-        memprotect(static_cast<char*>(ai.page_ptr) + (ai.pages-1) * page_size,
-                   page_size,
+        memprotect(static_cast<char*>(ai.page_ptr) + (ai.pages-1) * system_page_size(),
+                   system_page_size(),
                    PROT_NONE);
         // remember the chunk
-        allocation_list.push_back(ai);
+        allocation_list.emplace(ai.ptr, ai);
         // return the ptr
         return static_cast<T*>(ai.ptr);
       }
@@ -152,49 +163,142 @@ namespace Dune
       template<typename T>
       void deallocate(T* ptr, size_type n = 0) noexcept
       {
-        // compute page address
-        void* page_ptr =
-          static_cast<void*>(
-            (char*)(ptr) - ((std::uintptr_t)(ptr) % page_size));
-        // search list
-        AllocationList::iterator it;
-        unsigned int i = 0;
-        for (it=allocation_list.begin(); it!=allocation_list.end(); it++, i++)
+        // look up chunk
+        AllocationList::iterator it = allocation_list.find(static_cast<void*>(ptr));
+        if (it != allocation_list.end())
         {
-          if (it->page_ptr == page_ptr)
-          {
-            // std::cout << "found memory_block in allocation " << i << std::endl;
-            // sanity checks
-            if (n != 0)
-              ALLOCATION_ASSERT(n == it->size);
-            ALLOCATION_ASSERT(ptr == it->ptr);
-            ALLOCATION_ASSERT(true == it->not_free);
-            ALLOCATION_ASSERT(typeid(T) == *(it->type));
-            // free memory
-            it->not_free = false;
+          AllocationInfo & ai = it->second;
+          // sanity checks
+          if (n != 0)
+            ALLOCATION_ASSERT(n == ai.size);
+          ALLOCATION_ASSERT(ptr == ai.ptr);
+          ALLOCATION_ASSERT(true == ai.not_free);
+          ALLOCATION_ASSERT(typeid(T) == *(ai.type));
+          // free memory
+          ai.not_free = false;
 #if DEBUG_ALLOCATOR_KEEP
-            // write protect old memory
-            memprotect(it->page_ptr,
-                       (it->pages) * page_size,
-                       PROT_NONE);
+          // write protect old memory
+          memprotect(ai.page_ptr,
+                     (ai.pages) * system_page_size(),
+                     PROT_NONE);
 #else
-            // unprotect old memory
-            memprotect(it->page_ptr,
-                       (it->pages) * page_size,
-                       PROT_READ | PROT_WRITE);
-            munmap(it->page_ptr, it->pages * page_size);
-            // remove chunk info
-            allocation_list.erase(it);
+          // unprotect old memory
+          memprotect(ai.page_ptr,
+                     (ai.pages) * system_page_size(),
+                     PROT_READ | PROT_WRITE);
+          munmap(ai.page_ptr, ai.pages * system_page_size());
+          // remove chunk info
+          allocation_list.erase(it);
 #endif
-            return;
-          }
+          return;
         }
         allocation_error("memory block not found");
       }
     };
 #undef ALLOCATION_ASSERT
 
-    extern AllocationManager alloc_man;
+    // The managers are function-local statics, so they are constructed on
+    // first use, e.g. by operator new called from static initializers of
+    // other translation units.
+    AllocationManager& allocation_manager();
+
+    // references to the managers, only valid after static initialization of libdunecommon
+    extern AllocationManager& alloc_man;
+
+    /*
+     * Allocation manager for the pooled mode of the debug allocator.
+     *
+     * Chunks are carved from pooled arenas and framed by canaries, which are
+     * verified on deallocation and on demand through check().  Freed pool
+     * chunks are poisoned and the poison is verified on reuse.  Only every
+     * sampleRate()-th allocation is placed in front of a protected page,
+     * like all allocations of the AllocationManager.
+     */
+    struct FastAllocationManager
+    {
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef void* pointer;
+
+      FastAllocationManager();
+      ~FastAllocationManager();
+
+      template<typename T>
+      T* allocate(size_type n)
+      {
+        return static_cast<T*>(allocateChunk(n * sizeof(T), n, typeid(T)));
+      }
+
+      template<typename T>
+      void deallocate(T* ptr, size_type n = 0) noexcept
+      {
+        deallocateChunk(ptr, n, typeid(T));
+      }
+
+      //! verify the canaries of all chunks still in use
+      void check() const;
+
+      //! place every n-th allocation in front of a protected page, n = 0 disables sampling
+      void setSampleRate(size_type n)
+      {
+        sample_rate = n;
+      }
+
+      size_type sampleRate() const
+      {
+        return sample_rate;
+      }
+
+    private:
+      FastAllocationManager(const FastAllocationManager&) = delete;
+      FastAllocationManager& operator=(const FastAllocationManager&) = delete;
+
+      pointer allocateChunk(size_type bytes, size_type n, const std::type_info & t);
+      void deallocateChunk(pointer ptr, size_type n, const std::type_info & t) noexcept;
+
+      pointer allocatePooled(size_type bin);
+      pointer allocateGuarded(size_type bytes, pointer & page_ptr, size_type & pages);
+      void checkCanaries(pointer ptr, size_type bytes) const;
+
+      // number of pool size classes, chunk sizes range from 32 to 4096 bytes
+      static const size_type bins = 8;
+      // marks chunks which do not stem from the pool
+      static const size_type heap_bin = bins;
+      static const size_type guarded_bin = bins + 1;
+      static const size_type quarantine_size = 16;
+
+      struct ChunkInfo
+      {
+        const std::type_info * type;
+        size_type size;
+        size_type bytes;
+        size_type bin;
+        pointer page_ptr;
+        size_type pages;
+      };
+
+      typedef MallocAllocator<std::pair<const pointer, ChunkInfo> > ChunkAlloc;
+      typedef std::unordered_map<pointer, ChunkInfo,
+                                 std::hash<pointer>, std::equal_to<pointer>,
+                                 ChunkAlloc> ChunkMap;
+      ChunkMap chunks;
+
+      pointer free_list[bins];
+      std::vector<pointer, MallocAllocator<pointer> > slabs;
+      char * slab_pos;
+      char * slab_end;
+
+      // freed guarded chunks stay protected until they drop out of the quarantine
+      std::pair<pointer, size_type> quarantine[quarantine_size];
+      size_type quarantine_pos;
+
+      size_type sample_rate;
+      size_type counter;
+    };
+
+    FastAllocationManager& fast_allocation_manager();
+
+    extern FastAllocationManager& fast_alloc_man;
   }   // end namespace DebugMemory
 #endif // DOXYGEN
 
@@ -232,6 +336,9 @@ namespace Dune
      - overload new/delte
      - use the Debug memory management for new/delete
      - DEBUG_NEW_DELETE > 2 gives extensive debug output
+
+     Mapping a page per allocation is expensive. For large runs
+     consider the FastDebugAllocator instead.
    */
   template <class T>
   class DebugAllocator {
@@ -269,13 +376,124 @@ namespace Dune
                      DebugAllocator<void>::const_pointer hint = 0)
     {
       DUNE_UNUSED_PARAMETER(hint);
-      return DebugMemory::alloc_man.allocate<T>(n);
+      return DebugMemory::allocation_manager().allocate<T>(n);
+    }
+
+    //! deallocate n objects of type T at address p
+    void deallocate(pointer p, size_type n)
+    {
+      DebugMemory::allocation_manager().deallocate<T>(p,n);
+    }
+
+    //! max size for allocate
+    size_type max_size() const noexcept
+    {
+      return size_type(-1) / sizeof(T);
+    }
+
+    //! copy-construct an object of type T (i.e. make a placement new on p)
+    void construct(pointer p, const T& val)
+    {
+      ::new((void*)p)T(val);
+    }
+
+    //! construct an object of type T from variadic parameters
+    template<typename ... _Args>
+    void construct(pointer p, _Args&&... __args)
+    {
+      ::new((void *)p)T(std::forward<_Args>(__args) ...);
+    }
+
+    //! destroy an object of type T (i.e. call the destructor)
+    void destroy(pointer p)
+    {
+      p->~T();
+    }
+  };
+
+  template<class T>
+  class FastDebugAllocator;
+
+  // specialize for void
+  template <>
+  class FastDebugAllocator<void> {
+  public:
+    typedef void* pointer;
+    typedef const void* const_pointer;
+    // reference to void members are impossible.
+    typedef void value_type;
+    template <class U> struct rebind {
+      typedef FastDebugAllocator<U> other;
+    };
+  };
+
+  /**
+     @ingroup Allocators
+     @brief Pooled variant of the DebugAllocator
+
+     Intended for large runs where mapping a page per allocation is
+     too expensive.  We check:
+     - write access directly before and past the end, using canaries
+       which are verified upon deallocation
+     - write access after free of small chunks, which are poisoned
+       upon deallocation and verified upon reuse
+     - only free memory which was allocated with this allocator
+     - double free
+     - list allocated memory chunks still in use upon destruction of the allocator
+
+     In addition, every n-th allocation is guarded by a protected page
+     as in the DebugAllocator, which catches read access past the end
+     and access after free of these chunks. The rate defaults to 1000
+     and can be changed through the environment variable
+     DUNE_DEBUG_ALLOCATOR_SAMPLE_RATE or through
+     DebugMemory::fast_allocation_manager().setSampleRate().
+
+     When defining DEBUG_NEW_DELETE together with DEBUG_ALLOCATOR_FAST,
+     new/delete use this memory management instead.
+   */
+  template <class T>
+  class FastDebugAllocator {
+  public:
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T value_type;
+    template <class U> struct rebind {
+      typedef FastDebugAllocator<U> other;
+    };
+
+    //! create a new FastDebugAllocator
+    FastDebugAllocator() noexcept {}
+    //! copy construct from an other FastDebugAllocator, possibly for a different result type
+    template <class U>
+    FastDebugAllocator(const FastDebugAllocator<U>&) noexcept {}
+    //! cleanup this allocator
+    ~FastDebugAllocator() noexcept {}
+
+    pointer address(reference x) const
+    {
+      return &x;
+    }
+    const_pointer address(const_reference x) const
+    {
+      return &x;
+    }
+
+    //! allocate n objects of type T
+    pointer allocate(size_type n,
+                     FastDebugAllocator<void>::const_pointer hint = 0)
+    {
+      DUNE_UNUSED_PARAMETER(hint);
+      return DebugMemory::fast_allocation_manager().allocate<T>(n);
     }
 
     //! deallocate n objects of type T at address p
     void deallocate(pointer p, size_type n)
     {
-      DebugMemory::alloc_man.deallocate<T>(p,n);
+      DebugMemory::fast_allocation_manager().deallocate<T>(p,n);
     }
 
     //! max size for allocate
@@ -306,10 +524,16 @@ namespace Dune
 }
 
 #ifdef DEBUG_NEW_DELETE
+#if DEBUG_ALLOCATOR_FAST
+#define DUNE_DEBUG_NEW_DELETE_MANAGER Dune::DebugMemory::fast_allocation_manager()
+#else
+#define DUNE_DEBUG_NEW_DELETE_MANAGER Dune::DebugMemory::allocation_manager()
+#endif
+
 void * operator new(size_t size)
 {
   // try to allocate size bytes
-  void *p = Dune::DebugMemory::alloc_man.allocate<char>(size);
+  void *p = DUNE_DEBUG_NEW_DELETE_MANAGER.allocate<char>(size);
 #if DEBUG_NEW_DELETE > 2
   std::cout << "NEW " << size
             << " -> " << p
@@ -323,9 +547,11 @@ void operator delete(void * p) noexcept
 #if DEBUG_NEW_DELETE > 2
   std::cout << "FREE " << p << std::endl;
 #endif
-  Dune::DebugMemory::alloc_man.deallocate<char>(static_cast<char*>(p));
+  DUNE_DEBUG_NEW_DELETE_MANAGER.deallocate<char>(static_cast<char*>(p));
 }
 
+#undef DUNE_DEBUG_NEW_DELETE_MANAGER
+
 #endif // DEBUG_NEW_DELETE
 
 #endif // HAVE_PROTECT
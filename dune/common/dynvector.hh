@@ -15,6 +15,7 @@
 #include "boundschecking.hh"
 #include "exceptions.hh"
 #include "genericiterator.hh"
+#include "hash.hh"
 
 #include <vector>
 #include "densevector.hh"
@@ -47,6 +48,9 @@ namespace Dune {
   };
 
   /** \brief Construct a vector with a dynamic size.
+   *
+   * Every non-empty DynamicVector allocates its entries from the heap.
+   * If most vectors are small, consider SmallDynamicVector instead.
    *
    * \tparam K is the field type (use float, double, complex, etc)
    * \tparam Allocator type of allocator object used to define the storage allocation model,
@@ -178,6 +182,23 @@ namespace Dune {
     return in;
   }
 
+#ifndef DOXYGEN
+  namespace Impl {
+
+    // the values of a DynamicVector are stored contiguously, see hash_range()
+    template<class K, class Allocator>
+    struct IsContiguousIterator<DenseIterator<DenseVector<DynamicVector<K,Allocator> >, K> >
+      : std::true_type
+    {};
+
+    template<class K, class Allocator>
+    struct IsContiguousIterator<DenseIterator<const DenseVector<DynamicVector<K,Allocator> >, const K> >
+      : std::true_type
+    {};
+
+  } // end namespace Impl
+#endif // DOXYGEN
+
   /** @} end documentation */
 
 } // end namespace
@@ -0,0 +1,738 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_COMMON_FLATHASHMAP_HH
+#define DUNE_COMMON_FLATHASHMAP_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/iteratorfacades.hh>
+
+/** @file
+ * @brief Hash map and hash set storing their entries in one contiguous array.
+ */
+
+namespace Dune {
+
+  namespace Impl {
+
+    //! Extracts the key from the entries of a FlatHashSet
+    struct FlatHashSetKey
+    {
+      template<class V>
+      const V& operator()(const V& v) const { return v; }
+    };
+
+    //! Extracts the key from the entries of a FlatHashMap
+    struct FlatHashMapKey
+    {
+      template<class V>
+      const typename V::first_type& operator()(const V& v) const { return v.first; }
+    };
+
+    /**
+     * @brief Open-addressing hash table with Robin Hood hashing
+     *
+     * The entries are stored in a single array. Each slot has a byte
+     * holding the distance of its entry to its home bucket plus one,
+     * zero marks an empty slot. Insertion lets entries far from their
+     * home take the place of entries closer to theirs, which keeps the
+     * probe sequences short and allows unsuccessful lookups to stop
+     * early. Erasure shifts the following entries back, so there are no
+     * tombstones.
+     *
+     * Probe sequences do not wrap around: the array has a few slots
+     * more than buckets, and the table grows if a probe sequence would
+     * get longer than that.
+     */
+    template<class Key, class Value, class KeyOf, class Hash, class KeyEqual, class Allocator>
+    class FlatHashTable
+    {
+      typedef std::allocator_traits<Allocator> AllocatorTraits;
+      typedef typename AllocatorTraits::template rebind_alloc<Value> ValueAllocator;
+      typedef std::allocator_traits<ValueAllocator> ValueAllocatorTraits;
+      typedef typename AllocatorTraits::template rebind_alloc<std::uint8_t> DistanceAllocator;
+
+      template<class C, class V>
+      class IteratorBase
+        : public ForwardIteratorFacade<IteratorBase<C,V>, V>
+      {
+        friend class FlatHashTable;
+        template<class, class> friend class IteratorBase;
+      public:
+        IteratorBase() : table_(nullptr), slot_(0) {}
+
+        IteratorBase(C* table, std::size_t slot) : table_(table), slot_(slot) {}
+
+        // allow conversion from iterator to const_iterator
+        template<class C2, class V2>
+        IteratorBase(const IteratorBase<C2,V2>& other)
+          : table_(other.table_), slot_(other.slot_) {}
+
+        template<class C2, class V2>
+        bool equals(const IteratorBase<C2,V2>& other) const
+        {
+          return slot_ == other.slot_;
+        }
+
+        V& dereference() const
+        {
+          return table_->values_[slot_];
+        }
+
+        void increment()
+        {
+          slot_ = table_->nextOccupied(slot_+1);
+        }
+
+      private:
+        C* table_;
+        std::size_t slot_;
+      };
+
+    public:
+      typedef Key key_type;
+      typedef Value value_type;
+      typedef std::size_t size_type;
+      typedef Hash hasher;
+      typedef KeyEqual key_equal;
+      typedef Allocator allocator_type;
+
+      FlatHashTable(size_type buckets, const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+        : hash_(hash), equal_(equal), alloc_(alloc), distances_(1, 0, DistanceAllocator(alloc))
+      {
+        if (buckets > 0)
+          rehash(buckets);
+      }
+
+      FlatHashTable(const FlatHashTable& other)
+        : hash_(other.hash_), equal_(other.equal_),
+          alloc_(ValueAllocatorTraits::select_on_container_copy_construction(other.alloc_)),
+          maxLoadFactor_(other.maxLoadFactor_),
+          distances_(1, 0, other.distances_.get_allocator())
+      {
+        copyFrom(other);
+      }
+
+      FlatHashTable(FlatHashTable&& other)
+        : hash_(std::move(other.hash_)), equal_(std::move(other.equal_)),
+          alloc_(std::move(other.alloc_)), distances_(1, 0, other.distances_.get_allocator())
+      {
+        steal(other);
+      }
+
+      ~FlatHashTable()
+      {
+        deallocate();
+      }
+
+      FlatHashTable& operator=(const FlatHashTable& other)
+      {
+        if (this != &other)
+        {
+          clear();
+          hash_ = other.hash_;
+          equal_ = other.equal_;
+          copyFrom(other);
+        }
+        return *this;
+      }
+
+      FlatHashTable& operator=(FlatHashTable&& other)
+      {
+        if (this != &other)
+        {
+          deallocate();
+          hash_ = std::move(other.hash_);
+          equal_ = std::move(other.equal_);
+          alloc_ = std::move(other.alloc_);
+          steal(other);
+        }
+        return *this;
+      }
+
+      void swap(FlatHashTable& other)
+      {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+        swap(alloc_, other.alloc_);
+        swap(maxLoadFactor_, other.maxLoadFactor_);
+        swap(values_, other.values_);
+        distances_.swap(other.distances_);
+        swap(size_, other.size_);
+        swap(buckets_, other.buckets_);
+        swap(shift_, other.shift_);
+        swap(maxProbe_, other.maxProbe_);
+      }
+
+      typedef IteratorBase<FlatHashTable, Value> iterator;
+      typedef IteratorBase<const FlatHashTable, const Value> const_iterator;
+
+      iterator begin() { return iterator(this, nextOccupied(0)); }
+      const_iterator begin() const { return const_iterator(this, nextOccupied(0)); }
+      const_iterator cbegin() const { return begin(); }
+      iterator end() { return iterator(this, slots()); }
+      const_iterator end() const { return const_iterator(this, slots()); }
+      const_iterator cend() const { return end(); }
+
+      //! Returns true if the container holds no entries
+      bool empty() const { return size_ == 0; }
+
+      //! Returns the number of entries
+      size_type size() const { return size_; }
+
+      //! Returns the number of buckets, always a power of two
+      size_type bucket_count() const { return buckets_; }
+
+      //! Returns the average number of entries per bucket
+      float load_factor() const
+      {
+        return buckets_ == 0 ? 0.0f : float(size_) / float(buckets_);
+      }
+
+      //! Returns the load factor above which the table grows
+      float max_load_factor() const { return maxLoadFactor_; }
+
+      //! Sets the load factor above which the table grows, rehashing if necessary
+      void max_load_factor(float ml)
+      {
+        if (!(ml > 0.0f && ml <= 0.95f))
+          DUNE_THROW(RangeError, "Invalid maximal load factor " << ml);
+        maxLoadFactor_ = ml;
+        reserve(size_);
+      }
+
+      //! Removes all entries, keeping the memory
+      void clear()
+      {
+        for (size_type i = 0; i < slots(); ++i)
+          if (distances_[i] != 0)
+          {
+            ValueAllocatorTraits::destroy(alloc_, values_ + i);
+            distances_[i] = 0;
+          }
+        size_ = 0;
+      }
+
+      //! Sets the number of buckets to at least n and rehashes all entries
+      void rehash(size_type n)
+      {
+        n = std::max(n, bucketsFor(size_));
+        size_type buckets = 8;
+        while (buckets < n)
+          buckets *= 2;
+        if (buckets != buckets_)
+          resize(buckets);
+      }
+
+      //! Makes room for n entries without further rehashing
+      void reserve(size_type n)
+      {
+        rehash(bucketsFor(n));
+      }
+
+      iterator find(const Key& key)
+      {
+        return iterator(this, lookup(key));
+      }
+
+      const_iterator find(const Key& key) const
+      {
+        return const_iterator(this, lookup(key));
+      }
+
+      size_type count(const Key& key) const
+      {
+        return lookup(key) != slots() ? 1 : 0;
+      }
+
+      std::pair<iterator, bool> insert(const Value& value)
+      {
+        return emplaceKey(KeyOf()(value), value);
+      }
+
+      std::pair<iterator, bool> insert(Value&& value)
+      {
+        return emplaceKey(KeyOf()(value), std::move(value));
+      }
+
+      template<class It>
+      void insert(It first, It last)
+      {
+        for (; first != last; ++first)
+          insert(*first);
+      }
+
+      template<class... Args>
+      std::pair<iterator, bool> emplace(Args&&... args)
+      {
+        Value value(std::forward<Args>(args)...);
+        return insert(std::move(value));
+      }
+
+      //! Inserts an entry constructed from args unless key is already present
+      template<class... Args>
+      std::pair<iterator, bool> emplaceKey(const Key& key, Args&&... args)
+      {
+        const std::size_t h = hash_(key);
+        const size_type slot = lookup(key, h);
+        if (slot != slots())
+          return std::make_pair(iterator(this, slot), false);
+        // the arguments may refer into the table, thus construct before rehashing
+        Value value(std::forward<Args>(args)...);
+        if (size_ + 1 > size_type(maxLoadFactor_ * buckets_))
+          rehash(2*std::max<size_type>(buckets_, 4));
+        return std::make_pair(iterator(this, place(std::move(value), h)), true);
+      }
+
+      size_type erase(const Key& key)
+      {
+        const size_type slot = lookup(key);
+        if (slot == slots())
+          return 0;
+        eraseSlot(slot);
+        return 1;
+      }
+
+      //! Erases the entry at pos and returns an iterator to the next entry
+      iterator erase(const_iterator pos)
+      {
+        const size_type slot = pos.slot_;
+        eraseSlot(slot);
+        // an entry may have been shifted into the erased slot
+        return iterator(this, nextOccupied(slot));
+      }
+
+      hasher hash_function() const { return hash_; }
+      key_equal key_eq() const { return equal_; }
+      allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+    private:
+      size_type slots() const
+      {
+        return distances_.size() - 1;
+      }
+
+      size_type bucketsFor(size_type n) const
+      {
+        return size_type(n / maxLoadFactor_) + 1;
+      }
+
+      // Fibonacci hashing spreads weak hashes like the identity over all
+      // buckets. The hash is perturbed depending on the table size, as
+      // otherwise inserting the entries of a larger table in its iteration
+      // order would fill only the first buckets of a smaller one.
+      size_type home(std::size_t h) const
+      {
+        const std::uint64_t perturbation = 0xc2b2ae3d27d4eb4full * shift_;
+        return size_type(((std::uint64_t(h) ^ perturbation) * 0x9e3779b97f4a7c15ull) >> shift_);
+      }
+
+      size_type nextOccupied(size_type slot) const
+      {
+        while (slot < slots() && distances_[slot] == 0)
+          ++slot;
+        return slot;
+      }
+
+      size_type lookup(const Key& key) const
+      {
+        if (size_ == 0)
+          return slots();
+        return lookup(key, hash_(key));
+      }
+
+      size_type lookup(const Key& key, std::size_t h) const
+      {
+        if (size_ == 0)
+          return slots();
+        size_type slot = home(h);
+        // the sentinel has distance zero, which ends every probe sequence
+        for (unsigned int d = 1; distances_[slot] >= d; ++slot, ++d)
+          if (distances_[slot] == d && equal_(KeyOf()(values_[slot]), key))
+            return slot;
+        return slots();
+      }
+
+      // inserts value, which must not be present, and returns its slot
+      //
+      // Robin Hood insertion puts the new entry into the first slot holding an
+      // entry closer to its home and shifts the entries up to the next empty
+      // slot by one. Whether all probe sequences stay short enough is checked
+      // before anything is modified, otherwise the table grows. If it is
+      // almost empty, the hash function is too poor and a RangeError is thrown
+      // unless growOnly is set.
+      size_type place(Value&& value, std::size_t h, bool growOnly = false)
+      {
+        size_type slot = home(h);
+        unsigned int d = 1;
+        // the sentinel has distance zero, which ends the search
+        while (distances_[slot] >= d)
+        {
+          ++slot;
+          ++d;
+        }
+        bool fits = (d <= maxProbe_);
+        size_type empty = slot;
+        for (; fits && distances_[empty] != 0; ++empty)
+          fits = (distances_[empty] < maxProbe_);
+        if (!fits || empty == slots())
+        {
+          if (!growOnly && size_ < buckets_ / 8)
+            DUNE_THROW(RangeError, "Too many hash collisions in FlatHashTable, "
+                       << size_ << " entries in " << buckets_ << " buckets");
+          resize(2*buckets_);
+          return place(std::move(value), h, growOnly);
+        }
+
+        if (empty == slot)
+          ValueAllocatorTraits::construct(alloc_, values_ + slot, std::move(value));
+        else
+        {
+          ValueAllocatorTraits::construct(alloc_, values_ + empty, std::move(values_[empty-1]));
+          for (size_type i = empty-1; i > slot; --i)
+          {
+            values_[i] = std::move(values_[i-1]);
+            distances_[i+1] = distances_[i] + 1;
+          }
+          distances_[slot+1] = distances_[slot] + 1;
+          values_[slot] = std::move(value);
+        }
+        distances_[slot] = std::uint8_t(d);
+        ++size_;
+        return slot;
+      }
+
+      void eraseSlot(size_type slot)
+      {
+        // shift back the following entries which are not at their home
+        while (distances_[slot+1] > 1)
+        {
+          values_[slot] = std::move(values_[slot+1]);
+          distances_[slot] = distances_[slot+1] - 1;
+          ++slot;
+        }
+        ValueAllocatorTraits::destroy(alloc_, values_ + slot);
+        distances_[slot] = 0;
+        --size_;
+      }
+
+      void resize(size_type buckets)
+      {
+        Value* oldValues = values_;
+        std::vector<std::uint8_t, DistanceAllocator> oldDistances(1, 0, distances_.get_allocator());
+        oldDistances.swap(distances_);
+        const size_type oldSlots = oldDistances.size() - 1;
+
+        buckets_ = buckets;
+        shift_ = 64;
+        for (size_type b = buckets; b > 1; b /= 2)
+          --shift_;
+        maxProbe_ = std::min<unsigned int>(254, std::max<unsigned int>(16, 4*(64-shift_)));
+        distances_.assign(buckets_ + maxProbe_ + 1, 0);
+        values_ = ValueAllocatorTraits::allocate(alloc_, slots());
+        size_ = 0;
+
+        for (size_type i = 0; i < oldSlots; ++i)
+          if (oldDistances[i] != 0)
+          {
+            place(std::move(oldValues[i]), hash_(KeyOf()(oldValues[i])), true);
+            ValueAllocatorTraits::destroy(alloc_, oldValues + i);
+          }
+        if (oldValues)
+          ValueAllocatorTraits::deallocate(alloc_, oldValues, oldSlots);
+      }
+
+      void deallocate()
+      {
+        if (values_)
+        {
+          clear();
+          ValueAllocatorTraits::deallocate(alloc_, values_, slots());
+        }
+        values_ = nullptr;
+        distances_.assign(1, 0);
+        buckets_ = 0;
+        size_ = 0;
+      }
+
+      void copyFrom(const FlatHashTable& other)
+      {
+        maxLoadFactor_ = other.maxLoadFactor_;
+        reserve(other.size_);
+        for (size_type i = 0; i < other.slots(); ++i)
+          if (other.distances_[i] != 0)
+            place(Value(other.values_[i]), hash_(KeyOf()(other.values_[i])), true);
+      }
+
+      void steal(FlatHashTable& other)
+      {
+        maxLoadFactor_ = other.maxLoadFactor_;
+        values_ = other.values_;
+        distances_.swap(other.distances_);
+        size_ = other.size_;
+        buckets_ = other.buckets_;
+        shift_ = other.shift_;
+        maxProbe_ = other.maxProbe_;
+        other.values_ = nullptr;
+        other.distances_.assign(1, 0);
+        other.size_ = 0;
+        other.buckets_ = 0;
+      }
+
+      Hash hash_;
+      KeyEqual equal_;
+      ValueAllocator alloc_;
+      float maxLoadFactor_ = 0.8f;
+      Value* values_ = nullptr;
+      // distance to the home bucket plus one for each slot, followed by a zero sentinel
+      std::vector<std::uint8_t, DistanceAllocator> distances_;
+      size_type size_ = 0;
+      size_type buckets_ = 0;
+      unsigned int shift_ = 64;
+      unsigned int maxProbe_ = 0;
+    };
+
+  } // end namespace Impl
+
+  /** @addtogroup Common
+   *
+   * @{
+   */
+
+  /**
+   * @brief A hash map storing its entries in one contiguous array.
+   *
+   * The interface follows std::unordered_map, but the entries are stored
+   * in place using Robin Hood hashing with backward-shift deletion
+   * instead of in separately allocated nodes. This makes lookups and
+   * iteration cache friendly and avoids one allocation per entry.
+   *
+   * Contrary to std::unordered_map,
+   *  - the entries are of type std::pair<Key,T>; the key must not be modified,
+   *  - inserting and erasing entries invalidates all iterators, references
+   *    and pointers, except that erase(pos) returns an iterator to the next entry,
+   *  - Key and T have to be move assignable.
+   *
+   * @tparam Key       type of the keys
+   * @tparam T         type of the mapped values
+   * @tparam Hash      hash function, defaults to Dune::hash
+   * @tparam KeyEqual  equality of keys
+   * @tparam Allocator allocator for the entries
+   */
+  template<class Key, class T,
+           class Hash = Dune::hash<Key>,
+           class KeyEqual = std::equal_to<Key>,
+           class Allocator = std::allocator<std::pair<Key,T> > >
+  class FlatHashMap
+    : public Impl::FlatHashTable<Key, std::pair<Key,T>, Impl::FlatHashMapKey, Hash, KeyEqual, Allocator>
+  {
+    typedef Impl::FlatHashTable<Key, std::pair<Key,T>, Impl::FlatHashMapKey, Hash, KeyEqual, Allocator> Base;
+
+  public:
+    typedef T mapped_type;
+    typedef typename Base::size_type size_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    //! Creates an empty map with at least the given number of buckets
+    explicit FlatHashMap(size_type buckets = 0, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : Base(buckets, hash, equal, alloc)
+    {}
+
+    //! Creates a map holding the entries of the range [first,last)
+    template<class It>
+    FlatHashMap(It first, It last, size_type buckets = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : Base(buckets, hash, equal, alloc)
+    {
+      this->insert(first, last);
+    }
+
+    //! Creates a map holding the given entries
+    FlatHashMap(std::initializer_list<std::pair<Key,T> > init, size_type buckets = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : FlatHashMap(init.begin(), init.end(), buckets, hash, equal, alloc)
+    {}
+
+    //! Inserts a value constructed from args unless key is already present
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+      return this->emplaceKey(key, std::piecewise_construct,
+                              std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    //! Inserts value under key or assigns it if key is already present
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+    {
+      auto result = try_emplace(key, std::forward<M>(value));
+      if (!result.second)
+        result.first->second = std::forward<M>(value);
+      return result;
+    }
+
+    //! Returns the value mapped to key, inserting a default constructed one if necessary
+    T& operator[](const Key& key)
+    {
+      return try_emplace(key).first->second;
+    }
+
+    //! Returns the value mapped to key, throws a RangeError if key is not present
+    T& at(const Key& key)
+    {
+      auto it = this->find(key);
+      if (it == this->end())
+        DUNE_THROW(RangeError, "Key not found in FlatHashMap");
+      return it->second;
+    }
+
+    //! Returns the value mapped to key, throws a RangeError if key is not present
+    const T& at(const Key& key) const
+    {
+      auto it = this->find(key);
+      if (it == this->end())
+        DUNE_THROW(RangeError, "Key not found in FlatHashMap");
+      return it->second;
+    }
+  };
+
+  /**
+   * @brief A hash set storing its entries in one contiguous array.
+   *
+   * This is the set counterpart of FlatHashMap, see there for the
+   * differences to std::unordered_set. The entries cannot be modified
+   * through the iterators.
+   *
+   * @tparam Key       type of the entries
+   * @tparam Hash      hash function, defaults to Dune::hash
+   * @tparam KeyEqual  equality of entries
+   * @tparam Allocator allocator for the entries
+   */
+  template<class Key,
+           class Hash = Dune::hash<Key>,
+           class KeyEqual = std::equal_to<Key>,
+           class Allocator = std::allocator<Key> >
+  class FlatHashSet
+    : public Impl::FlatHashTable<Key, Key, Impl::FlatHashSetKey, Hash, KeyEqual, Allocator>
+  {
+    typedef Impl::FlatHashTable<Key, Key, Impl::FlatHashSetKey, Hash, KeyEqual, Allocator> Base;
+
+  public:
+    typedef typename Base::size_type size_type;
+    typedef typename Base::const_iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    //! Creates an empty set with at least the given number of buckets
+    explicit FlatHashSet(size_type buckets = 0, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : Base(buckets, hash, equal, alloc)
+    {}
+
+    //! Creates a set holding the entries of the range [first,last)
+    template<class It>
+    FlatHashSet(It first, It last, size_type buckets = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : Base(buckets, hash, equal, alloc)
+    {
+      Base::insert(first, last);
+    }
+
+    //! Creates a set holding the given entries
+    FlatHashSet(std::initializer_list<Key> init, size_type buckets = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const Allocator& alloc = Allocator())
+      : FlatHashSet(init.begin(), init.end(), buckets, hash, equal, alloc)
+    {}
+
+    const_iterator begin() const { return Base::begin(); }
+    const_iterator end() const { return Base::end(); }
+
+    const_iterator find(const Key& key) const { return Base::find(key); }
+
+    std::pair<const_iterator, bool> insert(const Key& key)
+    {
+      return Base::insert(key);
+    }
+
+    std::pair<const_iterator, bool> insert(Key&& key)
+    {
+      return Base::insert(std::move(key));
+    }
+
+    template<class It>
+    void insert(It first, It last)
+    {
+      Base::insert(first, last);
+    }
+
+    template<class... Args>
+    std::pair<const_iterator, bool> emplace(Args&&... args)
+    {
+      return Base::emplace(std::forward<Args>(args)...);
+    }
+  };
+
+  //! Two maps are equal if they hold the same entries
+  template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+  bool operator==(const FlatHashMap<Key,T,Hash,KeyEqual,Allocator>& a,
+                  const FlatHashMap<Key,T,Hash,KeyEqual,Allocator>& b)
+  {
+    if (a.size() != b.size())
+      return false;
+    for (const auto& entry : a)
+    {
+      auto it = b.find(entry.first);
+      if (it == b.end() || !(it->second == entry.second))
+        return false;
+    }
+    return true;
+  }
+
+  template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+  bool operator!=(const FlatHashMap<Key,T,Hash,KeyEqual,Allocator>& a,
+                  const FlatHashMap<Key,T,Hash,KeyEqual,Allocator>& b)
+  {
+    return !(a == b);
+  }
+
+  //! Two sets are equal if they hold the same entries
+  template<class Key, class Hash, class KeyEqual, class Allocator>
+  bool operator==(const FlatHashSet<Key,Hash,KeyEqual,Allocator>& a,
+                  const FlatHashSet<Key,Hash,KeyEqual,Allocator>& b)
+  {
+    if (a.size() != b.size())
+      return false;
+    for (const auto& key : a)
+      if (b.find(key) == b.end())
+        return false;
+    return true;
+  }
+
+  template<class Key, class Hash, class KeyEqual, class Allocator>
+  bool operator!=(const FlatHashSet<Key,Hash,KeyEqual,Allocator>& a,
+                  const FlatHashSet<Key,Hash,KeyEqual,Allocator>& b)
+  {
+    return !(a == b);
+  }
+
+  /** @} */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_FLATHASHMAP_HH
@@ -0,0 +1,509 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_COMMON_FLATMAP_HH
+#define DUNE_COMMON_FLATMAP_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+/** @file
+ * @brief Associative container storing its entries in a sorted vector.
+ */
+
+namespace Dune {
+
+  /**
+   * @brief Tag marking input which is already sorted and free of duplicate keys.
+   *
+   * Passing it to the constructors and to insert() of FlatMap skips
+   * the sorting of the input.
+   */
+  struct SortedUnique {};
+
+  /**
+   * @brief Map storing its entries sorted by key in a contiguous array.
+   *
+   * The interface follows std::map. Lookup is done by binary search,
+   * iteration walks over consecutive memory. This makes FlatMap a
+   * good choice for small maps which are built once and then searched
+   * and traversed often, e.g. tables with one entry per neighbouring
+   * process. Inserting or erasing in the middle moves all following
+   * entries, but inserting keys in ascending order only appends.
+   *
+   * In contrast to std::map, inserting and erasing invalidates all
+   * iterators and references to entries. The entries are of type
+   * std::pair<Key,T>, the key must not be modified through an
+   * iterator.
+   *
+   * @tparam Key The type of the keys.
+   * @tparam T The type of the mapped values.
+   * @tparam Compare The strict weak ordering of the keys.
+   * @tparam Allocator The allocator used for the entries.
+   */
+  template<class Key, class T, class Compare = std::less<Key>,
+      class Allocator = std::allocator<std::pair<Key,T> > >
+  class FlatMap
+  {
+  public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key,T> value_type;
+    typedef Compare key_compare;
+    typedef Allocator allocator_type;
+    //! The type of the underlying sorted array.
+    typedef std::vector<value_type,Allocator> container_type;
+    typedef typename container_type::size_type size_type;
+    typedef typename container_type::difference_type difference_type;
+    typedef typename container_type::reference reference;
+    typedef typename container_type::const_reference const_reference;
+    typedef typename container_type::pointer pointer;
+    typedef typename container_type::const_pointer const_pointer;
+    typedef typename container_type::iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+    typedef typename container_type::reverse_iterator reverse_iterator;
+    typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+
+    //! Compares entries by their keys.
+    class value_compare
+    {
+      friend class FlatMap;
+    public:
+      bool operator()(const value_type& a, const value_type& b) const
+      {
+        return comp_(a.first, b.first);
+      }
+    protected:
+      value_compare(const Compare& comp) : comp_(comp) {}
+      Compare comp_;
+    };
+
+    //! Create an empty map.
+    FlatMap() {}
+
+    //! Create an empty map using the given comparison and allocator.
+    explicit FlatMap(const Compare& comp, const Allocator& alloc = Allocator())
+      : values_(alloc), comp_(comp)
+    {}
+
+    //! Create an empty map using the given allocator.
+    explicit FlatMap(const Allocator& alloc)
+      : values_(alloc)
+    {}
+
+    /**
+     * @brief Create a map from an arbitrary range of entries.
+     *
+     * If a key occurs more than once, the first entry is kept.
+     */
+    template<class InputIterator>
+    FlatMap(InputIterator first, InputIterator last,
+            const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+      : values_(alloc), comp_(comp)
+    {
+      insert(first, last);
+    }
+
+    /**
+     * @brief Create a map from a range sorted by key without duplicate keys.
+     *
+     * The entries are copied without any comparison.
+     */
+    template<class InputIterator>
+    FlatMap(SortedUnique, InputIterator first, InputIterator last,
+            const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+      : values_(first, last, alloc), comp_(comp)
+    {
+      assert(isSortedUnique());
+    }
+
+    /**
+     * @brief Create a map taking over a vector sorted by key without duplicate keys.
+     */
+    FlatMap(SortedUnique, container_type&& values, const Compare& comp = Compare())
+      : values_(std::move(values)), comp_(comp)
+    {
+      assert(isSortedUnique());
+    }
+
+    //! Create a map from a list of entries, keeping the first entry of repeated keys.
+    FlatMap(std::initializer_list<value_type> values,
+            const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+      : FlatMap(values.begin(), values.end(), comp, alloc)
+    {}
+
+    FlatMap& operator=(std::initializer_list<value_type> values)
+    {
+      clear();
+      insert(values.begin(), values.end());
+      return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+      return values_.get_allocator();
+    }
+
+    iterator begin() { return values_.begin(); }
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator cbegin() const { return values_.cbegin(); }
+    iterator end() { return values_.end(); }
+    const_iterator end() const { return values_.end(); }
+    const_iterator cend() const { return values_.cend(); }
+    reverse_iterator rbegin() { return values_.rbegin(); }
+    const_reverse_iterator rbegin() const { return values_.rbegin(); }
+    const_reverse_iterator crbegin() const { return values_.crbegin(); }
+    reverse_iterator rend() { return values_.rend(); }
+    const_reverse_iterator rend() const { return values_.rend(); }
+    const_reverse_iterator crend() const { return values_.crend(); }
+
+    bool empty() const { return values_.empty(); }
+    size_type size() const { return values_.size(); }
+    size_type max_size() const { return values_.max_size(); }
+
+    //! The number of entries which fit into the allocated storage.
+    size_type capacity() const { return values_.capacity(); }
+
+    //! Allocate storage for at least n entries.
+    void reserve(size_type n) { values_.reserve(n); }
+
+    //! Release unused storage.
+    void shrink_to_fit() { values_.shrink_to_fit(); }
+
+    //! Access to the sorted entries.
+    const container_type& values() const { return values_; }
+
+    /**
+     * @brief Get the value stored under key, inserting a default constructed one if necessary.
+     */
+    mapped_type& operator[](const key_type& key)
+    {
+      return try_emplace(key).first->second;
+    }
+
+    mapped_type& operator[](key_type&& key)
+    {
+      return try_emplace(std::move(key)).first->second;
+    }
+
+    /**
+     * @brief Get the value stored under key.
+     * @throw RangeError if the key is not in the map.
+     */
+    mapped_type& at(const key_type& key)
+    {
+      iterator it = find(key);
+      if(it == end())
+        DUNE_THROW(RangeError, "Key not found in FlatMap");
+      return it->second;
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+      const_iterator it = find(key);
+      if(it == end())
+        DUNE_THROW(RangeError, "Key not found in FlatMap");
+      return it->second;
+    }
+
+    /**
+     * @brief Insert an entry if its key is not yet in the map.
+     * @return The position of the entry with that key and whether the
+     * entry was inserted.
+     */
+    std::pair<iterator,bool> insert(const value_type& value)
+    {
+      return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator,bool> insert(value_type&& value)
+    {
+      return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    /**
+     * @brief Insert an entry if its key is not yet in the map, starting the search at hint.
+     *
+     * Inserting directly before hint takes constant time apart from
+     * moving the following entries.
+     */
+    iterator insert(const_iterator hint, const value_type& value)
+    {
+      return emplaceHint(hint, value.first, value.second);
+    }
+
+    iterator insert(const_iterator hint, value_type&& value)
+    {
+      return emplaceHint(hint, std::move(value.first), std::move(value.second));
+    }
+
+    /**
+     * @brief Insert a range of entries.
+     *
+     * Entries whose key is already in the map or occurs earlier in the
+     * range are ignored. The new entries are appended, sorted and
+     * merged, i.e. this takes O(N log N) for N entries in total.
+     */
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type oldSize = values_.size();
+      values_.insert(values_.end(), first, last);
+      const iterator middle = values_.begin() + oldSize;
+      const value_compare comp = value_comp();
+      std::stable_sort(middle, values_.end(), comp);
+      std::inplace_merge(values_.begin(), middle, values_.end(), comp);
+      removeDuplicates();
+    }
+
+    /**
+     * @brief Insert a range sorted by key without duplicate keys.
+     *
+     * Entries whose key is already in the map are ignored.
+     */
+    template<class InputIterator>
+    void insert(SortedUnique, InputIterator first, InputIterator last)
+    {
+      const size_type oldSize = values_.size();
+      values_.insert(values_.end(), first, last);
+      const iterator middle = values_.begin() + oldSize;
+      const value_compare comp = value_comp();
+      // only merge if the new entries do not simply follow the old ones
+      if(oldSize != 0 && middle != values_.end() && comp(*middle, *std::prev(middle)))
+        std::inplace_merge(values_.begin(), middle, values_.end(), comp);
+      removeDuplicates();
+    }
+
+    void insert(std::initializer_list<value_type> values)
+    {
+      insert(values.begin(), values.end());
+    }
+
+    //! Construct an entry from args and insert it if its key is not yet in the map.
+    template<class... Args>
+    std::pair<iterator,bool> emplace(Args&&... args)
+    {
+      return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    //! Construct an entry from args and insert it if its key is not yet in the map.
+    template<class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args)
+    {
+      return insert(hint, value_type(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Insert an entry with a value constructed from args if key is not yet in the map.
+     *
+     * Nothing is constructed if the key is already present.
+     */
+    template<class K, class... Args>
+    std::pair<iterator,bool> try_emplace(K&& key, Args&&... args)
+    {
+      // appending is the common case when filling the map in order
+      if(values_.empty() || comp_(values_.back().first, key)) {
+        values_.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(std::forward<K>(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(std::prev(values_.end()), true);
+      }
+      iterator pos = lower_bound(key);
+      if(pos != end() && !comp_(key, pos->first))
+        return std::make_pair(pos, false);
+      pos = values_.emplace(pos, std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+      return std::make_pair(pos, true);
+    }
+
+    //! Insert an entry or assign to the value of the existing entry with that key.
+    template<class M>
+    std::pair<iterator,bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+      std::pair<iterator,bool> result = try_emplace(key, std::forward<M>(obj));
+      if(!result.second)
+        result.first->second = std::forward<M>(obj);
+      return result;
+    }
+
+    //! Erase the entry at pos and return the position of the next one.
+    iterator erase(const_iterator pos)
+    {
+      return values_.erase(pos);
+    }
+
+    iterator erase(iterator pos)
+    {
+      return values_.erase(pos);
+    }
+
+    //! Erase the entries in [first, last) and return the position of the next one.
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      return values_.erase(first, last);
+    }
+
+    //! Erase the entry with the given key, returns the number of erased entries.
+    size_type erase(const key_type& key)
+    {
+      iterator pos = find(key);
+      if(pos == end())
+        return 0;
+      values_.erase(pos);
+      return 1;
+    }
+
+    void clear()
+    {
+      values_.clear();
+    }
+
+    void swap(FlatMap& other)
+    {
+      using std::swap;
+      values_.swap(other.values_);
+      swap(comp_, other.comp_);
+    }
+
+    size_type count(const key_type& key) const
+    {
+      return find(key) == end() ? 0 : 1;
+    }
+
+    iterator find(const key_type& key)
+    {
+      iterator pos = lower_bound(key);
+      return (pos == end() || comp_(key, pos->first)) ? end() : pos;
+    }
+
+    const_iterator find(const key_type& key) const
+    {
+      const_iterator pos = lower_bound(key);
+      return (pos == end() || comp_(key, pos->first)) ? end() : pos;
+    }
+
+    iterator lower_bound(const key_type& key)
+    {
+      return std::lower_bound(begin(), end(), key, KeyCompare(comp_));
+    }
+
+    const_iterator lower_bound(const key_type& key) const
+    {
+      return std::lower_bound(begin(), end(), key, KeyCompare(comp_));
+    }
+
+    iterator upper_bound(const key_type& key)
+    {
+      return std::upper_bound(begin(), end(), key, KeyCompare(comp_));
+    }
+
+    const_iterator upper_bound(const key_type& key) const
+    {
+      return std::upper_bound(begin(), end(), key, KeyCompare(comp_));
+    }
+
+    std::pair<iterator,iterator> equal_range(const key_type& key)
+    {
+      iterator first = lower_bound(key);
+      iterator last = (first == end() || comp_(key, first->first)) ? first : std::next(first);
+      return std::make_pair(first, last);
+    }
+
+    std::pair<const_iterator,const_iterator> equal_range(const key_type& key) const
+    {
+      const_iterator first = lower_bound(key);
+      const_iterator last = (first == end() || comp_(key, first->first)) ? first : std::next(first);
+      return std::make_pair(first, last);
+    }
+
+    key_compare key_comp() const
+    {
+      return comp_;
+    }
+
+    value_compare value_comp() const
+    {
+      return value_compare(comp_);
+    }
+
+    friend bool operator==(const FlatMap& a, const FlatMap& b)
+    {
+      return a.values_ == b.values_;
+    }
+
+    friend bool operator!=(const FlatMap& a, const FlatMap& b)
+    {
+      return a.values_ != b.values_;
+    }
+
+    friend void swap(FlatMap& a, FlatMap& b)
+    {
+      a.swap(b);
+    }
+
+  private:
+    // compares entries with keys in both orders as needed by the binary searches
+    struct KeyCompare
+    {
+      KeyCompare(const Compare& comp) : comp_(comp) {}
+
+      bool operator()(const value_type& value, const key_type& key) const
+      {
+        return comp_(value.first, key);
+      }
+
+      bool operator()(const key_type& key, const value_type& value) const
+      {
+        return comp_(key, value.first);
+      }
+
+      const Compare& comp_;
+    };
+
+    template<class K, class M>
+    iterator emplaceHint(const_iterator hint, K&& key, M&& obj)
+    {
+      // use the hint if key belongs directly before it
+      if((hint == end() || comp_(key, hint->first))
+         && (hint == begin() || comp_(std::prev(hint)->first, key)))
+        return values_.emplace(hint, std::forward<K>(key), std::forward<M>(obj));
+      return try_emplace(std::forward<K>(key), std::forward<M>(obj)).first;
+    }
+
+    // keeps the first of each sequence of entries with equivalent keys
+    void removeDuplicates()
+    {
+      const Compare& comp = comp_;
+      values_.erase(std::unique(values_.begin(), values_.end(),
+                                [&comp](const value_type& a, const value_type& b)
+                                {
+                                  return !comp(a.first, b.first);
+                                }),
+                    values_.end());
+    }
+
+    bool isSortedUnique() const
+    {
+      for(const_iterator it = begin(); it != end() && std::next(it) != end(); ++it)
+        if(!comp_(it->first, std::next(it)->first))
+          return false;
+      return true;
+    }
+
+    container_type values_;
+    Compare comp_;
+  };
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_FLATMAP_HH
@@ -17,6 +17,7 @@
 #include "exceptions.hh"
 
 #include "ftraits.hh"
+#include "hash.hh"
 #include "densevector.hh"
 #include "unused.hh"
 #include "boundschecking.hh"
@@ -485,6 +486,23 @@ namespace Dune {
   }
 #endif
 
+#ifndef DOXYGEN
+  namespace Impl {
+
+    // the values of a FieldVector are stored contiguously, see hash_range()
+    template<class K, int n>
+    struct IsContiguousIterator<DenseIterator<DenseVector<FieldVector<K,n> >, K> >
+      : std::true_type
+    {};
+
+    template<class K, int n>
+    struct IsContiguousIterator<DenseIterator<const DenseVector<FieldVector<K,n> >, const K> >
+      : std::true_type
+    {};
+
+  } // end namespace Impl
+#endif // DOXYGEN
+
   /** @} end documentation */
 
 } // end namespace
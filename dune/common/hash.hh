@@ -3,7 +3,15 @@
 #ifndef DUNE_COMMON_HASH_HH
 #define DUNE_COMMON_HASH_HH
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/typetraits.hh>
 
@@ -98,6 +106,23 @@ namespace Dune {
 #define DUNE_DEFINE_HASH(template_args,type)
 
 
+//! Defines a hash specialization for a type whose objects can be hashed as raw bytes.
+/**
+ * This works like DUNE_DEFINE_HASH, but instead of calling `hash_value()`, the generated
+ * specialization hashes the object representation using Dune::hash_bytes(). Moreover,
+ * Dune::IsBytewiseHashable is specialized for the type, so hash_range() hashes contiguous
+ * arrays of the type in a single pass.
+ *
+ * Only use this macro if the type is trivially copyable, contains no padding bytes and two
+ * objects compare equal exactly if their object representations are equal.
+ *
+ * \param template_args  The template arguments required by the hash struct specialization,
+ *                       wrapped in a call to DUNE_HASH_TEMPLATE_ARGS. If this is a complete
+ *                       specialization, call DUNE_HASH_TEMPLATE_ARGS without arguments.
+ * \param type           The exact type of the specialization, wrapped in a call to DUNE_HASH_TYPE.
+ */
+#define DUNE_DEFINE_BYTEWISE_HASH(template_args,type)
+
 //! Wrapper macro for the template arguments in DUNE_DEFINE_HASH.
 /**
  * This macro should always be used as a wrapper for the template arguments when calling DUNE_DEFINE_HASH.
@@ -187,6 +212,55 @@ namespace Dune {
 #define DUNE_DEFINE_HASH(template_args,type)                                                  \
   DUNE_DEFINE_STD_HASH(DUNE_HASH_EXPAND_VA_ARGS template_args, DUNE_HASH_EXPAND_VA_ARGS type) \
 
+// Macro for defining a std::hash specialization which hashes the object
+// representation of type. This should not be called directly. Call
+// DUNE_DEFINE_BYTEWISE_HASH instead.
+#define DUNE_DEFINE_STD_BYTEWISE_HASH(template_args,type)                   \
+  namespace Dune {                                                          \
+                                                                            \
+    template<template_args>                                                 \
+    struct IsBytewiseHashable<type>                                         \
+      : std::true_type                                                      \
+    {                                                                       \
+      static_assert(std::is_trivially_copyable<type>::value,                \
+                    "Only trivially copyable types can be hashed bytewise"); \
+    };                                                                      \
+                                                                            \
+  }                                                                         \
+                                                                            \
+  namespace std {                                                           \
+                                                                            \
+    template<template_args>                                                 \
+    struct hash<type>                                                       \
+    {                                                                       \
+                                                                            \
+      typedef type argument_type;                                           \
+      typedef std::size_t result_type;                                      \
+                                                                            \
+      std::size_t operator()(const type& arg) const                         \
+      {                                                                     \
+        return Dune::hash_bytes(&arg,sizeof(type));                         \
+      }                                                                     \
+    };                                                                      \
+                                                                            \
+    template<template_args>                                                 \
+    struct hash<const type>                                                 \
+    {                                                                       \
+                                                                            \
+      typedef type argument_type;                                           \
+      typedef std::size_t result_type;                                      \
+                                                                            \
+      std::size_t operator()(const type& arg) const                         \
+      {                                                                     \
+        return Dune::hash_bytes(&arg,sizeof(type));                         \
+      }                                                                     \
+    };                                                                      \
+                                                                            \
+  }                                                                         \
+
+#define DUNE_DEFINE_BYTEWISE_HASH(template_args,type)                                                  \
+  DUNE_DEFINE_STD_BYTEWISE_HASH(DUNE_HASH_EXPAND_VA_ARGS template_args, DUNE_HASH_EXPAND_VA_ARGS type) \
+
 
 #endif // DOXYGEN
 
@@ -307,28 +381,236 @@ namespace Dune {
     hash_combiner<sizeof(std::size_t)>()(seed,arg);
   }
 
+  //! Whether objects of type T may be hashed by hashing their object representation.
+  /**
+   * This is the case if T is trivially copyable, contains no padding bytes and two
+   * objects compare equal exactly if their bytes are equal. It is true for integral
+   * types, enumerations and pointers. Floating point types are excluded, as 0.0 and
+   * -0.0 compare equal.
+   *
+   * User-defined types can opt in by specializing this trait, which is done
+   * automatically by DUNE_DEFINE_BYTEWISE_HASH.
+   */
+  template<typename T>
+  struct IsBytewiseHashable
+    : std::integral_constant<bool,
+                             std::is_integral<T>::value ||
+                             std::is_enum<T>::value ||
+                             std::is_pointer<T>::value>
+  {};
+
+#ifndef DOXYGEN
+
+  namespace Impl {
+
+    // Hashing of contiguous memory following the structure of wyhash
+    // (https://github.com/wangyi-fudan/wyhash, public domain): the input is
+    // consumed in blocks of 48 bytes by three independent chains, each step
+    // folding a 64x64->128 bit product of the input with a secret.
+
+    constexpr std::uint64_t hashSecret0 = 0xa0761d6478bd642fULL;
+    constexpr std::uint64_t hashSecret1 = 0xe7037ed1a0b428dbULL;
+    constexpr std::uint64_t hashSecret2 = 0x8ebc6af09c88c6e3ULL;
+    constexpr std::uint64_t hashSecret3 = 0x589965cc75374cc3ULL;
+
+    // computes the 128 bit product of a and b, stores the lower half in a and the upper one in b
+    inline void hashMultiply(std::uint64_t& a, std::uint64_t& b)
+    {
+#ifdef __SIZEOF_INT128__
+      const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+      a = static_cast<std::uint64_t>(r);
+      b = static_cast<std::uint64_t>(r >> 64);
+#else
+      const std::uint64_t ha = a >> 32, hb = b >> 32, la = std::uint32_t(a), lb = std::uint32_t(b);
+      const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+      const std::uint64_t t = rl + (rm0 << 32);
+      std::uint64_t c = t < rl;
+      const std::uint64_t lo = t + (rm1 << 32);
+      c += lo < t;
+      a = lo;
+      b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    inline std::uint64_t hashMix(std::uint64_t a, std::uint64_t b)
+    {
+      hashMultiply(a,b);
+      return a ^ b;
+    }
+
+    inline std::uint64_t hashRead8(const unsigned char* p)
+    {
+      std::uint64_t v;
+      std::memcpy(&v,p,8);
+      return v;
+    }
+
+    inline std::uint64_t hashRead4(const unsigned char* p)
+    {
+      std::uint32_t v;
+      std::memcpy(&v,p,4);
+      return v;
+    }
+
+    inline std::uint64_t hashBytes(const unsigned char* p, std::size_t len, std::uint64_t seed)
+    {
+      seed ^= hashMix(seed ^ hashSecret0, hashSecret1);
+      std::uint64_t a, b;
+      if (len <= 16)
+      {
+        if (len >= 4)
+        {
+          const std::size_t shift = (len >> 3) << 2;
+          a = (hashRead4(p) << 32) | hashRead4(p + shift);
+          b = (hashRead4(p + len - 4) << 32) | hashRead4(p + len - 4 - shift);
+        }
+        else if (len > 0)
+        {
+          a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[len >> 1]) << 8) | p[len - 1];
+          b = 0;
+        }
+        else
+          a = b = 0;
+      }
+      else
+      {
+        std::size_t i = len;
+        if (i > 48)
+        {
+          std::uint64_t see1 = seed, see2 = seed;
+          do
+          {
+            seed = hashMix(hashRead8(p) ^ hashSecret1, hashRead8(p + 8) ^ seed);
+            see1 = hashMix(hashRead8(p + 16) ^ hashSecret2, hashRead8(p + 24) ^ see1);
+            see2 = hashMix(hashRead8(p + 32) ^ hashSecret3, hashRead8(p + 40) ^ see2);
+            p += 48;
+            i -= 48;
+          }
+          while (i > 48);
+          seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+          seed = hashMix(hashRead8(p) ^ hashSecret1, hashRead8(p + 8) ^ seed);
+          i -= 16;
+          p += 16;
+        }
+        a = hashRead8(p + i - 16);
+        b = hashRead8(p + i - 8);
+      }
+      a ^= hashSecret1;
+      b ^= seed;
+      hashMultiply(a,b);
+      return hashMix(a ^ hashSecret0 ^ len, b ^ hashSecret1);
+    }
+
+    template<typename It, typename V>
+    struct IsStdContiguousIterator
+      : std::integral_constant<bool,
+                               std::is_pointer<It>::value ||
+                               std::is_same<It, typename std::vector<V>::iterator>::value ||
+                               std::is_same<It, typename std::vector<V>::const_iterator>::value ||
+                               std::is_same<It, typename std::array<V,1>::iterator>::value ||
+                               std::is_same<It, typename std::array<V,1>::const_iterator>::value>
+    {};
+
+    // Whether the values of a range are stored contiguously starting at the
+    // address of its first value. Specialized for the iterators of
+    // contiguous Dune containers next to their definition.
+    template<typename It>
+    struct IsContiguousIterator
+      : IsStdContiguousIterator<It, typename std::iterator_traits<It>::value_type>
+    {};
+
+    template<typename It, typename = void>
+    struct IsBytewiseHashableRange : std::false_type
+    {};
+
+    // Proxy references, e.g. of std::vector<bool>, do not refer to contiguous values
+    template<typename It>
+    struct IsBytewiseHashableRange<It,
+                                   std::enable_if_t<std::is_lvalue_reference<typename std::iterator_traits<It>::reference>::value> >
+      : std::integral_constant<bool,
+                               IsContiguousIterator<It>::value &&
+                               IsBytewiseHashable<typename std::iterator_traits<It>::value_type>::value>
+    {};
+
+    template<typename It>
+    inline void hashRange(std::size_t& seed, It first, It last, std::false_type)
+    {
+      for (; first != last; ++first)
+      {
+        hash_combine(seed,*first);
+      }
+    }
+
+    template<typename It>
+    inline void hashRange(std::size_t& seed, It first, It last, std::true_type)
+    {
+      if (first == last)
+        seed = hashBytes(nullptr, 0, seed);
+      else
+        seed = hashBytes(reinterpret_cast<const unsigned char*>(std::addressof(*first)),
+                         (last - first) * sizeof(*first), seed);
+    }
+
+    // Whether Dune::hash can be used for T
+    template<class T, class = void>
+    struct IsHashable : std::false_type
+    {};
+
+    template<class T>
+    struct IsHashable<T, void_t<decltype(std::declval<const Dune::hash<T>&>()(std::declval<const T&>()))> >
+      : std::is_default_constructible<Dune::hash<T> >
+    {};
+
+  } // end namespace Impl
+
+#endif // DOXYGEN
+
+  //! Calculates a hash value of len bytes of contiguous memory.
+  /**
+   * The bytes are processed in blocks of 8 bytes, which makes this much faster than
+   * combining the hashes of individual objects.
+   *
+   * \param data  Pointer to the first byte to hash.
+   * \param len   The number of bytes to hash.
+   * \param seed  Start value which is mixed into the result.
+   */
+  inline std::size_t hash_bytes(const void* data, std::size_t len, std::size_t seed = 0)
+  {
+    return static_cast<std::size_t>(
+      Impl::hashBytes(static_cast<const unsigned char*>(data), len, seed));
+  }
+
   //! Hashes all elements in the range [first,last) and returns the combined hash.
   /**
+   * If the range is stored contiguously and IsBytewiseHashable is true for its values,
+   * the whole range is hashed as contiguous memory using hash_bytes(). Otherwise, the
+   * hash values of the objects are combined one by one.
+   *
+   * \note Contiguous ranges are detected for pointers and for the iterators of
+   *       std::vector, std::array, FieldVector and DynamicVector. FieldVector of
+   *       floating point types never qualifies, see IsBytewiseHashable.
    *
    * \param first  Iterator pointing to the first object to hash.
    * \param last   Iterator pointing one past the last object to hash.
 
    * \returns      The result of hashing all objects in the range and combining them
-   *               using hash_combine() in sequential fashion, starting with seed 0.
+   *               using hash_combine() in sequential fashion, starting with seed 0,
+   *               or the result of hash_bytes() for contiguous ranges.
    */
   template<typename It>
   inline std::size_t hash_range(It first, It last)
   {
     std::size_t seed = 0;
-    for (; first != last; ++first)
-    {
-      hash_combine(seed,*first);
-    }
+    Impl::hashRange(seed,first,last,Impl::IsBytewiseHashableRange<It>());
     return seed;
   }
 
   //! Hashes all elements in the range [first,last) and combines the hashes in-place with seed.
   /**
+   * Uses the same fast path for contiguous memory as hash_range(It,It).
    *
    * \param seed   Start value that will be combined with the hash values of all objects in
    *               the range using hash_combine() in sequential fashion.
@@ -338,10 +620,7 @@ namespace Dune {
   template<typename It>
   inline void hash_range(std::size_t& seed, It first, It last)
   {
-    for (; first != last; ++first)
-    {
-      hash_combine(seed,*first);
-    }
+    Impl::hashRange(seed,first,last,Impl::IsBytewiseHashableRange<It>());
   }
 
 } // end namespace Dune
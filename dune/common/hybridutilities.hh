@@ -338,6 +338,150 @@ T accumulate(Range&& range, T value, F&& f)
 
 
 
+namespace Impl {
+
+  template<class... R>
+  class ZipRange
+  {
+  public:
+    template<class... RR>
+    constexpr ZipRange(RR&&... ranges) :
+      ranges_(std::forward<RR>(ranges)...)
+    {}
+
+    constexpr auto size() const
+    {
+      return Hybrid::size(std::get<0>(ranges_));
+    }
+
+    template<class Index>
+    constexpr auto operator[](const Index& i) const
+    {
+      return entries(i, std::index_sequence_for<R...>());
+    }
+
+    // call f with the i-th entries of all ranges as separate arguments
+    template<class F, class Index>
+    constexpr decltype(auto) apply(F&& f, const Index& i) const
+    {
+      return applyToEntries(std::forward<F>(f), i, std::index_sequence_for<R...>());
+    }
+
+  private:
+    template<class Index, std::size_t... k>
+    constexpr auto entries(const Index& i, std::index_sequence<k...>) const
+    {
+      return std::tuple<decltype(Hybrid::elementAt(std::get<k>(ranges_), i))...>(
+        Hybrid::elementAt(std::get<k>(ranges_), i)...);
+    }
+
+    template<class F, class Index, std::size_t... k>
+    constexpr decltype(auto) applyToEntries(F&& f, const Index& i, std::index_sequence<k...>) const
+    {
+      return f(Hybrid::elementAt(std::get<k>(ranges_), i)...);
+    }
+
+    std::tuple<R...> ranges_;
+  };
+
+  template<class T>
+  struct IsZipRange : public std::false_type
+  {};
+
+  template<class... R>
+  struct IsZipRange<ZipRange<R...>> : public std::true_type
+  {};
+
+  template<class Range, class Index, class F>
+  constexpr decltype(auto) transformEntry(Range&& range, const Index& i, F&& f, PriorityTag<0>)
+  {
+    return f(Hybrid::elementAt(range, i));
+  }
+
+  template<class Range, class Index, class F,
+    std::enable_if_t<IsZipRange<std::decay_t<Range>>::value, int> = 0>
+  constexpr decltype(auto) transformEntry(Range&& range, const Index& i, F&& f, PriorityTag<1>)
+  {
+    return range.apply(std::forward<F>(f), i);
+  }
+
+} // namespace Impl
+
+
+
+/**
+ * \brief Combine several ranges into a range of tuples
+ *
+ * \ingroup HybridUtilities
+ *
+ * \tparam Ranges Types of the given ranges
+ *
+ * \param ranges The ranges to combine, all of the size of the first one
+ *
+ * \returns A range whose i-th entry is a std::tuple of the i-th
+ * entries of all ranges
+ *
+ * The entries are references into the given ranges if these
+ * return references, i.e. modifying them through the tuple
+ * modifies the ranges. Ranges passed as lvalues are stored by
+ * reference, temporaries are moved into the result.
+ *
+ * The result supports Hybrid::size(), Hybrid::elementAt() and
+ * Hybrid::forEach() with the same kind of indices as the first range.
+ * This allows to traverse several heterogeneous containers in a single
+ * loop which is unrolled at compile time:
+ * \code
+ * forEach(zip(x, y), [&](auto&& xy) {
+ *   std::get<0>(xy) += a*std::get<1>(xy);
+ * });
+ * \endcode
+ */
+template<class... Ranges>
+constexpr auto zip(Ranges&&... ranges)
+{
+  return Impl::ZipRange<Ranges...>(std::forward<Ranges>(ranges)...);
+}
+
+
+
+/**
+ * \brief Transform values and accumulate the results
+ *
+ * \ingroup HybridUtilities
+ *
+ * \tparam Range Type of given range
+ * \tparam T Type of accumulated value
+ * \tparam Reduce Type of binary accumulation operator
+ * \tparam Transform Type of the transformation
+ *
+ * \param range The range of values to transform
+ * \param value Initial value for accumulation
+ * \param reduce Binary operator for accumulation
+ * \param transform Function applied to each entry
+ *
+ * This computes reduce(...reduce(value, transform(r_0))..., transform(r_n))
+ * in a single pass over the range. If range was created by zip(),
+ * transform is called with the entries of all combined ranges as
+ * separate arguments, e.g. a dot product of two heterogeneous
+ * containers can be written as
+ * \code
+ * transformReduce(zip(x, y), 0.0, std::plus<>(),
+ *   [](auto&& xi, auto&& yi) { return xi*yi; });
+ * \endcode
+ *
+ * This supports looping over the same ranges as Hybrid::forEach
+ */
+template<class Range, class T, class Reduce, class Transform>
+T transformReduce(Range&& range, T value, Reduce&& reduce, Transform&& transform)
+{
+  forEach(integralRange(Hybrid::size(range)), [&](auto&& i) {
+    value = reduce(value, Impl::transformEntry(range, i, transform, PriorityTag<1>()));
+  });
+  return value;
+}
+
+
+
 namespace Impl {
 
   template<class IfFunc, class ElseFunc>
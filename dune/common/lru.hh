@@ -3,11 +3,19 @@
 #ifndef DUNE_COMMON_LRU_HH
 #define DUNE_COMMON_LRU_HH
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <utility>
 #include <map>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/iteratorfacades.hh>
 #include <dune/common/unused.hh>
 
 /** @file
@@ -232,6 +240,398 @@ namespace Dune {
 
   };
 
+  /**
+      @brief LRU Cache Container with fixed capacity
+
+      Provides the interface of lru, but all memory is allocated upon
+      construction: the entries live in a preallocated slab and are
+      linked into an intrusive doubly-linked list in the order of
+      their use. They are found through an open-addressing hash table
+      (linear probing with backward-shift deletion) using _Hash, which
+      defaults to Dune::hash. find, insert, touch and the eviction of
+      the least recently used entry are all O(1).
+
+      Inserting a new key into a full container evicts the least
+      recently used entry. An optional callback is called with key and
+      data of every entry that is evicted this way.
+
+      _Key and _Tp have to be default constructible and assignable.
+   */
+  template <typename _Key, typename _Tp,
+      typename _Hash = Dune::hash<_Key>,
+      typename _KeyEqual = std::equal_to<_Key> >
+  class fixed_lru
+  {
+    typedef std::uint32_t index_type;
+    enum : index_type { nil = index_type(-1) };
+
+    struct node
+    {
+      std::pair<_Key, _Tp> entry;
+      std::size_t hash;
+      index_type prev;
+      index_type next;
+    };
+
+    template<class C, class V>
+    class iterator_base
+      : public BidirectionalIteratorFacade<iterator_base<C,V>, V>
+    {
+      friend class fixed_lru;
+      template<class, class> friend class iterator_base;
+    public:
+      iterator_base() : _cache(nullptr), _node(nil) {}
+
+      iterator_base(C* cache, index_type n) : _cache(cache), _node(n) {}
+
+      // allow conversion from iterator to const_iterator
+      template<class C2, class V2>
+      iterator_base(const iterator_base<C2,V2>& other)
+        : _cache(other._cache), _node(other._node) {}
+
+      template<class C2, class V2>
+      bool equals(const iterator_base<C2,V2>& other) const
+      {
+        return _node == other._node;
+      }
+
+      V& dereference() const
+      {
+        return _cache->_nodes[_node].entry;
+      }
+
+      void increment()
+      {
+        _node = _cache->_nodes[_node].next;
+      }
+
+      void decrement()
+      {
+        _node = (_node == nil) ? _cache->_tail : _cache->_nodes[_node].prev;
+      }
+
+    private:
+      C* _cache;
+      index_type _node;
+    };
+
+  public:
+    typedef _Key key_type;
+    typedef _Tp value_type;
+    typedef _Tp* pointer;
+    typedef const _Tp* const_pointer;
+    typedef const _Tp& const_reference;
+    typedef _Tp& reference;
+    typedef std::size_t size_type;
+    //! iterates over the entries from the most to the least recently used one
+    typedef iterator_base<fixed_lru, std::pair<_Key,_Tp> > iterator;
+    typedef iterator_base<const fixed_lru, const std::pair<_Key,_Tp> > const_iterator;
+    //! called with key and data of an entry evicted to make room for a new one
+    typedef std::function<void(const key_type &, reference)> eviction_callback;
+
+    /**
+     * @brief Create an empty container with room for capacity entries.
+     */
+    explicit fixed_lru (size_type capacity,
+                        eviction_callback on_evict = eviction_callback(),
+                        const _Hash & hasher = _Hash(),
+                        const _KeyEqual & equal = _KeyEqual())
+      : _nodes(capacity), _size(0), _head(nil), _tail(nil), _free(nil),
+        _on_evict(std::move(on_evict)), _hasher(hasher), _equal(equal)
+    {
+      if (capacity == 0 || capacity >= size_type(nil) / 2)
+        DUNE_THROW(Dune::RangeError, "Invalid capacity " << capacity
+                   << " for fixed_lru container");
+      // keep the load factor at most 1/2
+      size_type buckets = 1;
+      while (buckets < 2*capacity)
+        buckets *= 2;
+      _buckets.assign(buckets, nil);
+      _shift = 64;
+      for (size_type b = buckets; b > 1; b /= 2)
+        --_shift;
+      clear();
+    }
+
+    iterator begin() { return iterator(this, _head); }
+    const_iterator begin() const { return const_iterator(this, _head); }
+    iterator end() { return iterator(this, nil); }
+    const_iterator end() const { return const_iterator(this, nil); }
+
+    /**
+     *  Returns a read/write reference to the data of the most
+     *  recently used entry.
+     */
+    reference front()
+    {
+      return _nodes[_head].entry.second;
+    }
+
+    /**
+     *  Returns a read-only (constant) reference to the data of the
+     *  most recently used entry.
+     */
+    const_reference front() const
+    {
+      return _nodes[_head].entry.second;
+    }
+
+    /**
+     *  Returns a read/write reference to the data of the least
+     *  recently used entry.
+     */
+    reference back()
+    {
+      return _nodes[_tail].entry.second;
+    }
+
+    /**
+     *  Returns a read-only (constant) reference to the data of the
+     *  least recently used entry.
+     */
+    const_reference back() const
+    {
+      return _nodes[_tail].entry.second;
+    }
+
+    /**
+     * @brief Removes the first element.
+     */
+    void pop_front()
+    {
+      remove(_head);
+    }
+
+    /**
+     * @brief Removes the last element.
+     */
+    void pop_back()
+    {
+      remove(_tail);
+    }
+
+    /**
+     * @brief Finds the element whose key is k.
+     *
+     * The element is not marked as most recent.
+     *
+     * @return iterator
+     */
+    iterator find (const key_type & key)
+    {
+      return iterator(this, lookup(key, hashOf(key)));
+    }
+
+    /**
+     * @brief Finds the element whose key is k.
+     *
+     * @return const_iterator
+     */
+    const_iterator find (const key_type & key) const
+    {
+      return const_iterator(this, lookup(key, hashOf(key)));
+    }
+
+    /**
+     * @brief Insert a value into the container
+     *
+     * Stores value under key and marks it as most recent. If this key
+     * is already present, the associated data is replaced. If the
+     * container is full, the least recently used entry is evicted.
+     *
+     * @param key   associated with data
+     * @param data  to store
+     *
+     * @return reference of stored data
+     */
+    reference insert (const key_type & key, const_reference data)
+    {
+      const std::size_t h = hashOf(key);
+      index_type n = lookup(key, h);
+      if (n == nil)
+      {
+        if (_size == capacity())
+        {
+          if (_on_evict)
+            _on_evict(_nodes[_tail].entry.first, _nodes[_tail].entry.second);
+          remove(_tail);
+        }
+        n = _free;
+        _free = _nodes[n].next;
+        _nodes[n].entry.first = key;
+        _nodes[n].hash = h;
+        insertIndex(n);
+        ++_size;
+      }
+      else
+        unlink(n);
+      _nodes[n].entry.second = data;
+      pushFront(n);
+      return _nodes[n].entry.second;
+    }
+
+    /**
+     * @copydoc touch
+     */
+    reference insert (const key_type & key)
+    {
+      return touch (key);
+    }
+
+    /**
+     * @brief mark data associated with key as most recent
+     *
+     * @return reference of stored data
+     */
+    reference touch (const key_type & key)
+    {
+      const index_type n = lookup(key, hashOf(key));
+      if (n == nil)
+        DUNE_THROW(Dune::RangeError,
+          "Failed to touch key " << key << ", it is not in the lru container");
+      if (n != _head)
+      {
+        unlink(n);
+        pushFront(n);
+      }
+      return _nodes[n].entry.second;
+    }
+
+    /**
+     * @brief Retrieve number of entries in the container
+     */
+    size_type size() const
+    {
+      return _size;
+    }
+
+    /**
+     * @brief Retrieve the maximal number of entries in the container
+     */
+    size_type capacity() const
+    {
+      return _nodes.size();
+    }
+
+    /**
+     * @brief ensure a maximum size of the container
+     *
+     * If new_size is smaller than size the oldest elements are
+     * dropped. Otherwise nothing happens.
+     */
+    void resize(size_type new_size)
+    {
+      assert(new_size <= size());
+
+      while (new_size < size())
+        pop_back();
+    }
+
+    /**
+     *
+     */
+    void clear()
+    {
+      std::fill(_buckets.begin(), _buckets.end(), nil);
+      for (size_type i = 0; i < _nodes.size(); ++i)
+        _nodes[i].next = (i+1 < _nodes.size()) ? index_type(i+1) : nil;
+      _free = 0;
+      _head = _tail = nil;
+      _size = 0;
+    }
+
+  private:
+    std::size_t hashOf(const key_type & key) const
+    {
+      return _hasher(key);
+    }
+
+    // Fibonacci hashing spreads weak hashes like the identity over all buckets
+    std::size_t bucket(std::size_t h) const
+    {
+      return std::size_t((std::uint64_t(h) * 0x9e3779b97f4a7c15ull) >> _shift);
+    }
+
+    std::size_t mask() const
+    {
+      return _buckets.size() - 1;
+    }
+
+    index_type lookup(const key_type & key, std::size_t h) const
+    {
+      for (std::size_t b = bucket(h); ; b = (b+1) & mask())
+      {
+        const index_type n = _buckets[b];
+        if (n == nil)
+          return nil;
+        if (_nodes[n].hash == h && _equal(_nodes[n].entry.first, key))
+          return n;
+      }
+    }
+
+    void insertIndex(index_type n)
+    {
+      std::size_t b = bucket(_nodes[n].hash);
+      while (_buckets[b] != nil)
+        b = (b+1) & mask();
+      _buckets[b] = n;
+    }
+
+    void eraseIndex(index_type n)
+    {
+      std::size_t b = bucket(_nodes[n].hash);
+      while (_buckets[b] != n)
+        b = (b+1) & mask();
+      // shift following entries of the probe sequence back into the gap
+      for (std::size_t next = (b+1) & mask(); _buckets[next] != nil; next = (next+1) & mask())
+      {
+        const std::size_t home = bucket(_nodes[_buckets[next]].hash);
+        // move the entry unless its home lies cyclically in (b, next]
+        if (((next - home) & mask()) >= ((next - b) & mask()))
+        {
+          _buckets[b] = _buckets[next];
+          b = next;
+        }
+      }
+      _buckets[b] = nil;
+    }
+
+    void unlink(index_type n)
+    {
+      node & x = _nodes[n];
+      if (x.prev != nil) _nodes[x.prev].next = x.next; else _head = x.next;
+      if (x.next != nil) _nodes[x.next].prev = x.prev; else _tail = x.prev;
+    }
+
+    void pushFront(index_type n)
+    {
+      _nodes[n].prev = nil;
+      _nodes[n].next = _head;
+      if (_head != nil) _nodes[_head].prev = n; else _tail = n;
+      _head = n;
+    }
+
+    void remove(index_type n)
+    {
+      unlink(n);
+      eraseIndex(n);
+      _nodes[n].next = _free;
+      _free = n;
+      --_size;
+    }
+
+    std::vector<node> _nodes;
+    std::vector<index_type> _buckets;
+    unsigned int _shift;
+    size_type _size;
+    index_type _head;
+    index_type _tail;
+    index_type _free;
+    eviction_callback _on_evict;
+    _Hash _hasher;
+    _KeyEqual _equal;
+  };
+
 } // namespace Dune
 
 #endif // DUNE_COMMON_LRU_HH
@@ -5,19 +5,29 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
-#include <map>
+#include <new>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/flatmap.hh>
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/remoteindices.hh>
 #include <dune/common/stdstreams.hh>
+#include <dune/common/typetraits.hh>
 #include <dune/common/unused.hh>
 
 namespace Dune
@@ -193,6 +203,169 @@ namespace Dune
   class CommunicationError : public IOError
   {};
 
+  /**
+   * @brief How the communicators report errors of an exchange.
+   */
+  enum class CommunicationErrorMode {
+    /**
+     * @brief Throw a CommunicationError on the processes where the error occurred.
+     *
+     * This adds no synchronization to the exchange.
+     */
+    local,
+    /**
+     * @brief Throw a CommunicationError on all processes if the exchange failed on any of them.
+     *
+     * This needs an MPI_Allreduce over the whole communicator after every
+     * exchange, which turns each nearest-neighbour exchange into a global
+     * synchronization.
+     */
+    collective
+  };
+
+  /**
+   * @brief The MPI send mode the communicators use for their messages.
+   */
+  enum class CommunicationSendMode {
+    /**
+     * @brief Standard mode, the MPI library may send small messages eagerly.
+     */
+    standard,
+    /**
+     * @brief Synchronous mode, every send waits for the matching receive.
+     *
+     * This exposes programs that rely on message buffering and is meant
+     * for debugging.
+     */
+    synchronous,
+    /**
+     * @brief Ready mode with pre-posted receives.
+     *
+     * After posting its receives each process notifies the processes it
+     * receives from with an empty message, and a message is only sent
+     * once this notification has arrived. This avoids the handshake of
+     * the rendezvous protocol for messages above the eager limit of the
+     * MPI library.
+     */
+    ready
+  };
+
+  /**
+   * @brief Whether BufferedCommunicator copies the values through its buffers.
+   *
+   * Sending directly from the data and receiving directly into it saves
+   * the copies into and out of the buffers. This is only possible for a
+   * CopyGatherScatter of SizeOne data whose values are stored contiguously
+   * at the address returned by its member function data(), e.g. a
+   * std::vector. The values are transferred as their bytes, as in the
+   * buffered exchange, so both give identical results. Exchanges that do
+   * not meet the requirements always use the buffers. MPI must not
+   * receive into the values it is sending, thus an in-place exchange, e.g.
+   * forward(data), also uses the buffers if the interface sends and
+   * receives the same index, as do source and destination that partly
+   * overlap.
+   */
+  enum class CommunicationBufferMode {
+    /**
+     * @brief Send directly from the data if the interface has long enough runs of consecutive indices.
+     *
+     * MPI handles each run of consecutive indices as a block of a derived
+     * datatype. For short blocks this is slower than copying the values
+     * through the buffers.
+     */
+    automatic,
+    /**
+     * @brief Always copy the values through the buffers.
+     */
+    buffered,
+    /**
+     * @brief Always send directly from the data if possible.
+     */
+    direct
+  };
+
+  /**
+   * @brief How BufferedCommunicator exchanges the messages with the neighbours.
+   */
+  enum class CommunicationBackend {
+    /**
+     * @brief One receive and one send per neighbour.
+     */
+    pointToPoint,
+    /**
+     * @brief One neighbourhood collective on a distributed graph communicator.
+     *
+     * The graph of the neighbours is created from the interface by build(),
+     * which makes build() collective. The MPI library may use the topology
+     * to optimize the exchange. As for all collectives, every process of
+     * the communicator has to take part in every exchange, in the same
+     * order. The send mode has no effect with this backend.
+     */
+    neighborhood,
+    /**
+     * @brief Exchange the messages with processes on the same node through shared memory.
+     *
+     * The buffers are allocated in an MPI shared memory window and the
+     * values for a neighbour on the same node are gathered directly into
+     * its receive buffer. A counter per message tells the neighbour that
+     * the values have arrived, and another one that it has scattered them.
+     * Thus starting an exchange waits until the neighbours on the node have
+     * finished the previous exchange in this direction. Messages to other
+     * nodes are sent point to point. The values are never sent directly
+     * from the data. If std::atomic<std::uint64_t> is not lock free, it
+     * cannot synchronize processes and all messages are sent point to point.
+     *
+     * build(), free() and the destructor free the shared memory window,
+     * which is collective over the processes on the node. Thus they have to
+     * destroy or rebuild their communicators together.
+     */
+    sharedMemory
+  };
+
+#ifndef DOXYGEN
+  namespace Impl {
+
+    // whether the values of V are stored contiguously at v.data()
+    template<class V, class = void>
+    struct HasContiguousData : std::false_type
+    {};
+
+    template<class V>
+    struct HasContiguousData<V, void_t<decltype(std::declval<const V&>().data())> >
+      : std::is_same<typename std::decay<decltype(*std::declval<const V&>().data())>::type,
+                     typename CommPolicy<V>::IndexedType>
+    {};
+
+    template<class V>
+    bool isContiguous(const V& v, int maxIndex, std::true_type)
+    {
+      return CommPolicy<V>::getAddress(v, 0) == v.data()
+             && CommPolicy<V>::getAddress(v, maxIndex) == v.data() + maxIndex;
+    }
+
+    template<class V>
+    bool isContiguous(const V&, int, std::false_type)
+    {
+      return false;
+    }
+
+    // create a persistent send request using the given send mode
+    inline int sendInit(CommunicationSendMode mode, void* buffer, int count, MPI_Datatype type,
+                        int dest, int tag, MPI_Comm comm, MPI_Request* request)
+    {
+      switch(mode) {
+      case CommunicationSendMode::synchronous :
+        return MPI_Ssend_init(buffer, count, type, dest, tag, comm, request);
+      case CommunicationSendMode::ready :
+        return MPI_Rsend_init(buffer, count, type, dest, tag, comm, request);
+      default :
+        return MPI_Send_init(buffer, count, type, dest, tag, comm, request);
+      }
+    }
+
+  } // end namespace Impl
+#endif // DOXYGEN
+
   /**
    * @brief GatherScatter default implementation that just copies data.
    */
@@ -301,20 +474,69 @@ namespace Dune
      * @brief Deallocates the MPI requests and data types.
      */
     void free();
+
+    /**
+     * @brief Set how errors of an exchange are reported.
+     *
+     * The default is CommunicationErrorMode::local. MPI errors are only
+     * reported if the error handler of the communicator returns them,
+     * e.g. MPI_ERRORS_RETURN. Some MPI implementations free the requests
+     * that failed, thus build the communicator again after an error.
+     */
+    void setErrorMode(CommunicationErrorMode mode);
+
+    /**
+     * @brief Get how errors of an exchange are reported.
+     */
+    CommunicationErrorMode errorMode() const;
+
+    /**
+     * @brief Set the MPI send mode of the messages.
+     *
+     * The mode is used by the following calls to build(). The default is
+     * CommunicationSendMode::standard.
+     */
+    void setSendMode(CommunicationSendMode mode);
+
+    /**
+     * @brief Get the MPI send mode of the messages.
+     */
+    CommunicationSendMode sendMode() const;
   private:
     enum {
       /**
        * @brief Tag for the MPI communication.
        */
-      commTag_ = 234
+      commTag_ = 234,
+      /**
+       * @brief Tag for the notifications in ready mode.
+       */
+      readyTag_ = 235
     };
 
+    /**
+     * @brief The send mode used for the requests.
+     */
+    CommunicationSendMode sendMode_;
+
+    /**
+     * @brief The notification requests of ready mode, index 1 for forward and 0 for backward.
+     *
+     * The receives from all neighbours come first, then the sends.
+     */
+    std::vector<MPI_Request> readyRequests_[2];
+
+    /**
+     * @brief How errors are reported.
+     */
+    CommunicationErrorMode errorMode_;
+
     /**
      * @brief The indices also known at other processes.
      */
     const RemoteIndices* remoteIndices_;
 
-    typedef std::map<int,std::pair<MPI_Datatype,MPI_Datatype> >
+    typedef FlatMap<int,std::pair<MPI_Datatype,MPI_Datatype> >
     MessageTypeMap;
 
     /**
@@ -348,8 +570,10 @@ namespace Dune
 
     /**
      * @brief Initiates the sending and receive.
+     *
+     * @param index 1 for forward and 0 for backward communication.
      */
-    void sendRecv(MPI_Request* req);
+    void sendRecv(int index);
 
     /**
      * @brief Information used for setting up the MPI Datatypes.
@@ -436,7 +660,7 @@ namespace Dune
        * @brief The information about the datatypes to send to or
        * receive from each process.
        */
-      std::map<int,IndexedTypeInformation> information_;
+      FlatMap<int,IndexedTypeInformation> information_;
       /**
        * @brief A representative of the indexed data we send.
        */
@@ -454,6 +678,18 @@ namespace Dune
    * then that buffer is sent.
    * The data is received in another buffer and then copied to the actual
    * position.
+   *
+   * Besides the blocking forward() and backward() methods the
+   * communication can be split into two phases to overlap it with
+   * computations: startForward() gathers the data and posts all messages,
+   * while finishForward() waits for them and scatters the received data.
+   * In between, test() scatters the messages that have arrived so far
+   * without blocking. Only one communication may be in progress at a time
+   * and the target data has to stay alive and must not be accessed at the
+   * communicated indices until the communication has finished.
+   *
+   * For contiguous data and CopyGatherScatter the values can be sent and
+   * received directly, see CommunicationBufferMode.
    */
   class BufferedCommunicator
   {
@@ -602,11 +838,161 @@ namespace Dune
     template<class GatherScatter, class Data>
     void backward(Data& data);
 
+    /**
+     * @brief Start sending from source to target.
+     *
+     * Gathers the data into the send buffers and posts all receives and
+     * sends, but does not wait for them.
+     * The communication has to be completed by finishForward().
+     * For the requirements on GatherScatter see forward(const Data&,Data&).
+     *
+     * @param source The values will be copied from here to the send buffers.
+     * @param dest The received values will be copied to here.
+     * @throw InvalidStateException if a communication is already in progress.
+     */
+    template<class GatherScatter, class Data>
+    void startForward(const Data& source, Data& dest);
+
+    /**
+     * @brief Start communicating in the reverse direction, i.e. send from target to source.
+     *
+     * The communication has to be completed by finishBackward().
+     * For the requirements on GatherScatter see backward(Data&,const Data&).
+     *
+     * @param source The received values will be copied to here.
+     * @param dest The values will be copied from here to the send buffers.
+     * @throw InvalidStateException if a communication is already in progress.
+     */
+    template<class GatherScatter, class Data>
+    void startBackward(Data& source, const Data& dest);
+
+    /**
+     * @brief Start a forward send where target and source are the same.
+     *
+     * @param data Source and target of the communication.
+     * @throw InvalidStateException if a communication is already in progress.
+     */
+    template<class GatherScatter, class Data>
+    void startForward(Data& data);
+
+    /**
+     * @brief Start a backward send where target and source are the same.
+     *
+     * @param data Source and target of the communication.
+     * @throw InvalidStateException if a communication is already in progress.
+     */
+    template<class GatherScatter, class Data>
+    void startBackward(Data& data);
+
+    /**
+     * @brief Scatter the messages received so far without blocking.
+     *
+     * @return true if the communication started last has completed.
+     */
+    bool test();
+
+    /**
+     * @brief Wait for the communication started by startForward().
+     *
+     * All remaining messages are scattered to the target data.
+     */
+    void finishForward();
+
+    /**
+     * @brief Wait for the communication started by startBackward().
+     *
+     * All remaining messages are scattered to the source data.
+     */
+    void finishBackward();
+
     /**
      * @brief Free the allocated memory (i.e. buffers and message information.
+     *
+     * A communication that is still in progress is finished first. With
+     * CommunicationBackend::neighborhood and CommunicationBackend::sharedMemory
+     * this frees a communicator or window, thus it is collective, as are
+     * build() and the destructor.
      */
     void free();
 
+    /**
+     * @brief Set how errors of an exchange are reported.
+     *
+     * The default is CommunicationErrorMode::local. MPI errors are only
+     * reported if the error handler of the communicator returns them,
+     * e.g. MPI_ERRORS_RETURN. Some MPI implementations free the requests
+     * that failed, thus build the communicator again after an error.
+     */
+    void setErrorMode(CommunicationErrorMode mode);
+
+    /**
+     * @brief Get how errors of an exchange are reported.
+     */
+    CommunicationErrorMode errorMode() const;
+
+    /**
+     * @brief Set the MPI send mode of the messages.
+     *
+     * The mode is used by the following calls to build(). The default is
+     * CommunicationSendMode::standard.
+     */
+    void setSendMode(CommunicationSendMode mode);
+
+    /**
+     * @brief Get the MPI send mode of the messages.
+     */
+    CommunicationSendMode sendMode() const;
+
+    /**
+     * @brief Set whether the values are copied through the buffers.
+     *
+     * The mode is used by the following calls to build(). The default is
+     * CommunicationBufferMode::automatic.
+     */
+    void setBufferMode(CommunicationBufferMode mode);
+
+    /**
+     * @brief Get whether the values are copied through the buffers.
+     */
+    CommunicationBufferMode bufferMode() const;
+
+    /**
+     * @brief Set how the messages are exchanged.
+     *
+     * The backend is used by the following calls to build(). The default is
+     * CommunicationBackend::pointToPoint.
+     */
+    void setBackend(CommunicationBackend backend);
+
+    /**
+     * @brief Get how the messages are exchanged.
+     */
+    CommunicationBackend backend() const;
+
+    /**
+     * @brief Set which processes on a node share memory.
+     *
+     * With CommunicationBackend::sharedMemory only processes on the same
+     * node that pass the same non-negative color exchange their messages
+     * through shared memory, e.g. to restrict it to the processes on one
+     * socket. The color is used by the following calls to build(). The
+     * default is 0.
+     */
+    void setSharedMemoryColor(int color);
+
+    /**
+     * @brief Get which processes on a node share memory.
+     */
+    int sharedMemoryColor() const;
+
+    /**
+     * @brief Whether the last build() set up sending directly from the data.
+     *
+     * If true, exchanges with CopyGatherScatter of contiguous data bypass the
+     * buffers, see CommunicationBufferMode for the exceptions.
+     */
+    bool direct() const;
+
     /**
      * @brief Destructor.
      */
@@ -617,8 +1003,7 @@ namespace Dune
     /**
      * @brief The type of the map that maps interface information to processors.
      */
-    typedef std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
-    InterfaceMap;
+    typedef Interface::InformationMap InterfaceMap;
 
 
     /**
@@ -860,7 +1245,7 @@ namespace Dune
      * The key is the process number to communicate with and the value is
      * the pair of information about sending and receiving messages.
      */
-    typedef std::map<int,std::pair<MessageInformation,MessageInformation> >
+    typedef FlatMap<int,std::pair<MessageInformation,MessageInformation> >
     InformationMap;
     /**
      * @brief Gathered information about the messages to send.
@@ -879,79 +1264,461 @@ namespace Dune
       /**
        * @brief The tag we use for communication.
        */
-      commTag_
+      commTag_,
+      /**
+       * @brief The tag of the notifications in ready mode.
+       */
+      readyTag_,
+      /**
+       * @brief The tag for setting up the shared memory exchange.
+       */
+      sharedTag_
     };
 
+    /**
+     * @brief The average number of bytes in a block of consecutive indices
+     * above which CommunicationBufferMode::automatic sends directly from the data.
+     */
+    const static std::size_t minDirectBlockSize = 32;
+
     /**
      * @brief The interface we currently work with.
      */
-    std::map<int,std::pair<InterfaceInformation,InterfaceInformation> > interfaces_;
+    InterfaceMap interfaces_;
 
     MPI_Comm communicator_;
 
     /**
-     * @brief Send and receive Data.
+     * @brief The persistent receive requests, index 1 for forward and 0 for backward communication.
+     *
+     * The indices 3 and 2 are the requests sending directly from the data.
+     * Only messages that are not empty have a request.
      */
-    template<class GatherScatter, bool FORWARD, class Data>
-    void sendRecv(const Data& source, Data& target);
-
-  };
+    std::vector<MPI_Request> recvRequests_[4];
 
-#ifndef DOXYGEN
+    /**
+     * @brief The persistent send requests, indexed like recvRequests_.
+     */
+    std::vector<MPI_Request> sendRequests_[4];
 
-  template<class V>
-  inline const void* CommPolicy<V>::getAddress(const V& v, int index)
-  {
-    return &(v[index]);
-  }
+    /**
+     * @brief The entry of messageInformation_ each receive request belongs to.
+     */
+    std::vector<std::size_t> recvMessages_[4];
 
-  template<class V>
-  inline int CommPolicy<V>::getSize(const V& v, int index)
-  {
-    DUNE_UNUSED_PARAMETER(v);
-    DUNE_UNUSED_PARAMETER(index);
-    return 1;
-  }
+    /**
+     * @brief The entry of messageInformation_ each send request belongs to.
+     */
+    std::vector<std::size_t> sendMessages_[4];
 
-  template<class K, class A, int n>
-  inline const void* CommPolicy<VariableBlockVector<FieldVector<K, n>, A> >::getAddress(const Type& v, int index)
-  {
-    return &(v[index][0]);
-  }
+    /**
+     * @brief In ready mode the receives of the notification that the
+     * receiver of a send request is ready, in the order of the send requests.
+     */
+    std::vector<MPI_Request> readyRecvRequests_[4];
 
-  template<class K, class A, int n>
-  inline int CommPolicy<VariableBlockVector<FieldVector<K, n>, A> >::getSize(const Type& v, int index)
-  {
-    return v[index].getsize();
-  }
+    /**
+     * @brief In ready mode the sends of the notification that a receive
+     * request has been posted, in the order of the receive requests.
+     */
+    std::vector<MPI_Request> readySendRequests_[4];
 
-  template<class T>
-  inline const typename CopyGatherScatter<T>::IndexedType& CopyGatherScatter<T>::gather(const T & vec, std::size_t i)
-  {
-    return vec[i];
-  }
+    /**
+     * @brief The arguments of the neighbourhood collective replacing a set of requests.
+     *
+     * The buffered and the direct exchange both use MPI_Ineighbor_alltoallw,
+     * because all processes have to call the same collective while each
+     * one decides on its own whether to send directly from the data. Both
+     * transfer the values as bytes, thus the type signatures always match.
+     * Each exchange starts a new collective: a persistent collective would
+     * have to be created by all processes together whenever one of them
+     * changes the data it sends directly from.
+     */
+    struct CollectiveExchange
+    {
+      /** @brief The number of values of the datatype for each neighbour. */
+      std::vector<int> sendCounts, recvCounts;
+      /** @brief The displacements in bytes for each neighbour. */
+      std::vector<MPI_Aint> sendDispls, recvDispls;
+      /** @brief The datatypes for each neighbour. */
+      std::vector<MPI_Datatype> sendTypes, recvTypes;
+      /** @brief The buffer or data to send from. */
+      const char* send;
+      /** @brief The buffer or data to receive to. */
+      char* recv;
+      /** @brief The request of the running collective. */
+      MPI_Request request;
+    };
 
-  template<class T>
-  inline void CopyGatherScatter<T>::scatter(T& vec, const IndexedType& v, std::size_t i)
-  {
-    vec[i]=v;
-  }
+    /**
+     * @brief The neighbourhood collectives, indexed like recvRequests_.
+     */
+    CollectiveExchange collectives_[4];
 
-  template<typename T>
-  DatatypeCommunicator<T>::DatatypeCommunicator()
-    : remoteIndices_(0), created_(false)
-  {
-    requests_[0]=0;
-    requests_[1]=0;
-  }
+    /**
+     * @brief The graph of the neighbours for CommunicationBackend::neighborhood.
+     *
+     * MPI_COMM_NULL for the point to point backend.
+     */
+    MPI_Comm graph_;
 
+    /**
+     * @brief A counter in shared memory.
+     *
+     * Lock free atomics do not depend on the address, thus they also
+     * synchronize processes mapping the same memory. The shared memory
+     * backend is only used if they are lock free, see createBuffers().
+     */
+    typedef std::atomic<std::uint64_t> SharedCounter;
+
+    static_assert(sizeof(SharedCounter) == sizeof(std::uint64_t),
+                  "The counters in shared memory must not contain a lock");
+
+    /**
+     * @brief How a message is exchanged through shared memory, index 1 for forward and 0 for backward.
+     */
+    struct SharedMessage
+    {
+      SharedMessage()
+        : onNode(false)
+      {}
+      /** @brief Whether the neighbour is on the same node. */
+      bool onNode;
+      /** @brief Where our values go in the buffer of the neighbour. */
+      char* remote[2];
+      /**
+       * @brief The counters of the neighbour for our message: the number
+       * of messages sent and the number of messages scattered.
+       */
+      SharedCounter* remoteCounters[2];
+      /** @brief Our counters for the message of the neighbour. */
+      SharedCounter* counters[2];
+    };
+
+    /**
+     * @brief The shared memory exchange of each message, in the order of messageInformation_.
+     *
+     * Empty unless the backend is CommunicationBackend::sharedMemory.
+     */
+    std::vector<SharedMessage> shared_;
+
+    /**
+     * @brief The processes on our node for CommunicationBackend::sharedMemory.
+     */
+    MPI_Comm node_;
+
+    /**
+     * @brief The shared memory window containing the counters and the buffers.
+     */
+    MPI_Win window_;
+
+    /**
+     * @brief The number of exchanges in each direction since the last build().
+     */
+    std::uint64_t exchanges_[2];
+
+    /**
+     * @brief The number of messages in shared memory not yet scattered.
+     */
+    std::size_t pendingShared_;
+
+    /**
+     * @brief The datatypes of the values at the indices of the first and
+     * the second list of the interface, in the order of messageInformation_.
+     */
+    std::vector<std::pair<MPI_Datatype,MPI_Datatype> > directTypes_;
+
+    /**
+     * @brief The data the direct requests of each direction send from and receive to.
+     */
+    std::pair<const void*,void*> directData_[2];
+
+    /**
+     * @brief The size of the values the direct datatypes were built for.
+     */
+    std::size_t directTypeSize_;
+
+    /**
+     * @brief The largest index of the interface.
+     */
+    int maxIndex_;
+
+    /**
+     * @brief Whether no index is both sent and received, so that the
+     * direct exchange may send from and receive to the same data.
+     */
+    bool directInPlace_;
+
+    /**
+     * @brief The number of notifications not yet received in ready mode.
+     */
+    std::size_t pendingNotifications_;
+
+    /**
+     * @brief Whether the requests were created in ready mode.
+     */
+    bool readyMode_;
+
+    /**
+     * @brief The number of receives not yet completed.
+     */
+    std::size_t pendingReceives_;
+
+    /**
+     * @brief Whether a communication is in progress.
+     */
+    bool pending_;
+
+    /**
+     * @brief Whether the pending communication is a forward one.
+     */
+    bool pendingForward_;
+
+    /**
+     * @brief Whether the pending communication sends directly from the data.
+     */
+    bool pendingDirect_;
+
+    /**
+     * @brief Whether a message of the last communication failed.
+     */
+    bool failed_;
+
+    /**
+     * @brief How errors are reported.
+     */
+    CommunicationErrorMode errorMode_;
+
+    /**
+     * @brief The send mode used for the requests.
+     */
+    CommunicationSendMode sendMode_;
+
+    /**
+     * @brief Whether the values are copied through the buffers.
+     */
+    CommunicationBufferMode bufferMode_;
+
+    /**
+     * @brief How the messages are exchanged.
+     */
+    CommunicationBackend backend_;
+
+    /**
+     * @brief The color of the processes sharing memory, see setSharedMemoryColor().
+     */
+    int sharedColor_;
+
+    /**
+     * @brief The data the pending communication scatters to.
+     */
+    void* target_;
+
+    /**
+     * @brief Scatters a received message of the pending communication.
+     */
+    void (*scatter_)(const BufferedCommunicator&, void*, std::size_t);
+
+    /**
+     * @brief Scatter the received message with the given number to the target data.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    static void scatterMessage(const BufferedCommunicator& communicator, void* target, std::size_t message);
+
+    /**
+     * @brief Does nothing, the direct communication needs no scattering.
+     */
+    static void ignoreMessage(const BufferedCommunicator& communicator, void* target, std::size_t message);
+
+    /**
+     * @brief Create the persistent requests for both directions.
+     *
+     * @param typeSize The size of the values in the buffers.
+     */
+    void createRequests(std::size_t typeSize);
+
+    /**
+     * @brief Create the persistent requests of one set.
+     *
+     * @param set The index of the set, see recvRequests_.
+     * @param send The buffer or data to send from.
+     * @param recv The buffer or data to receive to.
+     * @param typeSize The size of the values in the buffers.
+     */
+    void createRequests(int set, const char* send, char* recv, std::size_t typeSize);
+
+    /**
+     * @brief Set up the neighbourhood collective of one set, see createRequests().
+     */
+    void createCollective(int set, const char* send, char* recv, std::size_t typeSize);
+
+    /**
+     * @brief Start the neighbourhood collective of one set.
+     */
+    void startCollective(int set);
+
+    /**
+     * @brief Create the graph of the neighbours for the neighbourhood collectives.
+     */
+    void createGraph();
+
+    /**
+     * @brief Allocate the buffers, bufferSize_ has to be set.
+     *
+     * @param typeSize The size of the values in the buffers.
+     */
+    void createBuffers(std::size_t typeSize);
+
+    /**
+     * @brief Allocate the buffers in shared memory and find out where
+     * to put the messages for the neighbours on our node.
+     */
+    void createSharedBuffers(std::size_t typeSize);
+
+    /**
+     * @brief Gather the values at the given indices into a buffer.
+     */
+    template<class GatherScatter, class Data>
+    static void gatherMessage(const Data& data, const InterfaceInformation& info,
+                              typename CommPolicy<Data>::IndexedType* buffer, SizeOne);
+
+    template<class GatherScatter, class Data>
+    static void gatherMessage(const Data& data, const InterfaceInformation& info,
+                              typename CommPolicy<Data>::IndexedType* buffer, VariableSize);
+
+    /**
+     * @brief Gather the messages sent point to point into our buffer.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void gatherRemote(const Data& source);
+
+    /**
+     * @brief Gather the messages for the neighbours on our node into their buffers.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void sendShared(const Data& source);
+
+    /**
+     * @brief Scatter the messages that have arrived in shared memory.
+     */
+    void receiveShared();
+
+    /**
+     * @brief Test the sends of a set to let MPI progress while polling the shared memory.
+     */
+    void testSends(int set);
+
+    /**
+     * @brief Free the persistent requests of the sets [first,last).
+     */
+    void freeRequests(int first=0, int last=4);
+
+    /**
+     * @brief Build the datatypes for sending directly from the data if
+     * the buffer mode and the interface suggest it.
+     *
+     * @param typeSize The size of the values.
+     */
+    void createDirectTypes(std::size_t typeSize);
+
+    /**
+     * @brief Build the datatype of the values at the given indices.
+     */
+    static MPI_Datatype createIndexedType(const InterfaceInformation& info, MPI_Datatype value);
+
+    /**
+     * @brief Whether to send directly from source and receive directly to target.
+     *
+     * Creates the direct requests of the direction for the data if necessary.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    bool useDirect(const Data& source, Data& target);
+
+    /**
+     * @brief Gather the data and start the receives and sends.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void startSendRecv(const Data& source, Data& target);
+
+    /**
+     * @brief Scatter received messages of the pending communication.
+     *
+     * @param wait Whether to wait until the communication has completed.
+     * @return true if the communication has completed.
+     */
+    bool progress(bool wait);
+
+    /**
+     * @brief Report the errors of the completed communication.
+     *
+     * @throw CommunicationError according to the error mode.
+     */
+    void checkErrors();
+
+    /**
+     * @brief Send and receive Data.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void sendRecv(const Data& source, Data& target);
+
+  };
+
+#ifndef DOXYGEN
+
+  template<class V>
+  inline const void* CommPolicy<V>::getAddress(const V& v, int index)
+  {
+    return &(v[index]);
+  }
+
+  template<class V>
+  inline int CommPolicy<V>::getSize(const V& v, int index)
+  {
+    DUNE_UNUSED_PARAMETER(v);
+    DUNE_UNUSED_PARAMETER(index);
+    return 1;
+  }
+
+  template<class K, class A, int n>
+  inline const void* CommPolicy<VariableBlockVector<FieldVector<K, n>, A> >::getAddress(const Type& v, int index)
+  {
+    return &(v[index][0]);
+  }
+
+  template<class K, class A, int n>
+  inline int CommPolicy<VariableBlockVector<FieldVector<K, n>, A> >::getSize(const Type& v, int index)
+  {
+    return v[index].getsize();
+  }
+
+  template<class T>
+  inline const typename CopyGatherScatter<T>::IndexedType& CopyGatherScatter<T>::gather(const T & vec, std::size_t i)
+  {
+    return vec[i];
+  }
+
+  template<class T>
+  inline void CopyGatherScatter<T>::scatter(T& vec, const IndexedType& v, std::size_t i)
+  {
+    vec[i]=v;
+  }
+
+  template<typename T>
+  DatatypeCommunicator<T>::DatatypeCommunicator()
+    : sendMode_(CommunicationSendMode::standard), errorMode_(CommunicationErrorMode::local),
+      remoteIndices_(0), created_(false)
+  {
+    requests_[0]=0;
+    requests_[1]=0;
+  }
 
 
-  template<typename T>
-  DatatypeCommunicator<T>::~DatatypeCommunicator()
-  {
-    free();
-  }
+
+  template<typename T>
+  DatatypeCommunicator<T>::~DatatypeCommunicator()
+  {
+    free();
+  }
 
   template<typename T>
   template<class T1, class T2, class V>
@@ -972,8 +1739,22 @@ namespace Dune
   void DatatypeCommunicator<T>::free()
   {
     if(created_) {
-      delete[] requests_[0];
-      delete[] requests_[1];
+      int finalized=0;
+      MPI_Finalized(&finalized);
+      for(int index=0; index<2; ++index) {
+        if(!finalized) {
+          // some MPI implementations free the requests that failed
+          for(std::size_t i=0; i<2*messageTypes.size(); ++i)
+            if(requests_[index][i] != MPI_REQUEST_NULL)
+              MPI_Request_free(requests_[index]+i);
+          for(MPI_Request& request : readyRequests_[index])
+            if(request != MPI_REQUEST_NULL)
+              MPI_Request_free(&request);
+        }
+        delete[] requests_[index];
+        requests_[index]=0;
+        readyRequests_[index].clear();
+      }
       typedef MessageTypeMap::iterator iterator;
       typedef MessageTypeMap::const_iterator const_iterator;
 
@@ -981,8 +1762,6 @@ namespace Dune
 
       for(iterator process = messageTypes.begin(); process != end; ++process) {
         MPI_Datatype *type = &(process->second.first);
-        int finalized=0;
-        MPI_Finalized(&finalized);
         if(*type!=MPI_DATATYPE_NULL && !finalized)
           MPI_Type_free(type);
         type = &(process->second.second);
@@ -1006,6 +1785,7 @@ namespace Dune
     typedef typename RemoteIndices::RemoteIndexMap::const_iterator const_iterator;
     const const_iterator end=this->remoteIndices_->end();
 
+    messageTypes.reserve(this->remoteIndices_->neighbours());
     // Allocate MPI_Datatypes and deallocate memory for the type construction.
     for(const_iterator process=this->remoteIndices_->begin(); process != end; ++process) {
       IndexedTypeInformation& info=dataInfo.information_[process->first];
@@ -1031,7 +1811,7 @@ namespace Dune
   template<class V, bool createForward>
   void DatatypeCommunicator<T>::createRequests(V& sendData, V& receiveData)
   {
-    typedef std::map<int,std::pair<MPI_Datatype,MPI_Datatype> >::const_iterator MapIterator;
+    typedef MessageTypeMap::const_iterator MapIterator;
     int rank;
     static int index = createForward ? 1 : 0;
     int noMessages = messageTypes.size();
@@ -1055,30 +1835,85 @@ namespace Dune
         ++process, ++request) {
       MPI_Datatype type = createForward ? process->second.first : process->second.second;
       void* address =  const_cast<void*>(CommPolicy<V>::getAddress(sendData, 0));
-      MPI_Ssend_init(address, 1, type, process->first, commTag_, this->remoteIndices_->communicator(), requests_[index]+request);
+      Impl::sendInit(sendMode_, address, 1, type, process->first, commTag_, this->remoteIndices_->communicator(), requests_[index]+request);
     }
+
+    // In ready mode every neighbour notifies us when it may receive
+    if(sendMode_ == CommunicationSendMode::ready) {
+      readyRequests_[index].resize(2*noMessages);
+      request = 0;
+      for(MapIterator process = messageTypes.begin(); process != end; ++process, ++request)
+        MPI_Recv_init(0, 0, MPI_BYTE, process->first, readyTag_, this->remoteIndices_->communicator(),
+                      &readyRequests_[index][request]);
+      for(MapIterator process = messageTypes.begin(); process != end; ++process, ++request)
+        MPI_Send_init(0, 0, MPI_BYTE, process->first, readyTag_, this->remoteIndices_->communicator(),
+                      &readyRequests_[index][request]);
+    }
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::setErrorMode(CommunicationErrorMode mode)
+  {
+    errorMode_ = mode;
+  }
+
+  template<typename T>
+  CommunicationErrorMode DatatypeCommunicator<T>::errorMode() const
+  {
+    return errorMode_;
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::setSendMode(CommunicationSendMode mode)
+  {
+    sendMode_ = mode;
+  }
+
+  template<typename T>
+  CommunicationSendMode DatatypeCommunicator<T>::sendMode() const
+  {
+    return sendMode_;
   }
 
   template<typename T>
   void DatatypeCommunicator<T>::forward()
   {
-    sendRecv(requests_[1]);
+    sendRecv(1);
   }
 
   template<typename T>
   void DatatypeCommunicator<T>::backward()
   {
-    sendRecv(requests_[0]);
+    sendRecv(0);
   }
 
   template<typename T>
-  void DatatypeCommunicator<T>::sendRecv(MPI_Request* requests)
+  void DatatypeCommunicator<T>::sendRecv(int index)
   {
+    MPI_Request* requests = requests_[index];
     int noMessages = messageTypes.size();
+    int success=1, globalSuccess=0;
     // Start the receive calls first
     MPI_Startall(noMessages, requests);
     // Now the send calls
-    MPI_Startall(noMessages, requests+noMessages);
+    if(readyRequests_[index].empty())
+      MPI_Startall(noMessages, requests+noMessages);
+    else{
+      // Notify the neighbours and send to each one as soon as it is ready
+      MPI_Request* ready = readyRequests_[index].data();
+      MPI_Startall(2*noMessages, ready);
+      for(int i=0; i<noMessages; i++) {
+        int finished = MPI_UNDEFINED;
+        if(MPI_SUCCESS!=MPI_Waitany(noMessages, ready, &finished, MPI_STATUS_IGNORE)
+           || finished==MPI_UNDEFINED) {
+          success=0;
+          break;
+        }
+        MPI_Start(requests+noMessages+finished);
+      }
+      if(MPI_SUCCESS!=MPI_Waitall(noMessages, ready+noMessages, MPI_STATUSES_IGNORE))
+        success=0;
+    }
 
     // Wait for completion of the communication send first then receive
     MPI_Status* status=new MPI_Status[2*noMessages];
@@ -1089,7 +1924,6 @@ namespace Dune
     int receive = MPI_Waitall(noMessages, requests, status);
 
     // Error checks
-    int success=1, globalSuccess=0;
     if(send==MPI_ERR_IN_STATUS) {
       int rank;
       MPI_Comm_rank(this->remoteIndices_->communicator(), &rank);
@@ -1102,7 +1936,7 @@ namespace Dune
           MPI_Error_string(status[i].MPI_ERROR, message, &messageLength);
           std::cerr<<" source="<<status[i].MPI_SOURCE<<" message: ";
           for(int j = 0; j < messageLength; j++)
-            std::cout << message[j];
+            std::cerr << message[j];
         }
       std::cerr<<std::endl;
       success=0;
@@ -1126,7 +1960,10 @@ namespace Dune
       success=0;
     }
 
-    MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, this->remoteIndices_->communicator());
+    if(errorMode_ == CommunicationErrorMode::collective)
+      MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, this->remoteIndices_->communicator());
+    else
+      globalSuccess = success;
 
     delete[] status;
 
@@ -1136,21 +1973,37 @@ namespace Dune
   }
 
   inline BufferedCommunicator::BufferedCommunicator()
+    : directTypeSize_(0), maxIndex_(0), directInPlace_(false),
+      pendingNotifications_(0), readyMode_(false), pendingReceives_(0),
+      pending_(false), pendingForward_(false), pendingDirect_(false),
+      failed_(false), errorMode_(CommunicationErrorMode::local),
+      sendMode_(CommunicationSendMode::standard),
+      bufferMode_(CommunicationBufferMode::automatic),
+      backend_(CommunicationBackend::pointToPoint), sharedColor_(0),
+      target_(0), scatter_(0)
   {
     buffers_[0]=0;
     buffers_[1]=0;
     bufferSize_[0]=0;
     bufferSize_[1]=0;
+    directData_[0]=directData_[1]=std::pair<const void*,void*>(0, 0);
+    for(CollectiveExchange& collective : collectives_)
+      collective.request = MPI_REQUEST_NULL;
+    graph_ = MPI_COMM_NULL;
+    node_ = MPI_COMM_NULL;
+    window_ = MPI_WIN_NULL;
+    exchanges_[0]=exchanges_[1]=0;
+    pendingShared_=0;
   }
 
   template<class Data, class Interface>
   typename std::enable_if<std::is_same<SizeOne, typename CommPolicy<Data>::IndexedTypeFlag>::value, void>::type
   BufferedCommunicator::build(const Interface& interface)
   {
+    free();
     interfaces_=interface.interfaces();
     communicator_=interface.communicator();
-    typedef typename std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
-    ::const_iterator const_iterator;
+    typedef InterfaceMap::const_iterator const_iterator;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
     const const_iterator end = interfaces_.end();
     int lrank;
@@ -1158,6 +2011,7 @@ namespace Dune
 
     bufferSize_[0]=0;
     bufferSize_[1]=0;
+    messageInformation_.reserve(interfaces_.size());
 
     for(const_iterator interfacePair = interfaces_.begin();
         interfacePair != end; ++interfacePair) {
@@ -1177,23 +2031,26 @@ namespace Dune
     bufferSize_[0] *= sizeof(typename CommPolicy<Data>::IndexedType);
     bufferSize_[1] *= sizeof(typename CommPolicy<Data>::IndexedType);
 
-    buffers_[0] = new char[bufferSize_[0]];
-    buffers_[1] = new char[bufferSize_[1]];
+    createBuffers(sizeof(typename CommPolicy<Data>::IndexedType));
+
+    createRequests(sizeof(typename CommPolicy<Data>::IndexedType));
+    if(Impl::HasContiguousData<Data>::value)
+      createDirectTypes(sizeof(typename CommPolicy<Data>::IndexedType));
   }
 
   template<class Data, class Interface>
   void BufferedCommunicator::build(const Data& source, const Data& dest, const Interface& interface)
   {
-
+    free();
     interfaces_=interface.interfaces();
     communicator_=interface.communicator();
-    typedef typename std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
-    ::const_iterator const_iterator;
+    typedef InterfaceMap::const_iterator const_iterator;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
     const const_iterator end = interfaces_.end();
 
     bufferSize_[0]=0;
     bufferSize_[1]=0;
+    messageInformation_.reserve(interfaces_.size());
 
     for(const_iterator interfacePair = interfaces_.begin();
         interfacePair != end; ++interfacePair) {
@@ -1212,18 +2069,51 @@ namespace Dune
     bufferSize_[0] *= sizeof(typename CommPolicy<Data>::IndexedType);
     bufferSize_[1] *= sizeof(typename CommPolicy<Data>::IndexedType);
     // allocate the buffers
-    buffers_[0] = new char[bufferSize_[0]];
-    buffers_[1] = new char[bufferSize_[1]];
+    createBuffers(sizeof(typename CommPolicy<Data>::IndexedType));
+
+    createRequests(sizeof(typename CommPolicy<Data>::IndexedType));
+    if(Impl::HasContiguousData<Data>::value)
+      createDirectTypes(sizeof(typename CommPolicy<Data>::IndexedType));
   }
 
   inline void BufferedCommunicator::free()
   {
+    // MPI may still access the buffers
+    if(pending_)
+      progress(true);
+    freeRequests();
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    for(auto& types : directTypes_)
+      if(!finalized) {
+        if(types.first!=MPI_DATATYPE_NULL)
+          MPI_Type_free(&types.first);
+        if(types.second!=MPI_DATATYPE_NULL)
+          MPI_Type_free(&types.second);
+      }
+    directTypes_.clear();
+    directTypeSize_=0;
+    if(graph_ != MPI_COMM_NULL && !finalized)
+      MPI_Comm_free(&graph_);
+    graph_ = MPI_COMM_NULL;
     messageInformation_.clear();
-    if(buffers_[0])
-      delete[] buffers_[0];
+    if(window_ != MPI_WIN_NULL) {
+      // The buffers belong to the window
+      if(!finalized) {
+        MPI_Win_unlock_all(window_);
+        MPI_Win_free(&window_);
+        MPI_Comm_free(&node_);
+      }
+      window_ = MPI_WIN_NULL;
+      node_ = MPI_COMM_NULL;
+      shared_.clear();
+    }else{
+      if(buffers_[0])
+        delete[] buffers_[0];
 
-    if(buffers_[1])
-      delete[] buffers_[1];
+      if(buffers_[1])
+        delete[] buffers_[1];
+    }
     buffers_[0]=buffers_[1]=0;
   }
 
@@ -1232,6 +2122,329 @@ namespace Dune
     free();
   }
 
+  inline void BufferedCommunicator::createRequests(std::size_t typeSize)
+  {
+    if(backend_ == CommunicationBackend::neighborhood)
+      createGraph();
+    readyMode_ = sendMode_ == CommunicationSendMode::ready && graph_ == MPI_COMM_NULL;
+    createRequests(0, buffers_[1], buffers_[0], typeSize);
+    createRequests(1, buffers_[0], buffers_[1], typeSize);
+  }
+
+  inline void BufferedCommunicator::createBuffers(std::size_t typeSize)
+  {
+    // Atomics using a lock do not synchronize between processes
+    const SharedCounter counter(0);
+    if(backend_ == CommunicationBackend::sharedMemory && counter.is_lock_free())
+      createSharedBuffers(typeSize);
+    else{
+      buffers_[0] = new char[bufferSize_[0]];
+      buffers_[1] = new char[bufferSize_[1]];
+    }
+  }
+
+  inline void BufferedCommunicator::createSharedBuffers(std::size_t typeSize)
+  {
+    typedef InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+    const std::size_t noMessages = messageInformation_.size();
+
+    // Find the neighbours on our node with the same color
+    MPI_Comm node;
+    MPI_Comm_split_type(communicator_, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+    MPI_Comm_split(node, sharedColor_, 0, &node_);
+    MPI_Comm_free(&node);
+    std::vector<int> ranks, nodeRanks(noMessages);
+    ranks.reserve(noMessages);
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info)
+      ranks.push_back(info->first);
+    MPI_Group group, nodeGroup;
+    MPI_Comm_group(communicator_, &group);
+    MPI_Comm_group(node_, &nodeGroup);
+    MPI_Group_translate_ranks(group, noMessages, ranks.data(), nodeGroup, nodeRanks.data());
+    MPI_Group_free(&group);
+    MPI_Group_free(&nodeGroup);
+
+    // The window starts with two counters per message and direction, followed by the buffers
+    const std::size_t alignment = alignof(std::max_align_t);
+    const std::size_t counterSize = (4*noMessages*sizeof(SharedCounter)+alignment-1)/alignment*alignment;
+    char* base;
+    MPI_Win_allocate_shared(counterSize+bufferSize_[0]+bufferSize_[1], 1, MPI_INFO_NULL, node_, &base, &window_);
+    SharedCounter* counters = reinterpret_cast<SharedCounter*>(base);
+    for(std::size_t i=0; i < 4*noMessages; ++i)
+      new (counters+i) SharedCounter(0);
+    // The window stays locked for the direct accesses until it is freed
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+    MPI_Win_sync(window_);
+    buffers_[0] = base+counterSize;
+    buffers_[1] = buffers_[0]+bufferSize_[0];
+    exchanges_[0] = exchanges_[1] = 0;
+
+    // Tell the neighbours on our node the number of their message and
+    // where its values go in our window for each direction
+    typedef std::array<unsigned long long,3> Location;
+    std::vector<Location> ours(noMessages), theirs(noMessages);
+    std::vector<MPI_Request> requests;
+    requests.reserve(2*noMessages);
+    std::size_t i=0;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i)
+      if(nodeRanks[i] != MPI_UNDEFINED) {
+        ours[i] = {{ i, counterSize+info->second.first.start_*typeSize,
+                     counterSize+bufferSize_[0]+info->second.second.start_*typeSize }};
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(theirs[i].data(), 3, MPI_UNSIGNED_LONG_LONG, info->first, sharedTag_, communicator_, &requests.back());
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(ours[i].data(), 3, MPI_UNSIGNED_LONG_LONG, info->first, sharedTag_, communicator_, &requests.back());
+      }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    shared_.resize(noMessages);
+    for(i=0; i < noMessages; ++i)
+      if(nodeRanks[i] != MPI_UNDEFINED) {
+        MPI_Aint size;
+        int unit;
+        char* remoteBase;
+        MPI_Win_shared_query(window_, nodeRanks[i], &size, &unit, &remoteBase);
+        SharedMessage& message = shared_[i];
+        message.onNode = true;
+        for(int direction=0; direction < 2; ++direction) {
+          message.remote[direction] = remoteBase + theirs[i][direction+1];
+          message.remoteCounters[direction] = reinterpret_cast<SharedCounter*>(remoteBase) + 4*theirs[i][0] + 2*direction;
+          message.counters[direction] = counters + 4*i + 2*direction;
+        }
+      }
+  }
+
+  inline void BufferedCommunicator::createGraph()
+  {
+    // The interface is symmetric, we send to and receive from the same processes
+    std::vector<int> neighbours;
+    neighbours.reserve(messageInformation_.size());
+    for(const auto& info : messageInformation_)
+      neighbours.push_back(info.first);
+    MPI_Dist_graph_create_adjacent(communicator_, neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+                                   neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &graph_);
+  }
+
+  inline void BufferedCommunicator::createCollective(int set, const char* send, char* recv, std::size_t typeSize)
+  {
+    typedef InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+    const int forward = set%2;
+    const bool direct = set > 1;
+    CollectiveExchange& collective = collectives_[set];
+    collective.send = send;
+    collective.recv = recv;
+
+    std::size_t i=0;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
+      const MessageInformation& recvInfo = forward ? info->second.second : info->second.first;
+      const MessageInformation& sendInfo = forward ? info->second.first : info->second.second;
+      if(direct) {
+        // Send one value of the datatype from the start of the data
+        collective.sendCounts.push_back(sendInfo.size_ ? 1 : 0);
+        collective.recvCounts.push_back(recvInfo.size_ ? 1 : 0);
+        collective.sendDispls.push_back(0);
+        collective.recvDispls.push_back(0);
+        collective.sendTypes.push_back(sendInfo.size_ ? (forward ? directTypes_[i].first : directTypes_[i].second) : MPI_BYTE);
+        collective.recvTypes.push_back(recvInfo.size_ ? (forward ? directTypes_[i].second : directTypes_[i].first) : MPI_BYTE);
+      }else{
+        collective.sendCounts.push_back(sendInfo.size_);
+        collective.recvCounts.push_back(recvInfo.size_);
+        collective.sendDispls.push_back(sendInfo.start_*typeSize);
+        collective.recvDispls.push_back(recvInfo.start_*typeSize);
+        collective.sendTypes.push_back(MPI_BYTE);
+        collective.recvTypes.push_back(MPI_BYTE);
+      }
+    }
+  }
+
+  inline void BufferedCommunicator::startCollective(int set)
+  {
+    CollectiveExchange& collective = collectives_[set];
+    MPI_Ineighbor_alltoallw(collective.send, collective.sendCounts.data(), collective.sendDispls.data(),
+                            collective.sendTypes.data(), collective.recv, collective.recvCounts.data(),
+                            collective.recvDispls.data(), collective.recvTypes.data(),
+                            graph_, &collective.request);
+  }
+
+  inline void BufferedCommunicator::createRequests(int set, const char* send, char* recv, std::size_t typeSize)
+  {
+    if(graph_ != MPI_COMM_NULL) {
+      createCollective(set, send, recv, typeSize);
+      return;
+    }
+
+    typedef InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+    const int forward = set%2;
+    const bool direct = set > 1;
+
+    recvRequests_[set].reserve(messageInformation_.size());
+    sendRequests_[set].reserve(messageInformation_.size());
+    recvMessages_[set].reserve(messageInformation_.size());
+    sendMessages_[set].reserve(messageInformation_.size());
+
+    std::size_t i=0;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
+      // Messages to our node go through shared memory
+      if(!shared_.empty() && shared_[i].onNode)
+        continue;
+      const MessageInformation& recvInfo = forward ? info->second.second : info->second.first;
+      const MessageInformation& sendInfo = forward ? info->second.first : info->second.second;
+      assert(direct || recvInfo.start_*typeSize+recvInfo.size_ <= bufferSize_[forward ? 1 : 0]);
+      assert(direct || sendInfo.start_*typeSize+sendInfo.size_ <= bufferSize_[forward ? 0 : 1]);
+
+      // Empty messages get no request
+      if(recvInfo.size_) {
+        recvRequests_[set].push_back(MPI_REQUEST_NULL);
+        if(direct)
+          MPI_Recv_init(recv, 1, forward ? directTypes_[i].second : directTypes_[i].first,
+                        info->first, commTag_, communicator_, &recvRequests_[set].back());
+        else
+          MPI_Recv_init(recv+recvInfo.start_*typeSize, recvInfo.size_,
+                        MPI_BYTE, info->first, commTag_, communicator_,
+                        &recvRequests_[set].back());
+        recvMessages_[set].push_back(i);
+      }
+      if(sendInfo.size_) {
+        sendRequests_[set].push_back(MPI_REQUEST_NULL);
+        if(direct)
+          Impl::sendInit(sendMode_, const_cast<char*>(send), 1,
+                         forward ? directTypes_[i].first : directTypes_[i].second,
+                         info->first, commTag_, communicator_, &sendRequests_[set].back());
+        else
+          Impl::sendInit(sendMode_, const_cast<char*>(send+sendInfo.start_*typeSize), sendInfo.size_,
+                         MPI_BYTE, info->first, commTag_, communicator_,
+                         &sendRequests_[set].back());
+        sendMessages_[set].push_back(i);
+      }
+    }
+
+    if(readyMode_) {
+      readyRecvRequests_[set].resize(sendRequests_[set].size());
+      for(std::size_t j=0; j<sendMessages_[set].size(); ++j)
+        MPI_Recv_init(0, 0, MPI_BYTE, (messageInformation_.begin()+sendMessages_[set][j])->first,
+                      readyTag_, communicator_, &readyRecvRequests_[set][j]);
+      readySendRequests_[set].resize(recvRequests_[set].size());
+      for(std::size_t j=0; j<recvMessages_[set].size(); ++j)
+        MPI_Send_init(0, 0, MPI_BYTE, (messageInformation_.begin()+recvMessages_[set][j])->first,
+                      readyTag_, communicator_, &readySendRequests_[set][j]);
+    }
+  }
+
+  inline void BufferedCommunicator::freeRequests(int first, int last)
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    for(int set=first; set < last; ++set) {
+      if(!finalized) {
+        // some MPI implementations free the requests that failed
+        for(auto requests : { &recvRequests_[set], &sendRequests_[set],
+                              &readyRecvRequests_[set], &readySendRequests_[set] })
+          for(MPI_Request& request : *requests)
+            if(request != MPI_REQUEST_NULL)
+              MPI_Request_free(&request);
+      }
+      recvRequests_[set].clear();
+      sendRequests_[set].clear();
+      readyRecvRequests_[set].clear();
+      readySendRequests_[set].clear();
+      recvMessages_[set].clear();
+      sendMessages_[set].clear();
+      CollectiveExchange& collective = collectives_[set];
+      if(collective.request != MPI_REQUEST_NULL && !finalized)
+        MPI_Request_free(&collective.request);
+      collective.request = MPI_REQUEST_NULL;
+      collective.sendCounts.clear();
+      collective.recvCounts.clear();
+      collective.sendDispls.clear();
+      collective.recvDispls.clear();
+      collective.sendTypes.clear();
+      collective.recvTypes.clear();
+      if(set > 1)
+        directData_[set-2] = std::pair<const void*,void*>(0, 0);
+    }
+  }
+
+  inline MPI_Datatype BufferedCommunicator::createIndexedType(const InterfaceInformation& info, MPI_Datatype value)
+  {
+    // Consecutive indices form one block
+    std::vector<int> lengths, displacements;
+    for(std::size_t i=0; i < info.size(); ++i) {
+      const int index = info[i];
+      if(!displacements.empty() && index == displacements.back()+lengths.back())
+        ++lengths.back();
+      else{
+        displacements.push_back(index);
+        lengths.push_back(1);
+      }
+    }
+
+    MPI_Datatype type;
+    if(lengths.size() == info.size())
+      MPI_Type_create_indexed_block(displacements.size(), 1, displacements.data(), value, &type);
+    else
+      MPI_Type_indexed(displacements.size(), lengths.data(), displacements.data(), value, &type);
+    MPI_Type_commit(&type);
+    return type;
+  }
+
+  inline void BufferedCommunicator::createDirectTypes(std::size_t typeSize)
+  {
+    if(bufferMode_ == CommunicationBufferMode::buffered || backend_ == CommunicationBackend::sharedMemory)
+      return;
+
+    typedef InformationMap::const_iterator const_iterator;
+    const const_iterator end = messageInformation_.end();
+
+    // The number of values and of blocks of consecutive indices
+    std::size_t values = 0, blocks = 0;
+    maxIndex_ = 0;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const InterfaceMap::value_type::second_type& lists = interfaces_.find(info->first)->second;
+      for(const InterfaceInformation* list : { &lists.first, &lists.second })
+        for(std::size_t i=0; i < list->size(); ++i) {
+          if(i == 0 || (*list)[i] != (*list)[i-1]+1)
+            ++blocks;
+          maxIndex_ = std::max(maxIndex_, int((*list)[i]));
+        }
+      values += lists.first.size() + lists.second.size();
+    }
+
+    // The datatype engine of MPI handles each block separately. Copying
+    // through the buffers is faster unless the blocks are long enough.
+    if(bufferMode_ == CommunicationBufferMode::automatic
+       && values*typeSize < minDirectBlockSize*blocks)
+      return;
+
+    // An in-place exchange must not receive values that are still to be sent
+    std::vector<bool> sent(maxIndex_+1, false);
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const InterfaceInformation& list = interfaces_.find(info->first)->second.first;
+      for(std::size_t i=0; i < list.size(); ++i)
+        sent[list[i]] = true;
+    }
+    directInPlace_ = true;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const InterfaceInformation& list = interfaces_.find(info->first)->second.second;
+      for(std::size_t i=0; i < list.size(); ++i)
+        directInPlace_ = directInPlace_ && !sent[list[i]];
+    }
+
+    MPI_Datatype value;
+    MPI_Type_contiguous(typeSize, MPI_BYTE, &value);
+    directTypes_.reserve(messageInformation_.size());
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info) {
+      const InterfaceMap::value_type::second_type& lists = interfaces_.find(info->first)->second;
+      directTypes_.push_back(std::make_pair(lists.first.size() ? createIndexedType(lists.first, value) : MPI_DATATYPE_NULL,
+                                            lists.second.size() ? createIndexedType(lists.second, value) : MPI_DATATYPE_NULL));
+    }
+    MPI_Type_free(&value);
+    directTypeSize_ = typeSize;
+  }
+
   template<class Data>
   inline int BufferedCommunicator::MessageSizeCalculator<Data,SizeOne>::operator()
     (const InterfaceInformation& info) const
@@ -1389,153 +2602,508 @@ namespace Dune
   }
 
 
-  template<class GatherScatter, bool FORWARD, class Data>
-  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::startForward(const Data& source, Data& dest)
   {
-    int rank, lrank;
+    this->template startSendRecv<GatherScatter,true>(source, dest);
+  }
 
-    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
-    MPI_Comm_rank(MPI_COMM_WORLD,&lrank);
 
-    typedef typename CommPolicy<Data>::IndexedType Type;
-    Type *sendBuffer, *recvBuffer;
-    size_t sendBufferSize;
-#ifndef NDEBUG
-    size_t recvBufferSize;
-#endif
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::startBackward(Data& source, const Data& dest)
+  {
+    this->template startSendRecv<GatherScatter,false>(dest, source);
+  }
 
-    if(FORWARD) {
-      sendBuffer = reinterpret_cast<Type*>(buffers_[0]);
-      sendBufferSize = bufferSize_[0];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[1]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[1];
-#endif
-    }else{
-      sendBuffer = reinterpret_cast<Type*>(buffers_[1]);
-      sendBufferSize = bufferSize_[1];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[0]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[0];
-#endif
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::startForward(Data& data)
+  {
+    this->template startSendRecv<GatherScatter,true>(data, data);
+  }
+
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::startBackward(Data& data)
+  {
+    this->template startSendRecv<GatherScatter,false>(data, data);
+  }
+
+
+  inline bool BufferedCommunicator::test()
+  {
+    if(!pending_)
+      return true;
+    if(!progress(false))
+      return false;
+    checkErrors();
+    return true;
+  }
+
+
+  inline void BufferedCommunicator::finishForward()
+  {
+    assert(!pending_ || pendingForward_);
+    if(pending_) {
+      progress(true);
+      checkErrors();
+    }
+  }
+
+
+  inline void BufferedCommunicator::finishBackward()
+  {
+    assert(!pending_ || !pendingForward_);
+    if(pending_) {
+      progress(true);
+      checkErrors();
     }
+  }
+
+
+  inline void BufferedCommunicator::setErrorMode(CommunicationErrorMode mode)
+  {
+    errorMode_ = mode;
+  }
+
+
+  inline CommunicationErrorMode BufferedCommunicator::errorMode() const
+  {
+    return errorMode_;
+  }
+
+
+  inline void BufferedCommunicator::setSendMode(CommunicationSendMode mode)
+  {
+    sendMode_ = mode;
+  }
+
+
+  inline CommunicationSendMode BufferedCommunicator::sendMode() const
+  {
+    return sendMode_;
+  }
+
+
+  inline void BufferedCommunicator::setBufferMode(CommunicationBufferMode mode)
+  {
+    bufferMode_ = mode;
+  }
+
+
+  inline CommunicationBufferMode BufferedCommunicator::bufferMode() const
+  {
+    return bufferMode_;
+  }
+
+
+  inline void BufferedCommunicator::setBackend(CommunicationBackend backend)
+  {
+    backend_ = backend;
+  }
+
+
+  inline CommunicationBackend BufferedCommunicator::backend() const
+  {
+    return backend_;
+  }
+
+
+  inline void BufferedCommunicator::setSharedMemoryColor(int color)
+  {
+    assert(color >= 0);
+    sharedColor_ = color;
+  }
+
+
+  inline int BufferedCommunicator::sharedMemoryColor() const
+  {
+    return sharedColor_;
+  }
+
+
+  inline bool BufferedCommunicator::direct() const
+  {
+    return directTypeSize_ > 0;
+  }
+
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::scatterMessage(const BufferedCommunicator& communicator, void* target, std::size_t message)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
 
-    MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, sendBuffer, sendBufferSize);
+    // the requests are in the order of the entries
+    typename InformationMap::const_iterator infoIter = communicator.messageInformation_.begin() + message;
+    const MessageInformation& info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
+    Type* recvBuffer = reinterpret_cast<Type*>(communicator.buffers_[FORWARD ? 1 : 0]);
+    assert(info.start_*sizeof(Type)+info.size_ <= communicator.bufferSize_[FORWARD ? 1 : 0]);
 
-    MPI_Request* sendRequests = new MPI_Request[messageInformation_.size()];
-    MPI_Request* recvRequests = new MPI_Request[messageInformation_.size()];
-    /* Number of recvRequests that are not MPI_REQUEST_NULL */
-    size_t numberOfRealRecvRequests = 0;
+    MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (communicator.interfaces_, *static_cast<Data*>(target),
+                                                         recvBuffer+info.start_, infoIter->first);
+  }
 
-    // Setup receive first
-    typedef typename InformationMap::const_iterator const_iterator;
 
-    const const_iterator end = messageInformation_.end();
-    size_t i=0;
-    int* processMap = new int[messageInformation_.size()];
+  inline void BufferedCommunicator::ignoreMessage(const BufferedCommunicator&, void*, std::size_t)
+  {}
 
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
-      processMap[i]=info->first;
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.second.size_<<" from "<<info->first<<std::endl;
-        if(info->second.second.size_) {
-          MPI_Irecv(recvBuffer+info->second.second.start_, info->second.second.size_,
-                    MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
-        }
-      }else{
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        if(info->second.first.size_) {
-          MPI_Irecv(recvBuffer+info->second.first.start_, info->second.first.size_,
-                    MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::gatherMessage(const Data& data, const InterfaceInformation& info,
+                                           typename CommPolicy<Data>::IndexedType* buffer, SizeOne)
+  {
+    for(std::size_t i=0; i < info.size(); ++i)
+      buffer[i] = GatherScatter::gather(data, info[i]);
+  }
+
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::gatherMessage(const Data& data, const InterfaceInformation& info,
+                                           typename CommPolicy<Data>::IndexedType* buffer, VariableSize)
+  {
+    for(std::size_t i=0, index=0; i < info.size(); ++i)
+      for(std::size_t j=0; j < CommPolicy<Data>::getSize(data, info[i]); ++j)
+        buffer[index++] = GatherScatter::gather(data, info[i], j);
+  }
+
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::gatherRemote(const Data& source)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    Type* buffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 0 : 1]);
+
+    std::size_t i=0;
+    for(auto info = messageInformation_.begin(); info != messageInformation_.end(); ++info, ++i)
+      if(!shared_[i].onNode) {
+        const InterfaceMap::value_type::second_type& lists = interfaces_.find(info->first)->second;
+        const MessageInformation& sendInfo = FORWARD ? info->second.first : info->second.second;
+        gatherMessage<GatherScatter>(source, FORWARD ? lists.first : lists.second, buffer+sendInfo.start_, Flag());
+      }
+  }
+
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::sendShared(const Data& source)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    const int direction = FORWARD ? 1 : 0;
+    const std::uint64_t exchange = ++exchanges_[direction];
+
+    pendingShared_ = 0;
+    std::size_t i=0;
+    for(auto info = messageInformation_.begin(); info != messageInformation_.end(); ++info, ++i) {
+      SharedMessage& message = shared_[i];
+      if(!message.onNode)
+        continue;
+      if((FORWARD ? info->second.second : info->second.first).size_)
+        ++pendingShared_;
+      if((FORWARD ? info->second.first : info->second.second).size_) {
+        // The neighbour has to have scattered our previous message
+        SharedCounter* counters = message.remoteCounters[direction];
+        while(counters[1].load(std::memory_order_acquire) != exchange-1) {
+          testSends(direction);
+          std::this_thread::yield();
         }
+        MPI_Win_sync(window_);
+        const InterfaceMap::value_type::second_type& lists = interfaces_.find(info->first)->second;
+        gatherMessage<GatherScatter>(source, FORWARD ? lists.first : lists.second,
+                                     reinterpret_cast<Type*>(message.remote[direction]), Flag());
+        MPI_Win_sync(window_);
+        counters[0].store(exchange, std::memory_order_release);
       }
     }
+  }
 
-    // now the send requests
-    i=0;
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i)
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= sendBufferSize );
-        if(info->second.first.size_)
-          MPI_Issend(sendBuffer+info->second.first.start_, info->second.first.size_,
-                     MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
-        else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
-      }else{
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= sendBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.second.size_<<" to "<<info->first<<std::endl;
-        if(info->second.second.size_)
-          MPI_Issend(sendBuffer+info->second.second.start_, info->second.second.size_,
-                     MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
-        else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
+
+  inline void BufferedCommunicator::receiveShared()
+  {
+    if(pendingShared_ == 0)
+      return;
+    const int direction = pendingForward_ ? 1 : 0;
+    const std::uint64_t exchange = exchanges_[direction];
+
+    std::size_t i=0;
+    for(auto info = messageInformation_.begin(); info != messageInformation_.end(); ++info, ++i) {
+      SharedMessage& message = shared_[i];
+      if(!message.onNode || !(pendingForward_ ? info->second.second : info->second.first).size_)
+        continue;
+      SharedCounter* counters = message.counters[direction];
+      if(counters[1].load(std::memory_order_relaxed) != exchange
+         && counters[0].load(std::memory_order_acquire) == exchange) {
+        MPI_Win_sync(window_);
+        scatter_(*this, target_, i);
+        MPI_Win_sync(window_);
+        counters[1].store(exchange, std::memory_order_release);
+        --pendingShared_;
       }
+    }
+  }
 
-    // Wait for completion of receive and immediately start scatter
-    i=0;
-    //int success = 1;
-    int finished = MPI_UNDEFINED;
-    MPI_Status status; //[messageInformation_.size()];
-    //MPI_Waitall(messageInformation_.size(), recvRequests, status);
 
-    for(i=0; i< numberOfRealRecvRequests; i++) {
-      status.MPI_ERROR=MPI_SUCCESS;
-      MPI_Waitany(messageInformation_.size(), recvRequests, &finished, &status);
-      assert(finished != MPI_UNDEFINED);
+  inline void BufferedCommunicator::testSends(int set)
+  {
+    // progress() waits for the completed requests without effect
+    int flag;
+    if(MPI_SUCCESS!=MPI_Testall(sendRequests_[set].size(), sendRequests_[set].data(), &flag, MPI_STATUSES_IGNORE))
+      failed_ = true;
+    if(readyMode_ && MPI_SUCCESS!=MPI_Testall(readySendRequests_[set].size(), readySendRequests_[set].data(),
+                                              &flag, MPI_STATUSES_IGNORE))
+      failed_ = true;
+  }
 
-      if(status.MPI_ERROR==MPI_SUCCESS) {
-        int& proc = processMap[finished];
-        typename InformationMap::const_iterator infoIter = messageInformation_.find(proc);
-        assert(infoIter != messageInformation_.end());
 
-        MessageInformation info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
-        assert(info.start_+info.size_ <= recvBufferSize);
+  template<class GatherScatter, bool FORWARD, class Data>
+  bool BufferedCommunicator::useDirect(const Data& source, Data& dest)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef std::integral_constant<bool, Impl::HasContiguousData<Data>::value
+                                   && std::is_same<GatherScatter, CopyGatherScatter<Data> >::value
+                                   && std::is_same<typename CommPolicy<Data>::IndexedTypeFlag, SizeOne>::value>
+    Possible;
+
+    if(!Possible::value || directTypeSize_ != sizeof(Type)
+       || !Impl::isContiguous(source, maxIndex_, Possible()) || !Impl::isContiguous(dest, maxIndex_, Possible()))
+      return false;
+
+    // The values received must not overwrite values still to be sent. In
+    // place this only happens if the interface sends and receives an index.
+    const void* send = CommPolicy<Data>::getAddress(source, 0);
+    void* recv = const_cast<void*>(CommPolicy<Data>::getAddress(dest, 0));
+    const std::size_t size = (maxIndex_+1)*sizeof(Type);
+    const std::less<const char*> less;
+    if(send == recv ? !directInPlace_
+       : less(static_cast<const char*>(send), static_cast<const char*>(recv)+size)
+       && less(static_cast<const char*>(recv), static_cast<const char*>(send)+size))
+      return false;
+
+    // The persistent requests are bound to the addresses of the data
+    const int direction = FORWARD ? 1 : 0;
+    if(directData_[direction] != std::make_pair(send, recv)) {
+      freeRequests(direction+2, direction+3);
+      createRequests(direction+2, static_cast<const char*>(send), static_cast<char*>(recv), sizeof(Type));
+      directData_[direction] = std::make_pair(send, recv);
+    }
+    return true;
+  }
+
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  {
+    this->template startSendRecv<GatherScatter,FORWARD>(source, dest);
+    progress(true);
+    checkErrors();
+  }
 
-        MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, dest, recvBuffer+info.start_, proc);
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::startSendRecv(const Data& source, Data& dest)
+  {
+    if(pending_)
+      DUNE_THROW(InvalidStateException, "BufferedCommunicator: the previous communication has not been finished!");
+
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    const bool direct = this->template useDirect<GatherScatter,FORWARD>(source, dest);
+    const int direction = (FORWARD ? 1 : 0) + (direct ? 2 : 0);
+
+    if(window_ != MPI_WIN_NULL)
+      this->template gatherRemote<GatherScatter,FORWARD>(source);
+    else if(!direct)
+      MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source,
+                                                          reinterpret_cast<Type*>(buffers_[FORWARD ? 0 : 1]),
+                                                          bufferSize_[FORWARD ? 0 : 1]);
+
+    failed_ = false;
+    pendingReceives_ = recvRequests_[direction].size();
+
+    // Start the receives first
+    if(!recvRequests_[direction].empty())
+      MPI_Startall(recvRequests_[direction].size(), recvRequests_[direction].data());
+    if(readyMode_) {
+      // The sends are started by progress() once the receivers are ready
+      pendingNotifications_ = readyRecvRequests_[direction].size();
+      if(!readyRecvRequests_[direction].empty())
+        MPI_Startall(readyRecvRequests_[direction].size(), readyRecvRequests_[direction].data());
+      if(!readySendRequests_[direction].empty())
+        MPI_Startall(readySendRequests_[direction].size(), readySendRequests_[direction].data());
+    }else if(!sendRequests_[direction].empty())
+      MPI_Startall(sendRequests_[direction].size(), sendRequests_[direction].data());
+    if(graph_ != MPI_COMM_NULL)
+      startCollective(direction);
+    if(window_ != MPI_WIN_NULL)
+      this->template sendShared<GatherScatter,FORWARD>(source);
+
+    pending_ = true;
+    pendingForward_ = FORWARD;
+    pendingDirect_ = direct;
+    target_ = &dest;
+    if(direct)
+      scatter_ = &BufferedCommunicator::ignoreMessage;
+    else
+      scatter_ = &BufferedCommunicator::scatterMessage<GatherScatter,FORWARD,Data>;
+  }
+
+
+  inline bool BufferedCommunicator::progress(bool wait)
+  {
+    // The messages in shared memory can only be polled, which also tests
+    // the MPI requests. Yield the processor in case the neighbours have to
+    // share it with us.
+    if(wait)
+      while(pendingShared_ > 0) {
+        if(progress(false))
+          return true;
+        std::this_thread::yield();
+      }
+    receiveShared();
+
+    const int direction = (pendingForward_ ? 1 : 0) + (pendingDirect_ ? 2 : 0);
+    std::vector<MPI_Request>& recvRequests = recvRequests_[direction];
+    std::vector<MPI_Request>& sendRequests = sendRequests_[direction];
+
+    // The neighbourhood collective completes all messages at once
+    if(graph_ != MPI_COMM_NULL) {
+      int flag = 1;
+      int result;
+      if(wait)
+        result = MPI_Wait(&collectives_[direction].request, MPI_STATUS_IGNORE);
+      else
+        result = MPI_Test(&collectives_[direction].request, &flag, MPI_STATUS_IGNORE);
+      if(result==MPI_SUCCESS && !flag)
+        return false;
+      if(result==MPI_SUCCESS) {
+        const std::vector<int>& recvCounts = collectives_[direction].recvCounts;
+        for(std::size_t message=0; message < recvCounts.size(); ++message)
+          if(recvCounts[message])
+            scatter_(*this, target_, message);
       }else{
-        std::cerr<<rank<<": MPI_Error occurred while receiving message from "<<processMap[finished]<<std::endl;
-        //success=0;
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+        std::cerr<<rank<<": MPI_Error occurred in the neighbourhood exchange"<<std::endl;
+        failed_ = true;
+      }
+      pending_ = false;
+      return true;
+    }
+
+    // In ready mode start each send once its receiver is ready. The
+    // notifications are sent when the communication starts, thus waiting
+    // for them before the receives cannot deadlock.
+    while(pendingNotifications_ > 0) {
+      int finished = MPI_UNDEFINED;
+      int flag = 1;
+      int result;
+      if(wait)
+        result = MPI_Waitany(readyRecvRequests_[direction].size(), readyRecvRequests_[direction].data(),
+                             &finished, MPI_STATUS_IGNORE);
+      else
+        result = MPI_Testany(readyRecvRequests_[direction].size(), readyRecvRequests_[direction].data(),
+                             &finished, &flag, MPI_STATUS_IGNORE);
+      if(result==MPI_SUCCESS && !flag)
+        break;
+      if(result!=MPI_SUCCESS || finished == MPI_UNDEFINED) {
+        failed_ = true;
+        pendingNotifications_ = 0;
+        break;
+      }
+      --pendingNotifications_;
+      MPI_Start(&sendRequests[finished]);
+    }
+
+    // Scatter the received messages as soon as they arrive
+    while(pendingReceives_ > 0) {
+      int finished = MPI_UNDEFINED;
+      int flag = 1;
+      MPI_Status status;
+      status.MPI_ERROR=MPI_SUCCESS;
+      int result;
+      if(wait)
+        result = MPI_Waitany(recvRequests.size(), recvRequests.data(), &finished, &status);
+      else
+        result = MPI_Testany(recvRequests.size(), recvRequests.data(), &finished, &flag, &status);
+      if(result==MPI_SUCCESS && !flag)
+        return false;
+      if(finished == MPI_UNDEFINED) {
+        // the error could not be attributed to a message
+        failed_ = true;
+        pendingReceives_ = 0;
+        break;
+      }
+      --pendingReceives_;
+
+      const std::size_t message = recvMessages_[direction][finished];
+      if(result==MPI_SUCCESS && status.MPI_ERROR==MPI_SUCCESS)
+        scatter_(*this, target_, message);
+      else{
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+        std::cerr<<rank<<": MPI_Error occurred while receiving message from "
+                 <<(messageInformation_.begin()+message)->first<<std::endl;
+        failed_ = true;
       }
     }
 
-    MPI_Status recvStatus;
+    if(pendingNotifications_ > 0)
+      return false;
 
     // Wait for completion of sends
-    for(i=0; i< messageInformation_.size(); i++)
-      if(MPI_SUCCESS!=MPI_Wait(sendRequests+i, &recvStatus)) {
-        std::cerr<<rank<<": MPI_Error occurred while sending message to "<<processMap[finished]<<std::endl;
-        //success=0;
+    if(readyMode_) {
+      std::vector<MPI_Request>& readySendRequests = readySendRequests_[direction];
+      int flag = 1;
+      int result;
+      if(wait)
+        result = MPI_Waitall(readySendRequests.size(), readySendRequests.data(), MPI_STATUSES_IGNORE);
+      else
+        result = MPI_Testall(readySendRequests.size(), readySendRequests.data(), &flag, MPI_STATUSES_IGNORE);
+      if(result!=MPI_SUCCESS)
+        failed_ = true;
+      else if(!flag)
+        return false;
+    }
+    if(wait) {
+      MPI_Status sendStatus;
+      for(std::size_t i=0; i< sendRequests.size(); i++)
+        if(MPI_SUCCESS!=MPI_Wait(&sendRequests[i], &sendStatus)) {
+          int rank;
+          MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+          std::cerr<<rank<<": MPI_Error occurred while sending message to "
+                   <<(messageInformation_.begin()+sendMessages_[direction][i])->first<<std::endl;
+          failed_ = true;
+        }
+    }else{
+      int flag;
+      if(MPI_SUCCESS!=MPI_Testall(sendRequests.size(), sendRequests.data(), &flag, MPI_STATUSES_IGNORE))
+      {
+        failed_ = true;
+        flag = true;
       }
-    /*
-       int globalSuccess;
-       MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, interface_->communicator());
+      if(!flag)
+        return false;
+    }
+    // The sends are tested above to let MPI progress while polling the shared memory
+    if(pendingShared_ > 0)
+      return false;
+
+    pending_ = false;
+    return true;
+  }
 
-       if(!globalSuccess)
-       DUNE_THROW(CommunicationError, "A communication error occurred!");
-     */
-    delete[] processMap;
-    delete[] sendRequests;
-    delete[] recvRequests;
 
+  inline void BufferedCommunicator::checkErrors()
+  {
+    int success = !failed_;
+    if(errorMode_ == CommunicationErrorMode::collective) {
+      int globalSuccess;
+      MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, communicator_);
+      success = globalSuccess;
+    }
+    if(!success)
+      DUNE_THROW(CommunicationError, "A communication error occurred!");
   }
 
 #endif  // DOXYGEN
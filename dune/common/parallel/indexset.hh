@@ -8,6 +8,7 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/unused.hh>
 #include <iostream>
+#include <utility>
 
 #include "localindex.hh"
 
@@ -837,7 +838,7 @@ namespace Dune
   inline void ParallelIndexSet<TG,TL,N>::merge(){
     if(localIndices_.size()==0)
     {
-      localIndices_=newIndices_;
+      localIndices_=std::move(newIndices_);
       newIndices_.clear();
     }
     else if(newIndices_.size()>0 || deletedEntries_)
@@ -886,7 +887,7 @@ namespace Dune
         tempPairs.push_back(*added);
         added.eraseToHere();
       }
-      localIndices_ = tempPairs;
+      localIndices_ = std::move(tempPairs);
     }
   }
 
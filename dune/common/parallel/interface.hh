@@ -419,12 +419,12 @@ namespace Dune
   }
 
 
-  inline const std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >& Interface::interfaces() const
+  inline const Interface::InformationMap& Interface::interfaces() const
   {
     return interfaces_;
   }
 
-  inline std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >& Interface::interfaces()
+  inline Interface::InformationMap& Interface::interfaces()
   {
     return interfaces_;
   }
@@ -481,8 +481,7 @@ namespace Dune
       if(interfacePair->second.first.size()==0 && interfacePair->second.second.size()==0) {
         interfacePair->second.first.free();
         interfacePair->second.second.free();
-        const_iterator toerase=interfacePair++;
-        interfaces_.erase(toerase);
+        interfacePair = interfaces_.erase(interfacePair);
       }else
         ++interfacePair;
   }
@@ -189,6 +189,48 @@ namespace Dune
   template<typename T1, typename T2>
   MPI_Datatype MPITraits<std::pair<T1,T2> >::type=MPI_DATATYPE_NULL;
 
+  template<class T, int n>
+  class ReservedVector;
+
+  template<class T, int n>
+  struct MPITraits<ReservedVector<T,n> >
+  {
+  public:
+    inline static MPI_Datatype getType();
+  private:
+    static MPI_Datatype type;
+  };
+  template<class T, int n>
+  MPI_Datatype MPITraits<ReservedVector<T,n> >::getType()
+  {
+    if(type==MPI_DATATYPE_NULL) {
+      using Vector = ReservedVector<T,n>;
+      static_assert(std::is_trivially_copyable<Vector>::value,
+                    "ReservedVector can only be sent as a whole for trivially copyable types");
+      static_assert(std::is_standard_layout<Vector>::value, "offsetof() is only defined for standard layout types");
+
+      // all n entries are sent, those beyond size() are value-initialized or hold old values
+      int length[2] = {n, 1};
+      MPI_Aint disp[2];
+      MPI_Datatype types[2] = {MPITraits<T>::getType(),
+                               MPITraits<typename Vector::size_type>::getType()};
+      disp[0] = offsetof(Vector, storage);
+      disp[1] = offsetof(Vector, sz);
+
+      MPI_Datatype tmp;
+      MPI_Type_create_struct(2, length, disp, types, &tmp);
+
+      MPI_Type_create_resized(tmp, 0, sizeof(Vector), &type);
+      MPI_Type_commit(&type);
+
+      MPI_Type_free(&tmp);
+    }
+    return type;
+  }
+
+  template<class T, int n>
+  MPI_Datatype MPITraits<ReservedVector<T,n> >::type=MPI_DATATYPE_NULL;
+
 #endif // !DOXYGEN
 
 } // namespace Dune
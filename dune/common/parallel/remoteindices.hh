@@ -5,8 +5,12 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <ostream>
 #include <map>
 #include <memory>
@@ -17,11 +21,14 @@
 #include <mpi.h>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/flatmap.hh>
+#include <dune/common/hash.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/mpitraits.hh>
 #include <dune/common/parallel/plocalindex.hh>
 #include <dune/common/sllist.hh>
 #include <dune/common/stdstreams.hh>
+#include <dune/common/typetraits.hh>
 
 namespace Dune {
   /** @addtogroup Common_Parallel
@@ -164,7 +171,6 @@ namespace Dune {
   template<typename T1, typename T2>
   class OwnerOverlapCopyCommunication;
 
-
   /**
    * @brief The indices present on remote processes.
    *
@@ -174,10 +180,14 @@ namespace Dune {
    * are attached to them on the remote side.
    *
    * This information is managed by this class. The information can either
-   * be computed automatically calling rebuild (which requires information
-   * to be sent in a ring) or set up by hand using the
+   * be computed automatically calling rebuild (which looks up the
+   * neighbouring processes in a distributed directory unless they are
+   * given) or set up by hand using the
    * RemoteIndexListModifiers returned by function getModifier(int).
    *
+   * The global indices need MPITraits and operator<. If there is a
+   * Dune::hash for them, it is used to distribute the directory.
+   *
    * @tparam T The type of the underlying index set.
    * @tparam A The type of the allocator to use.
    */
@@ -254,8 +264,8 @@ namespace Dune {
      * local mapping at the destination of the communication.
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
-     * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * If this parameter is omitted the neighbours are looked up in a distributed
+     * directory of the published global indices during rebuild.
      * @param includeSelf If true, sending from indices of the processor to other
      * indices on the same processor is enabled even if the same indexset is used
      * on both the
@@ -288,8 +298,8 @@ namespace Dune {
      * local mapping at the destination of the communication.
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
-     * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * If this parameter is omitted the neighbours are looked up in a distributed
+     * directory of the published global indices during rebuild.
      */
     void setIndexSets(const ParallelIndexSet& source, const ParallelIndexSet& destination,
                       const MPI_Comm& comm, const std::vector<int>& neighbours=std::vector<int>());
@@ -316,7 +326,10 @@ namespace Dune {
      * @brief Rebuilds the set of remote indices.
      *
      * This has to be called whenever the underlying index sets
-     * change.
+     * change. If the remote indices were built before with the same
+     * neighbours and treatment of the public flag, only the indices
+     * added and removed since then are exchanged. Collective
+     * on the communicator.
      *
      * If the template parameter ignorePublic is true all indices will be treated
      * as public.
@@ -463,6 +476,58 @@ namespace Dune {
      */
     RemoteIndexMap remoteIndices_;
 
+    /** @brief A published index: its global index and attribute. */
+    typedef std::pair<GlobalIndex,Attribute> PublishedIndex;
+
+    /** @brief Published indices sorted like in the index set. */
+    typedef std::vector<PublishedIndex> PublishedIndices;
+
+    /**
+     * @brief The published indices of a neighbour that we know, too.
+     *
+     * The first entry holds the indices of the source index set of the
+     * neighbour, the second the ones of its destination index set.
+     */
+    typedef std::array<PublishedIndices,2> SharedIndices;
+
+    /**
+     * @brief The indices we published during the last build, first
+     * of the source and then of the destination index set.
+     */
+    SharedIndices published_;
+
+    /**
+     * @brief The shared indices of all processes we exchanged indices
+     * with during the last build.
+     *
+     * Allows rebuild to only exchange the changes of the index sets.
+     */
+    FlatMap<int,SharedIndices> sharedIndices_;
+
+    /**
+     * @brief Our part of the distributed directory of published global indices.
+     *
+     * Holds the processes publishing each global index assigned to us.
+     * Only used if the neighbours are not given.
+     */
+    std::vector<std::pair<GlobalIndex,int> > directory_;
+
+    /**
+     * @brief The first global index assigned to each directory process but the first.
+     *
+     * Only used if there is no Dune::hash for the global index.
+     */
+    std::vector<GlobalIndex> directorySplitters_;
+
+    /** @brief Whether the last build looked up the neighbours in the directory. */
+    bool useDirectory_;
+
+    /** @brief Whether the next rebuild may just exchange the changes. */
+    bool updatable_;
+
+    /** @brief The communicator tag for the answers during an update. */
+    const static int answerTag_=334;
+
     /**
      * @brief Build the remote mapping.
      *
@@ -476,6 +541,134 @@ namespace Dune {
     template<bool ignorePublic>
     inline void buildRemote(bool includeSelf);
 
+    /**
+     * @brief Find the processes that know any of our published global indices.
+     *
+     * Each global index is assigned to a directory process by its hash.
+     * If there is no Dune::hash for the global index, the sorted global
+     * indices are split into blocks of about the same size instead.
+     * Every process sends its published global indices to their directory
+     * processes, which in turn tell each process the other processes
+     * that published the same indices. The communication volume only
+     * depends on the number of published indices and not on the
+     * number of processes.
+     *
+     * If the template parameter ignorePublic is true all indices will be treated
+     * as public.
+     * @param neighbours The set to store the neighbouring processes in.
+     */
+    template<bool ignorePublic>
+    inline void discoverNeighbours(std::set<int>& neighbours);
+
+    /**
+     * @brief Choose the splitters of the directory blocks from samples of the published indices.
+     *
+     * This is collective and only needed if there is no Dune::hash for the global index.
+     * @param published Our published global indices, sorted and without duplicates.
+     */
+    inline void setupDirectory(const std::vector<GlobalIndex>& published, std::true_type);
+    inline void setupDirectory(const std::vector<GlobalIndex>& published, std::false_type);
+
+    /**
+     * @brief Get the directory process of a global index.
+     * @param global The global index.
+     * @param procs The number of processes.
+     */
+    inline int directoryProcess(const GlobalIndex& global, int procs, std::true_type) const;
+    inline int directoryProcess(const GlobalIndex& global, int procs, std::false_type) const;
+
+    /**
+     * @brief Update the remote mapping after the index sets changed.
+     *
+     * Only the indices added and removed since the last build are
+     * exchanged with the neighbours. Processes that start to share
+     * indices are found by updating the distributed directory.
+     *
+     * If the template parameter ignorePublic is true all indices will be treated
+     * as public.
+     */
+    template<bool ignorePublic>
+    inline void updateRemote();
+
+    /**
+     * @brief Update our part of the distributed directory.
+     * @param removed The global indices we do not publish any more.
+     * @param added The global indices we started to publish.
+     * @param sharers Map to store the processes in that share one of the
+     * added global indices with us, together with these indices.
+     */
+    inline void updateDirectory(const std::vector<GlobalIndex>& removed,
+                                const std::vector<GlobalIndex>& added,
+                                FlatMap<int,std::vector<GlobalIndex> >& sharers);
+
+    /**
+     * @brief Collect the published indices of an index set.
+     *
+     * If the template parameter ignorePublic is true all indices will be treated
+     * as public.
+     * @param indexSet The index set to collect the indices of.
+     * @param pairs Vector to store pointers to the published pairs in.
+     * @param published Vector to store the published indices in.
+     */
+    template<bool ignorePublic>
+    inline void collectPublished(const ParallelIndexSet& indexSet,
+                                 std::vector<PairType*>& pairs,
+                                 PublishedIndices& published);
+
+    /**
+     * @brief Add the remote indices for a remote process.
+     *
+     * The lists are only stored if they are not empty.
+     * @param remoteProc The remote process.
+     * @param remote The published indices of the remote process.
+     * @param sourcePairs The published pairs of our source index set.
+     * @param destPairs The published pairs of our destination index set.
+     * @param fromOurSelf Whether the indices are from ourself.
+     * @param shared If not null the remote indices that we know are stored here.
+     */
+    inline void createRemote(int remoteProc, const SharedIndices& remote,
+                             PairType* const* sourcePairs, int sourcePublish,
+                             PairType* const* destPairs, int destPublish,
+                             bool fromOurSelf, SharedIndices* shared);
+
+    /**
+     * @brief Match remote indices with our published pairs.
+     * @param remote The list to add the remote indices to.
+     * @param remoteIndices The published indices of the remote process.
+     * @param local Our published pairs.
+     * @param localEntries The number of our published pairs.
+     * @param fromOurSelf Whether the indices are from ourself. Then only
+     * pairs with different attributes are added.
+     * @param shared If not null the remote indices that we know are stored here.
+     */
+    inline void matchIndices(RemoteIndexList& remote, const PublishedIndices& remoteIndices,
+                             PairType* const* local, int localEntries,
+                             bool fromOurSelf, PublishedIndices* shared);
+
+    /** @brief Delete the remote index lists. */
+    inline void freeLists();
+
+    /** @brief Add the remote index lists for a process unless they are empty. */
+    inline void insertRemote(int remoteProc, RemoteIndexList* send, RemoteIndexList* receive);
+
+    /** @brief Get the number of bytes needed to pack published indices and their number. */
+    inline int packSize(const PublishedIndices& published);
+
+    /** @brief Get the number of bytes needed to pack global indices and their number. */
+    inline int packSize(const std::vector<GlobalIndex>& globals);
+
+    /** @brief Pack published indices preceded by their number. */
+    inline void pack(const PublishedIndices& published, char* p_out, int bufferSize, int* position);
+
+    /** @brief Pack global indices preceded by their number. */
+    inline void pack(const std::vector<GlobalIndex>& globals, char* p_out, int bufferSize, int* position);
+
+    /** @brief Unpack published indices preceded by their number. */
+    inline void unpack(PublishedIndices& published, char* p_in, int bufferSize, int* position);
+
+    /** @brief Unpack global indices preceded by their number. */
+    inline void unpack(std::vector<GlobalIndex>& globals, char* p_in, int bufferSize, int* position);
+
     /**
      * @brief Count the number of public indices in an index set.
      * @param indexSet The index set whose indices we count.
@@ -525,7 +718,8 @@ namespace Dune {
 
     void unpackCreateRemote(char* p_in, PairType** sourcePairs, PairType** DestPairs,
                             int remoteProc,  int sourcePublish, int destPublish,
-                            int bufferSize, bool sendTwo, bool fromOurSelf=false);
+                            int bufferSize, bool sendTwo, bool fromOurSelf=false,
+                            SharedIndices* shared=0);
   };
 
   /** @} */
@@ -963,7 +1157,7 @@ namespace Dune {
                                            bool includeSelf_)
     : source_(&source), target_(&destination), comm_(comm),
       sourceSeqNo_(-1), destSeqNo_(-1), publicIgnored(false), firstBuild(true),
-      includeSelf(includeSelf_)
+      includeSelf(includeSelf_), useDirectory_(false), updatable_(false)
   {
     setNeighbours(neighbours);
   }
@@ -978,7 +1172,7 @@ namespace Dune {
   RemoteIndices<T,A>::RemoteIndices()
     : source_(0), target_(0), sourceSeqNo_(-1),
       destSeqNo_(-1), publicIgnored(false), firstBuild(true),
-      includeSelf(false)
+      includeSelf(false), useDirectory_(false), updatable_(false)
   {}
 
   template<class T, typename A>
@@ -1067,7 +1261,7 @@ namespace Dune {
                                                      PairType** destPairs, int remoteProc,
                                                      int sourcePublish, int destPublish,
                                                      int bufferSize, bool sendTwo,
-                                                     bool fromOurSelf)
+                                                     bool fromOurSelf, SharedIndices* shared)
   {
 
     // unpack the number of indices we received
@@ -1081,41 +1275,85 @@ namespace Dune {
     // The number of destination indices received
     MPI_Unpack(p_in, bufferSize, &position, &noRemoteDest, 1, MPI_INT, comm_);
 
+    MPI_Datatype type= MPITraits<PairType>::getType();
+
+    if(bool(twoIndexSets) == sendTwo) {
+      // Both processes use the same kind of index sets
+      SharedIndices remote;
+      PairType index;
+      remote[0].reserve(noRemoteSource);
+      for(int i=0; i < noRemoteSource; ++i) {
+        MPI_Unpack(p_in, bufferSize, &position, &index, 1, type, comm_);
+        remote[0].push_back(PublishedIndex(index.global(), index.local().attribute()));
+      }
+      remote[1].reserve(noRemoteDest);
+      for(int i=0; i < noRemoteDest; ++i) {
+        MPI_Unpack(p_in, bufferSize, &position, &index, 1, type, comm_);
+        remote[1].push_back(PublishedIndex(index.global(), index.local().attribute()));
+      }
+      createRemote(remoteProc, remote, sourcePairs, sourcePublish, destPairs, destPublish,
+                   fromOurSelf, shared);
+      return;
+    }
+
+    // The index sets differ, changes cannot be exchanged incrementally
+    updatable_ = false;
 
     // Indices for which we receive
     RemoteIndexList* receive= new RemoteIndexList();
     // Indices for which we send
     RemoteIndexList* send=0;
 
-    MPI_Datatype type= MPITraits<PairType>::getType();
-
     if(!twoIndexSets) {
-      if(sendTwo) {
-        send = new RemoteIndexList();
-        // Create both remote index sets simultaneously
-        unpackIndices(*send, *receive, noRemoteSource, sourcePairs, sourcePublish,
-                      destPairs, destPublish, p_in, type, &position, bufferSize);
-      }else{
-        // we only need one list
-        unpackIndices(*receive, noRemoteSource, sourcePairs, sourcePublish,
-                      p_in, type, &position, bufferSize, fromOurSelf);
-        send=receive;
-      }
+      send = new RemoteIndexList();
+      // Create both remote index sets simultaneously
+      unpackIndices(*send, *receive, noRemoteSource, sourcePairs, sourcePublish,
+                    destPairs, destPublish, p_in, type, &position, bufferSize);
     }else{
-
       int oldPos=position;
       // Two index sets received
       unpackIndices(*receive, noRemoteSource, destPairs, destPublish,
                     p_in, type, &position, bufferSize, fromOurSelf);
-      if(!sendTwo)
-        //unpack source entries again as destination entries
-        position=oldPos;
+      //unpack source entries again as destination entries
+      position=oldPos;
 
       send = new RemoteIndexList();
       unpackIndices(*send, noRemoteDest, sourcePairs, sourcePublish,
                     p_in, type, &position, bufferSize, fromOurSelf);
     }
 
+    insertRemote(remoteProc, send, receive);
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::createRemote(int remoteProc, const SharedIndices& remote,
+                                               PairType* const* sourcePairs, int sourcePublish,
+                                               PairType* const* destPairs, int destPublish,
+                                               bool fromOurSelf, SharedIndices* shared)
+  {
+    // Indices for which we receive
+    RemoteIndexList* receive= new RemoteIndexList();
+    // Indices for which we send
+    RemoteIndexList* send=receive;
+
+    if(source_ == target_) {
+      matchIndices(*receive, remote[0], sourcePairs, sourcePublish, fromOurSelf,
+                   shared ? &(*shared)[0] : 0);
+    }else{
+      matchIndices(*receive, remote[0], destPairs, destPublish, fromOurSelf,
+                   shared ? &(*shared)[0] : 0);
+      send = new RemoteIndexList();
+      matchIndices(*send, remote[1], sourcePairs, sourcePublish, fromOurSelf,
+                   shared ? &(*shared)[1] : 0);
+    }
+
+    insertRemote(remoteProc, send, receive);
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::insertRemote(int remoteProc, RemoteIndexList* send,
+                                               RemoteIndexList* receive)
+  {
     if(receive->empty() && send->empty()) {
       if(send==receive) {
         delete send;
@@ -1129,6 +1367,37 @@ namespace Dune {
     }
   }
 
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::matchIndices(RemoteIndexList& remote,
+                                               const PublishedIndices& remoteIndices,
+                                               PairType* const* local, int localEntries,
+                                               bool fromOurSelf, PublishedIndices* shared)
+  {
+    PairType* const* begin = local;
+    PairType* const* const end = local+localEntries;
+
+    // Both the remote and our indices are sorted by their global index
+    typedef typename PublishedIndices::const_iterator Iterator;
+    for(Iterator index = remoteIndices.begin(); index != remoteIndices.end(); ++index) {
+      begin = std::lower_bound(begin, end, index->first,
+                               [](const PairType* pair, const GlobalIndex& global) {
+                                 return pair->global() < global;
+                               });
+      if(begin == end)
+        break;
+
+      bool known = false;
+      for(PairType* const* pair = begin; pair != end && (*pair)->global() == index->first; ++pair) {
+        known = true;
+        if(!fromOurSelf || index->second != (*pair)->local().attribute())
+          // if index is from us it has to have a different attribute
+          remote.push_back(RemoteIndex(index->second, *pair));
+      }
+      if(known && shared)
+        shared->push_back(*index);
+    }
+  }
+
 
   template<typename T, typename A>
   template<bool ignorePublic>
@@ -1150,6 +1419,8 @@ namespace Dune {
       // Nothing to communicate
       return;
 
+    updatable_ = true;
+
     sourcePublish = (ignorePublic) ? source_->size() : noPublic(*source_);
 
     if(sendTwo)
@@ -1158,11 +1429,6 @@ namespace Dune {
       // we only need to send one set of indices
       destPublish = 0;
 
-    int maxPublish, publish=sourcePublish+destPublish;
-
-    // Calucate maximum number of indices send
-    MPI_Allreduce(&publish, &maxPublish, 1, MPI_INT, MPI_MAX, comm_);
-
     // allocate buffers
     typedef IndexPair<GlobalIndex,LocalIndex> PairType;
 
@@ -1174,7 +1440,6 @@ namespace Dune {
     else
       destPairs=sourcePairs;
 
-    char** buffer = new char*[2];
     int bufferSize;
     int position=0;
     int intSize;
@@ -1183,7 +1448,7 @@ namespace Dune {
     // calculate buffer size
     MPI_Datatype type = MPITraits<PairType>::getType();
 
-    MPI_Pack_size(maxPublish, type, comm_,
+    MPI_Pack_size(sourcePublish+destPublish, type, comm_,
                   &bufferSize);
     MPI_Pack_size(1, MPI_INT, comm_,
                   &intSize);
@@ -1195,125 +1460,651 @@ namespace Dune {
     // then the source and destination indices
     bufferSize += 2 * intSize + charSize;
 
-    if(bufferSize<=0) bufferSize=1;
-
-    buffer[0] = new char[bufferSize];
-    buffer[1] = new char[bufferSize];
+    char* buffer = new char[bufferSize];
+    // Receive buffer, resized to each incoming message
+    std::vector<char> inBuffer;
 
-
-    // pack entries into buffer[0], p_out below!
-    MPI_Pack(&sendTwo, 1, MPI_CHAR, buffer[0], bufferSize, &position,
+    // pack entries into buffer
+    MPI_Pack(&sendTwo, 1, MPI_CHAR, buffer, bufferSize, &position,
              comm_);
 
     // The number of indices we send for each index set
-    MPI_Pack(&sourcePublish, 1, MPI_INT, buffer[0], bufferSize, &position,
+    MPI_Pack(&sourcePublish, 1, MPI_INT, buffer, bufferSize, &position,
              comm_);
-    MPI_Pack(&destPublish, 1, MPI_INT, buffer[0], bufferSize, &position,
+    MPI_Pack(&destPublish, 1, MPI_INT, buffer, bufferSize, &position,
              comm_);
 
     // Now pack the source indices and setup the destination pairs
-    packEntries<ignorePublic>(sourcePairs, *source_, buffer[0], type,
+    packEntries<ignorePublic>(sourcePairs, *source_, buffer, type,
                               bufferSize, &position, sourcePublish);
     // If necessary send the dest indices and setup the source pairs
     if(sendTwo)
-      packEntries<ignorePublic>(destPairs, *target_, buffer[0], type,
+      packEntries<ignorePublic>(destPairs, *target_, buffer, type,
                                 bufferSize, &position, destPublish);
 
 
     // Update remote indices for ourself
     if(sendTwo|| includeSelf_)
-      unpackCreateRemote(buffer[0], sourcePairs, destPairs, rank, sourcePublish,
+      unpackCreateRemote(buffer, sourcePairs, destPairs, rank, sourcePublish,
                          destPublish, bufferSize, sendTwo, includeSelf_);
 
     neighbourIds.erase(rank);
 
-    if(neighbourIds.size()==0)
+    // Without user provided neighbours we look them up in a distributed
+    // directory instead of passing all indices around.
+    std::set<int> discovered;
+    useDirectory_ = neighbourIds.empty();
+    if(useDirectory_ && procs>1)
+      discoverNeighbours<ignorePublic>(discovered);
+
+    const std::set<int>& neighbours = neighbourIds.empty() ? discovered : neighbourIds;
+
+    typedef typename std::set<int>::size_type size_type;
+    size_type noNeighbours=neighbours.size();
+
+    std::vector<MPI_Request> requests(noNeighbours);
+    std::vector<MPI_Status> statuses(noNeighbours);
+    MPI_Request* req=requests.data();
+
+    // setup sends
+    for(std::set<int>::const_iterator neighbour=neighbours.begin();
+        neighbour!= neighbours.end(); ++neighbour) {
+      // Only send the information to the neighbouring processors
+      MPI_Issend(buffer, position , MPI_PACKED, *neighbour, commTag_, comm_, req++);
+    }
+
+    // Receive the messages of our neighbours. We probe each neighbour
+    // separately, as a fast neighbour might already have sent the message
+    // of its next rebuild.
+    for(std::set<int>::const_iterator neighbour=neighbours.begin();
+        neighbour!= neighbours.end(); ++neighbour)
     {
-      Dune::dvverb<<rank<<": Sending messages in a ring"<<std::endl;
-      // send messages in ring
-      for(int proc=1; proc<procs; proc++) {
-        // pointers to the current input and output buffers
-        char* p_out = buffer[1-(proc%2)];
-        char* p_in = buffer[proc%2];
-
-        MPI_Status status;
-        if(rank%2==0) {
-          MPI_Ssend(p_out, bufferSize, MPI_PACKED, (rank+1)%procs,
-                    commTag_, comm_);
-          MPI_Recv(p_in, bufferSize, MPI_PACKED, (rank+procs-1)%procs,
-                   commTag_, comm_, &status);
-        }else{
-          MPI_Recv(p_in, bufferSize, MPI_PACKED, (rank+procs-1)%procs,
-                   commTag_, comm_, &status);
-          MPI_Ssend(p_out, bufferSize, MPI_PACKED, (rank+1)%procs,
-                    commTag_, comm_);
+      MPI_Status status;
+      int remoteProc=*neighbour;
+      MPI_Probe(remoteProc, commTag_, comm_, &status);
+      int size;
+      MPI_Get_count(&status, MPI_PACKED, &size);
+      inBuffer.resize(size>0 ? size : 1);
+      // receive message
+      MPI_Recv(inBuffer.data(), size, MPI_PACKED, remoteProc,
+               commTag_, comm_, &status);
+
+      unpackCreateRemote(inBuffer.data(), sourcePairs, destPairs, remoteProc, sourcePublish,
+                         destPublish, size, sendTwo, false, &sharedIndices_[remoteProc]);
+    }
+    // wait for completion of pending requests
+    if(MPI_ERR_IN_STATUS==MPI_Waitall(noNeighbours, requests.data(), statuses.data())) {
+      for(size_type i=0; i < noNeighbours; ++i)
+        if(statuses[i].MPI_ERROR!=MPI_SUCCESS) {
+          std::cerr<<rank<<": MPI_Error occurred while receiving message."<<std::endl;
+          MPI_Abort(comm_, 999);
         }
+    }
 
+    // Remember what we published to exchange only the changes later on
+    for(int i=0; i < sourcePublish; ++i)
+      published_[0].push_back(PublishedIndex(sourcePairs[i]->global(),
+                                             sourcePairs[i]->local().attribute()));
+    for(int i=0; i < destPublish; ++i)
+      published_[1].push_back(PublishedIndex(destPairs[i]->global(),
+                                             destPairs[i]->local().attribute()));
 
-        // The process these indices are from
-        int remoteProc = (rank+procs-proc)%procs;
+    // delete allocated memory
+    if(destPairs!=sourcePairs)
+      delete[] destPairs;
 
-        unpackCreateRemote(p_in, sourcePairs, destPairs, remoteProc, sourcePublish,
-                           destPublish, bufferSize, sendTwo);
+    delete[] sourcePairs;
+    delete[] buffer;
+  }
 
-      }
+  template<typename T, typename A>
+  template<bool ignorePublic>
+  inline void RemoteIndices<T,A>::discoverNeighbours(std::set<int>& neighbours)
+  {
+    int rank, procs;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Comm_size(comm_, &procs);
 
+    // The global indices we publish, sorted and without duplicates
+    std::vector<GlobalIndex> published;
+    typedef typename ParallelIndexSet::const_iterator const_iterator;
+    for(const_iterator index = source_->begin(); index != source_->end(); ++index)
+      if(ignorePublic || index->local().isPublic())
+        published.push_back(index->global());
+    if(source_ != target_)
+      for(const_iterator index = target_->begin(); index != target_->end(); ++index)
+        if(ignorePublic || index->local().isPublic())
+          published.push_back(index->global());
+    std::sort(published.begin(), published.end());
+    published.erase(std::unique(published.begin(), published.end()), published.end());
+
+    // Sort the indices by their directory process
+    typedef Impl::IsHashable<GlobalIndex> Hashable;
+    setupDirectory(published, Hashable());
+    std::vector<int> directory(published.size());
+    std::vector<int> sendCounts(procs, 0), sendDispls(procs+1, 0);
+    for(std::size_t i=0; i < published.size(); ++i) {
+      directory[i] = directoryProcess(published[i], procs, Hashable());
+      ++sendCounts[directory[i]];
     }
-    else
+    for(int p=0; p < procs; ++p)
+      sendDispls[p+1] = sendDispls[p] + sendCounts[p];
+
+    std::vector<GlobalIndex> sendIndices(published.size());
     {
-      MPI_Request* requests=new MPI_Request[neighbourIds.size()];
-      MPI_Request* req=requests;
+      std::vector<int> offsets(sendDispls.begin(), sendDispls.end()-1);
+      for(std::size_t i=0; i < published.size(); ++i)
+        sendIndices[offsets[directory[i]]++] = published[i];
+    }
+
+    std::vector<int> recvCounts(procs), recvDispls(procs+1, 0);
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, comm_);
+    for(int p=0; p < procs; ++p)
+      recvDispls[p+1] = recvDispls[p] + recvCounts[p];
+
+    std::vector<GlobalIndex> recvIndices(recvDispls[procs]);
+    MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+    MPI_Alltoallv(sendIndices.data(), sendCounts.data(), sendDispls.data(), type,
+                  recvIndices.data(), recvCounts.data(), recvDispls.data(), type, comm_);
+
+    // Act as directory: group the received indices by global index
+    std::vector<std::pair<GlobalIndex,int> > entries;
+    entries.reserve(recvIndices.size());
+    for(int p=0; p < procs; ++p)
+      for(int i=recvDispls[p]; i < recvDispls[p+1]; ++i)
+        entries.push_back(std::make_pair(recvIndices[i], p));
+    std::sort(entries.begin(), entries.end());
+
+    // Every process sharing an index learns about all others
+    std::vector<std::vector<int> > sharers(procs);
+    for(std::size_t begin=0, end=0; begin < entries.size(); begin=end) {
+      for(end=begin+1; end < entries.size() && entries[end].first == entries[begin].first; ++end) ;
+      for(std::size_t i=begin; i < end; ++i)
+        for(std::size_t j=begin; j < end; ++j)
+          if(i != j)
+            sharers[entries[i].second].push_back(entries[j].second);
+    }
+
+    std::vector<int> sendProcs;
+    for(int p=0; p < procs; ++p) {
+      std::sort(sharers[p].begin(), sharers[p].end());
+      sharers[p].erase(std::unique(sharers[p].begin(), sharers[p].end()), sharers[p].end());
+      sendCounts[p] = sharers[p].size();
+      sendDispls[p+1] = sendDispls[p] + sendCounts[p];
+      sendProcs.insert(sendProcs.end(), sharers[p].begin(), sharers[p].end());
+    }
+
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, comm_);
+    for(int p=0; p < procs; ++p)
+      recvDispls[p+1] = recvDispls[p] + recvCounts[p];
+
+    std::vector<int> recvProcs(recvDispls[procs]);
+    MPI_Alltoallv(sendProcs.data(), sendCounts.data(), sendDispls.data(), MPI_INT,
+                  recvProcs.data(), recvCounts.data(), recvDispls.data(), MPI_INT, comm_);
+
+    neighbours.insert(recvProcs.begin(), recvProcs.end());
+
+    // Keep the directory for later updates
+    directory_.swap(entries);
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::setupDirectory(const std::vector<GlobalIndex>&, std::true_type)
+  {}
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::setupDirectory(const std::vector<GlobalIndex>& published,
+                                                 std::false_type)
+  {
+    int procs;
+    MPI_Comm_size(comm_, &procs);
+
+    // Take up to procs regularly spaced samples of our indices
+    std::vector<GlobalIndex> samples;
+    std::size_t noSamples = std::min(published.size(), static_cast<std::size_t>(procs));
+    samples.reserve(noSamples);
+    for(std::size_t i=0; i < noSamples; ++i)
+      samples.push_back(published[((2*i+1)*published.size())/(2*noSamples)]);
+
+    int count = noSamples;
+    std::vector<int> counts(procs), displs(procs+1, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm_);
+    for(int p=0; p < procs; ++p)
+      displs[p+1] = displs[p] + counts[p];
+
+    std::vector<GlobalIndex> allSamples(displs[procs]);
+    MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+    MPI_Allgatherv(samples.data(), count, type, allSamples.data(), counts.data(),
+                   displs.data(), type, comm_);
+    std::sort(allSamples.begin(), allSamples.end());
+
+    directorySplitters_.clear();
+    if(allSamples.empty())
+      return;
+    directorySplitters_.reserve(procs-1);
+    for(int p=1; p < procs; ++p)
+      directorySplitters_.push_back(allSamples[(p*allSamples.size())/procs]);
+  }
+
+  template<typename T, typename A>
+  inline int RemoteIndices<T,A>::directoryProcess(const GlobalIndex& global, int procs,
+                                                  std::true_type) const
+  {
+    Dune::hash<GlobalIndex> hasher;
+    return hasher(global) % static_cast<std::size_t>(procs);
+  }
+
+  template<typename T, typename A>
+  inline int RemoteIndices<T,A>::directoryProcess(const GlobalIndex& global, int,
+                                                  std::false_type) const
+  {
+    return std::upper_bound(directorySplitters_.begin(), directorySplitters_.end(), global)
+           - directorySplitters_.begin();
+  }
 
-      typedef typename std::set<int>::size_type size_type;
-      size_type noNeighbours=neighbourIds.size();
+  template<typename T, typename A>
+  template<bool ignorePublic>
+  inline void RemoteIndices<T,A>::updateRemote()
+  {
+    int rank;
+    MPI_Comm_rank(comm_, &rank);
 
-      // setup sends
-      for(std::set<int>::iterator neighbour=neighbourIds.begin();
-          neighbour!= neighbourIds.end(); ++neighbour) {
-        // Only send the information to the neighbouring processors
-        MPI_Issend(buffer[0], position , MPI_PACKED, *neighbour, commTag_, comm_, req++);
+    const bool sendTwo = (source_ != target_);
+    const int noSets = sendTwo ? 2 : 1;
+    // The index set of a neighbour that is matched with one of ours
+    auto partner = [sendTwo](int set) {
+                     return sendTwo ? 1-set : 0;
+                   };
+    auto globalsOf = [](const PublishedIndices& published) {
+                       std::vector<GlobalIndex> globals;
+                       for(const PublishedIndex& index : published)
+                         if(globals.empty() || !(globals.back() == index.first))
+                           globals.push_back(index.first);
+                       return globals;
+                     };
+
+    // Our published indices and the changes since the last build
+    const ParallelIndexSet* indexSets[2] = { source_, target_ };
+    std::vector<PairType*> pairs[2];
+    SharedIndices published, removed, added;
+    std::vector<GlobalIndex> oldGlobals[2], globals[2], addedGlobals[2];
+    for(int set=0; set < noSets; ++set) {
+      collectPublished<ignorePublic>(*indexSets[set], pairs[set], published[set]);
+      std::set_difference(published_[set].begin(), published_[set].end(),
+                          published[set].begin(), published[set].end(),
+                          std::back_inserter(removed[set]));
+      std::set_difference(published[set].begin(), published[set].end(),
+                          published_[set].begin(), published_[set].end(),
+                          std::back_inserter(added[set]));
+      oldGlobals[set] = globalsOf(published_[set]);
+      globals[set] = globalsOf(published[set]);
+      std::set_difference(globals[set].begin(), globals[set].end(),
+                          oldGlobals[set].begin(), oldGlobals[set].end(),
+                          std::back_inserter(addedGlobals[set]));
+    }
+
+    // The processes we exchanged indices with and the ones that
+    // start sharing indices with us
+    std::set<int> neighbours;
+    for(const auto& shared : sharedIndices_)
+      neighbours.insert(shared.first);
+
+    FlatMap<int,std::vector<GlobalIndex> > sharers;
+    if(useDirectory_) {
+      std::vector<GlobalIndex> oldUnion, newUnion, removedUnion, addedUnion;
+      std::set_union(oldGlobals[0].begin(), oldGlobals[0].end(),
+                     oldGlobals[1].begin(), oldGlobals[1].end(), std::back_inserter(oldUnion));
+      std::set_union(globals[0].begin(), globals[0].end(),
+                     globals[1].begin(), globals[1].end(), std::back_inserter(newUnion));
+      std::set_difference(oldUnion.begin(), oldUnion.end(), newUnion.begin(), newUnion.end(),
+                          std::back_inserter(removedUnion));
+      std::set_difference(newUnion.begin(), newUnion.end(), oldUnion.begin(), oldUnion.end(),
+                          std::back_inserter(addedUnion));
+      updateDirectory(removedUnion, addedUnion, sharers);
+      for(const auto& sharer : sharers)
+        neighbours.insert(sharer.first);
+    }
+
+    typedef typename std::set<int>::size_type size_type;
+    const size_type noNeighbours = neighbours.size();
+    const std::vector<int> procs(neighbours.begin(), neighbours.end());
+
+    // The global indices we need the indices of each neighbour for. For
+    // known neighbours these are the added ones, new neighbours only
+    // share indices reported by the directory.
+    std::vector<char> isNew(noNeighbours);
+    std::vector<std::array<std::vector<GlobalIndex>,2> > wanted(noNeighbours);
+    for(size_type i=0; i < noNeighbours; ++i) {
+      isNew[i] = !sharedIndices_.count(procs[i]);
+      for(int set=0; set < noSets; ++set)
+        if(isNew[i]) {
+          const std::vector<GlobalIndex>& shared = sharers[procs[i]];
+          std::set_intersection(globals[set].begin(), globals[set].end(),
+                                shared.begin(), shared.end(),
+                                std::back_inserter(wanted[i][set]));
+        }else
+          wanted[i][set] = addedGlobals[set];
+    }
+
+    // Send our changes and the indices we want
+    std::vector<std::vector<char> > buffers(2*noNeighbours);
+    std::vector<MPI_Request> requests(2*noNeighbours);
+    for(size_type i=0; i < noNeighbours; ++i) {
+      int bufferSize=0, position=0;
+      for(int set=0; set < noSets; ++set)
+        bufferSize += packSize(removed[set]) + packSize(added[set]) + packSize(wanted[i][set]);
+      buffers[i].resize(bufferSize);
+      for(int set=0; set < noSets; ++set) {
+        pack(removed[set], buffers[i].data(), bufferSize, &position);
+        pack(added[set], buffers[i].data(), bufferSize, &position);
+        pack(wanted[i][set], buffers[i].data(), bufferSize, &position);
       }
+      MPI_Isend(buffers[i].data(), position, MPI_PACKED, procs[i], commTag_, comm_, &requests[i]);
+    }
 
-      //Test for received messages
+    // Receive the changes of our neighbours and answer with the indices they want
+    std::vector<SharedIndices> theirRemoved(noNeighbours), theirAdded(noNeighbours);
+    std::vector<char> inBuffer;
+    for(size_type i=0; i < noNeighbours; ++i) {
+      MPI_Status status;
+      int size;
+      MPI_Probe(procs[i], commTag_, comm_, &status);
+      MPI_Get_count(&status, MPI_PACKED, &size);
+      inBuffer.resize(size>0 ? size : 1);
+      MPI_Recv(inBuffer.data(), size, MPI_PACKED, procs[i], commTag_, comm_, &status);
+
+      SharedIndices answer;
+      int position=0;
+      for(int set=0; set < noSets; ++set) {
+        std::vector<GlobalIndex> theirWanted;
+        unpack(theirRemoved[i][set], inBuffer.data(), size, &position);
+        unpack(theirAdded[i][set], inBuffer.data(), size, &position);
+        unpack(theirWanted, inBuffer.data(), size, &position);
+
+        // Their index set is matched with our partner index set
+        const PublishedIndices& ours = published[partner(set)];
+        typename PublishedIndices::const_iterator index = ours.begin();
+        for(const GlobalIndex& global : theirWanted) {
+          index = std::lower_bound(index, ours.end(), global,
+                                   [](const PublishedIndex& index_, const GlobalIndex& global_) {
+                                     return index_.first < global_;
+                                   });
+          for(; index != ours.end() && index->first == global; ++index)
+            answer[set].push_back(*index);
+        }
+      }
 
-      for(size_type received=0; received <noNeighbours; ++received)
-      {
-        MPI_Status status;
-        // probe for next message
-        MPI_Probe(MPI_ANY_SOURCE, commTag_, comm_, &status);
-        int remoteProc=status.MPI_SOURCE;
-        int size;
-        MPI_Get_count(&status, MPI_PACKED, &size);
-        // receive message
-        MPI_Recv(buffer[1], size, MPI_PACKED, remoteProc,
-                 commTag_, comm_, &status);
-
-        unpackCreateRemote(buffer[1], sourcePairs, destPairs, remoteProc, sourcePublish,
-                           destPublish, bufferSize, sendTwo);
+      int bufferSize = 0;
+      position = 0;
+      for(int set=0; set < noSets; ++set)
+        bufferSize += packSize(answer[set]);
+      std::vector<char>& buffer = buffers[noNeighbours+i];
+      buffer.resize(bufferSize);
+      for(int set=0; set < noSets; ++set)
+        pack(answer[set], buffer.data(), bufferSize, &position);
+      MPI_Isend(buffer.data(), position, MPI_PACKED, procs[i], answerTag_, comm_,
+                &requests[noNeighbours+i]);
+    }
+
+    // Receive the answers and update the indices we share with each neighbour
+    for(size_type i=0; i < noNeighbours; ++i) {
+      MPI_Status status;
+      int size;
+      MPI_Probe(procs[i], answerTag_, comm_, &status);
+      MPI_Get_count(&status, MPI_PACKED, &size);
+      inBuffer.resize(size>0 ? size : 1);
+      MPI_Recv(inBuffer.data(), size, MPI_PACKED, procs[i], answerTag_, comm_, &status);
+
+      SharedIndices& shared = sharedIndices_[procs[i]];
+      int position=0;
+      for(int set=0; set < noSets; ++set) {
+        // The answer for our index set holds indices of their partner index set
+        const int theirSet = partner(set);
+        PublishedIndices& indices = shared[theirSet];
+        const std::vector<GlobalIndex>& ours = globals[set];
+        const std::vector<GlobalIndex>& asked = wanted[i][set];
+
+        // Forget the indices we do not know any more
+        indices.erase(std::remove_if(indices.begin(), indices.end(),
+                                     [&ours](const PublishedIndex& index) {
+                                       return !std::binary_search(ours.begin(), ours.end(), index.first);
+                                     }),
+                      indices.end());
+
+        if(!isNew[i]) {
+          // Apply their changes to the indices we knew before
+          PublishedIndices remaining;
+          std::set_difference(indices.begin(), indices.end(),
+                              theirRemoved[i][theirSet].begin(), theirRemoved[i][theirSet].end(),
+                              std::back_inserter(remaining));
+          indices.swap(remaining);
+          for(const PublishedIndex& index : theirAdded[i][theirSet])
+            if(std::binary_search(ours.begin(), ours.end(), index.first)
+               && !std::binary_search(asked.begin(), asked.end(), index.first))
+              indices.push_back(index);
+        }
+
+        PublishedIndices answer;
+        unpack(answer, inBuffer.data(), size, &position);
+        indices.insert(indices.end(), answer.begin(), answer.end());
+        std::sort(indices.begin(), indices.end());
       }
-      // wait for completion of pending requests
-      MPI_Status* statuses = new MPI_Status[neighbourIds.size()];
-
-      if(MPI_ERR_IN_STATUS==MPI_Waitall(neighbourIds.size(), requests, statuses)) {
-        for(size_type i=0; i < neighbourIds.size(); ++i)
-          if(statuses[i].MPI_ERROR!=MPI_SUCCESS) {
-            std::cerr<<rank<<": MPI_Error occurred while receiving message."<<std::endl;
-            MPI_Abort(comm_, 999);
-          }
+    }
+
+    if(MPI_ERR_IN_STATUS==MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE)) {
+      std::cerr<<rank<<": MPI_Error occurred while sending message."<<std::endl;
+      MPI_Abort(comm_, 999);
+    }
+
+    // Recreate the remote index lists for the new pairs
+    freeLists();
+
+    if(sendTwo || includeSelf)
+      createRemote(rank, published, pairs[0].data(), pairs[0].size(),
+                   pairs[1].data(), pairs[1].size(), includeSelf, 0);
+
+    for(const auto& shared : sharedIndices_)
+      createRemote(shared.first, shared.second, pairs[0].data(), pairs[0].size(),
+                   pairs[1].data(), pairs[1].size(), false, 0);
+
+    published_ = std::move(published);
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::updateDirectory(const std::vector<GlobalIndex>& removed,
+                                                  const std::vector<GlobalIndex>& added,
+                                                  FlatMap<int,std::vector<GlobalIndex> >& sharers)
+  {
+    int procs;
+    MPI_Comm_size(comm_, &procs);
+
+    auto directory = [this, procs](const GlobalIndex& global) {
+                       return directoryProcess(global, procs, Impl::IsHashable<GlobalIndex>());
+                     };
+
+    // Send the removed and then the added indices to their directory processes
+    std::vector<int> sendCounts(2*procs, 0), counts(procs), displs(procs+1, 0);
+    for(const GlobalIndex& global : removed)
+      ++sendCounts[2*directory(global)];
+    for(const GlobalIndex& global : added)
+      ++sendCounts[2*directory(global)+1];
+    for(int p=0; p < procs; ++p) {
+      counts[p] = sendCounts[2*p] + sendCounts[2*p+1];
+      displs[p+1] = displs[p] + counts[p];
+    }
+
+    std::vector<GlobalIndex> sendIndices(displs[procs]);
+    {
+      std::vector<int> removedOffsets(displs.begin(), displs.end()-1), addedOffsets(procs);
+      for(int p=0; p < procs; ++p)
+        addedOffsets[p] = displs[p] + sendCounts[2*p];
+      for(const GlobalIndex& global : removed)
+        sendIndices[removedOffsets[directory(global)]++] = global;
+      for(const GlobalIndex& global : added)
+        sendIndices[addedOffsets[directory(global)]++] = global;
+    }
+
+    std::vector<int> recvCounts(2*procs), rcounts(procs), rdispls(procs+1, 0);
+    MPI_Alltoall(sendCounts.data(), 2, MPI_INT, recvCounts.data(), 2, MPI_INT, comm_);
+    for(int p=0; p < procs; ++p) {
+      rcounts[p] = recvCounts[2*p] + recvCounts[2*p+1];
+      rdispls[p+1] = rdispls[p] + rcounts[p];
+    }
+
+    std::vector<GlobalIndex> recvIndices(rdispls[procs]);
+    MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+    MPI_Alltoallv(sendIndices.data(), counts.data(), displs.data(), type,
+                  recvIndices.data(), rcounts.data(), rdispls.data(), type, comm_);
+
+    // Update our part of the directory
+    typedef std::pair<GlobalIndex,int> Entry;
+    std::vector<Entry> removedEntries, addedEntries;
+    for(int p=0; p < procs; ++p) {
+      for(int i=rdispls[p]; i < rdispls[p]+recvCounts[2*p]; ++i)
+        removedEntries.push_back(Entry(recvIndices[i], p));
+      for(int i=rdispls[p]+recvCounts[2*p]; i < rdispls[p+1]; ++i)
+        addedEntries.push_back(Entry(recvIndices[i], p));
+    }
+    std::sort(removedEntries.begin(), removedEntries.end());
+    std::sort(addedEntries.begin(), addedEntries.end());
+
+    std::vector<Entry> remaining;
+    remaining.reserve(directory_.size());
+    std::set_difference(directory_.begin(), directory_.end(),
+                        removedEntries.begin(), removedEntries.end(),
+                        std::back_inserter(remaining));
+    directory_.clear();
+    std::merge(remaining.begin(), remaining.end(), addedEntries.begin(), addedEntries.end(),
+               std::back_inserter(directory_));
+
+    // Tell the processes publishing an added index about each other
+    std::vector<std::vector<std::pair<int,GlobalIndex> > > notes(procs);
+    for(const Entry& entry : addedEntries) {
+      typename std::vector<Entry>::const_iterator holder
+        = std::lower_bound(directory_.begin(), directory_.end(),
+                           Entry(entry.first, std::numeric_limits<int>::min()));
+      for(; holder != directory_.end() && holder->first == entry.first; ++holder)
+        if(holder->second != entry.second) {
+          notes[entry.second].push_back(std::make_pair(holder->second, entry.first));
+          notes[holder->second].push_back(std::make_pair(entry.second, entry.first));
+        }
+    }
+
+    std::vector<int> noteProcs;
+    std::vector<GlobalIndex> noteIndices;
+    for(int p=0; p < procs; ++p) {
+      counts[p] = notes[p].size();
+      displs[p+1] = displs[p] + counts[p];
+      for(const auto& note : notes[p]) {
+        noteProcs.push_back(note.first);
+        noteIndices.push_back(note.second);
       }
-      delete[] requests;
-      delete[] statuses;
     }
 
+    MPI_Alltoall(counts.data(), 1, MPI_INT, rcounts.data(), 1, MPI_INT, comm_);
+    for(int p=0; p < procs; ++p)
+      rdispls[p+1] = rdispls[p] + rcounts[p];
+
+    std::vector<int> recvProcs(rdispls[procs]);
+    recvIndices.resize(rdispls[procs]);
+    MPI_Alltoallv(noteProcs.data(), counts.data(), displs.data(), MPI_INT,
+                  recvProcs.data(), rcounts.data(), rdispls.data(), MPI_INT, comm_);
+    MPI_Alltoallv(noteIndices.data(), counts.data(), displs.data(), type,
+                  recvIndices.data(), rcounts.data(), rdispls.data(), type, comm_);
+
+    for(int i=0; i < rdispls[procs]; ++i)
+      sharers[recvProcs[i]].push_back(recvIndices[i]);
+    for(auto& sharer : sharers) {
+      std::sort(sharer.second.begin(), sharer.second.end());
+      sharer.second.erase(std::unique(sharer.second.begin(), sharer.second.end()),
+                          sharer.second.end());
+    }
+  }
 
-    // delete allocated memory
-    if(destPairs!=sourcePairs)
-      delete[] destPairs;
+  template<typename T, typename A>
+  template<bool ignorePublic>
+  inline void RemoteIndices<T,A>::collectPublished(const ParallelIndexSet& indexSet,
+                                                   std::vector<PairType*>& pairs,
+                                                   PublishedIndices& published)
+  {
+    typedef typename ParallelIndexSet::const_iterator const_iterator;
+    const const_iterator end = indexSet.end();
+    for(const_iterator index = indexSet.begin(); index != end; ++index)
+      if(ignorePublic || index->local().isPublic()) {
+        pairs.push_back(const_cast<PairType*>(&(*index)));
+        published.push_back(PublishedIndex(index->global(), index->local().attribute()));
+      }
+  }
 
-    delete[] sourcePairs;
-    delete[] buffer[0];
-    delete[] buffer[1];
-    delete[] buffer;
+  template<typename T, typename A>
+  inline int RemoteIndices<T,A>::packSize(const PublishedIndices& published)
+  {
+    int intSize, globalSize, charSize;
+    MPI_Pack_size(1, MPI_INT, comm_, &intSize);
+    MPI_Pack_size(published.size(), MPITraits<GlobalIndex>::getType(), comm_, &globalSize);
+    MPI_Pack_size(published.size(), MPI_CHAR, comm_, &charSize);
+    return intSize + globalSize + charSize;
+  }
+
+  template<typename T, typename A>
+  inline int RemoteIndices<T,A>::packSize(const std::vector<GlobalIndex>& globals)
+  {
+    int intSize, globalSize;
+    MPI_Pack_size(1, MPI_INT, comm_, &intSize);
+    MPI_Pack_size(globals.size(), MPITraits<GlobalIndex>::getType(), comm_, &globalSize);
+    return intSize + globalSize;
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::pack(const PublishedIndices& published, char* p_out,
+                                       int bufferSize, int* position)
+  {
+    MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+    int size = published.size();
+    MPI_Pack(&size, 1, MPI_INT, p_out, bufferSize, position, comm_);
+    for(const PublishedIndex& index : published) {
+      char attribute = static_cast<char>(index.second);
+      MPI_Pack(const_cast<GlobalIndex*>(&index.first), 1, type, p_out, bufferSize, position, comm_);
+      MPI_Pack(&attribute, 1, MPI_CHAR, p_out, bufferSize, position, comm_);
+    }
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::pack(const std::vector<GlobalIndex>& globals, char* p_out,
+                                       int bufferSize, int* position)
+  {
+    int size = globals.size();
+    MPI_Pack(&size, 1, MPI_INT, p_out, bufferSize, position, comm_);
+    MPI_Pack(const_cast<GlobalIndex*>(globals.data()), size, MPITraits<GlobalIndex>::getType(),
+             p_out, bufferSize, position, comm_);
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::unpack(PublishedIndices& published, char* p_in,
+                                         int bufferSize, int* position)
+  {
+    MPI_Datatype type = MPITraits<GlobalIndex>::getType();
+    int size;
+    MPI_Unpack(p_in, bufferSize, position, &size, 1, MPI_INT, comm_);
+    published.reserve(published.size()+size);
+    for(int i=0; i < size; ++i) {
+      GlobalIndex global;
+      char attribute;
+      MPI_Unpack(p_in, bufferSize, position, &global, 1, type, comm_);
+      MPI_Unpack(p_in, bufferSize, position, &attribute, 1, MPI_CHAR, comm_);
+      published.push_back(PublishedIndex(global, static_cast<Attribute>(attribute)));
+    }
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::unpack(std::vector<GlobalIndex>& globals, char* p_in,
+                                         int bufferSize, int* position)
+  {
+    int size;
+    MPI_Unpack(p_in, bufferSize, position, &size, 1, MPI_INT, comm_);
+    globals.resize(size);
+    MPI_Unpack(p_in, bufferSize, position, globals.data(), size,
+               MPITraits<GlobalIndex>::getType(), comm_);
   }
 
   template<typename T, typename A>
@@ -1433,6 +2224,19 @@ namespace Dune {
 
   template<typename T, typename A>
   inline void RemoteIndices<T,A>::free()
+  {
+    freeLists();
+    published_[0].clear();
+    published_[1].clear();
+    sharedIndices_.clear();
+    directory_.clear();
+    directorySplitters_.clear();
+    updatable_=false;
+    firstBuild=true;
+  }
+
+  template<typename T, typename A>
+  inline void RemoteIndices<T,A>::freeLists()
   {
     typedef typename RemoteIndexMap::iterator Iterator;
     Iterator lend = remoteIndices_.end();
@@ -1446,7 +2250,6 @@ namespace Dune {
       }
     }
     remoteIndices_.clear();
-    firstBuild=true;
   }
 
   template<typename T, typename A>
@@ -1463,9 +2266,29 @@ namespace Dune {
     if(firstBuild ||
        ignorePublic!=publicIgnored || !
        isSynced()) {
-      free();
+      // Only exchange the changes if all processes can do so
+      int update = 0;
+      if(!firstBuild && ignorePublic==publicIgnored) {
+        int canUpdate = updatable_ && useDirectory_==neighbourIds.empty();
+        if(canUpdate && !useDirectory_) {
+          // The neighbours have to be the same as during the last build
+          std::set<int> neighbours(neighbourIds);
+          int rank;
+          MPI_Comm_rank(comm_, &rank);
+          neighbours.erase(rank);
+          canUpdate = neighbours.size()==sharedIndices_.size();
+          for(std::set<int>::const_iterator n=neighbours.begin(); canUpdate && n!=neighbours.end(); ++n)
+            canUpdate = sharedIndices_.count(*n);
+        }
+        MPI_Allreduce(&canUpdate, &update, 1, MPI_INT, MPI_MIN, comm_);
+      }
 
-      buildRemote<ignorePublic>(includeSelf);
+      if(update)
+        updateRemote<ignorePublic>();
+      else{
+        free();
+        buildRemote<ignorePublic>(includeSelf);
+      }
 
       sourceSeqNo_ = source_->seqNo();
       destSeqNo_ = target_->seqNo();
@@ -1545,8 +2368,7 @@ namespace Dune {
     if(neighbours()!=ri.neighbours())
       return false;
 
-    typedef RemoteIndexList RList;
-    typedef typename std::map<int,std::pair<RList*,RList*> >::const_iterator const_iterator;
+    typedef typename RemoteIndexMap::const_iterator const_iterator;
 
     const const_iterator rend = remoteIndices_.end();
 
@@ -1858,7 +2680,7 @@ namespace Dune {
     MPI_Comm_rank(indices.comm_, &rank);
 
     typedef typename RemoteIndices<T,A>::RemoteIndexList RList;
-    typedef typename std::map<int,std::pair<RList*,RList*> >::const_iterator const_iterator;
+    typedef typename RemoteIndices<T,A>::RemoteIndexMap::const_iterator const_iterator;
 
     const const_iterator rend = indices.remoteIndices_.end();
 
@@ -4,14 +4,18 @@
 #include <config.h>
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <ostream>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/enumset.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
 #include <dune/common/parallel/communicator.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/interface.hh>
@@ -400,6 +404,636 @@ void testIndicesBuffered(MPI_Comm comm)
 }
 
 
+// set owned entries to their global index and all others to -1
+template<class IndexSet>
+void setOwnedToGlobal(Array& array, const IndexSet& indexSet)
+{
+  for(const auto& pair : indexSet)
+    array[pair.local()] = pair.local().attribute()==owner ? pair.global() : -1;
+}
+
+void testSplitPhaseBuffered(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet indexSet;
+  Array array, reference;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+  reference.build(indexSet.size());
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  Dune::BufferedCommunicator communicator;
+  communicator.build<Array>(interface);
+
+  // the forward communication fills the overlap with the owners' values
+  setOwnedToGlobal(array, indexSet);
+  communicator.startForward<ArrayGatherScatter>(array);
+  bool thrown = false;
+  try {
+    communicator.startForward<ArrayGatherScatter>(array);
+  }
+  catch(Dune::InvalidStateException&) {
+    thrown = true;
+  }
+  assert(thrown);
+  while(!communicator.test())
+    ;
+  communicator.finishForward();
+  for(const auto& pair : indexSet)
+    assert(array[pair.local()] == pair.global());
+
+  // the split backward communication has to match the blocking one
+  for(const auto& pair : indexSet) {
+    array[pair.local()] = pair.local().attribute()==owner ? -1 : pair.global() + 0.5;
+    reference[pair.local()] = array[pair.local()];
+  }
+  communicator.backward<ArrayGatherScatter>(reference);
+  communicator.startBackward<ArrayGatherScatter>(array);
+  communicator.finishBackward();
+  for(const auto& pair : indexSet)
+    assert(array[pair.local()] == reference[pair.local()]);
+
+  // a started communication is finished when freeing the communicator
+  setOwnedToGlobal(array, indexSet);
+  communicator.startForward<ArrayGatherScatter>(array, array);
+  communicator.free();
+  for(const auto& pair : indexSet)
+    assert(array[pair.local()] == pair.global());
+
+  // rebuilding sets up the communication again
+  communicator.build<Array>(interface);
+  communicator.build<Array>(interface);
+  for(int i=0; i<3; ++i) {
+    setOwnedToGlobal(array, indexSet);
+    communicator.forward<ArrayGatherScatter>(array);
+    for(const auto& pair : indexSet)
+      assert(array[pair.local()] == pair.global());
+  }
+  DUNE_UNUSED_PARAMETER(thrown);
+}
+
+// An interface whose receive lists can be shortened by one entry per
+// neighbour, such that the messages of the neighbours get truncated
+class TruncatedInterface : public Dune::Interface
+{
+public:
+  void truncateReceives()
+  {
+    for(auto& pair : interfaces()) {
+      Dune::InterfaceInformation& receive = pair.second.second;
+      if(receive.size() < 2)
+        continue;
+      std::vector<std::size_t> indices;
+      for(std::size_t i=0; i+1 < receive.size(); ++i)
+        indices.push_back(receive[i]);
+      receive.free();
+      receive.reserve(indices.size());
+      for(std::size_t index : indices)
+        receive.add(index);
+    }
+  }
+};
+
+void testErrorModes(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  Dune::BufferedCommunicator buffered;
+  buffered.build<Array>(interface);
+  Dune::DatatypeCommunicator<ParallelIndexSet> datatype;
+  datatype.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(), array,
+                 Dune::EnumItem<GridFlags,overlap>(), array);
+
+  assert(buffered.errorMode() == Dune::CommunicationErrorMode::local);
+  assert(datatype.errorMode() == Dune::CommunicationErrorMode::local);
+
+  for(auto mode : { Dune::CommunicationErrorMode::local, Dune::CommunicationErrorMode::collective }) {
+    buffered.setErrorMode(mode);
+    datatype.setErrorMode(mode);
+    assert(buffered.errorMode() == mode && datatype.errorMode() == mode);
+
+    setOwnedToGlobal(array, indexSet);
+    buffered.forward<ArrayGatherScatter>(array);
+    for(const auto& pair : indexSet)
+      assert(array[pair.local()] == pair.global());
+
+    setOwnedToGlobal(array, indexSet);
+    datatype.forward();
+    for(const auto& pair : indexSet)
+      assert(array[pair.local()] == pair.global());
+  }
+
+  if(procs < 2)
+    return;
+
+  // Truncate the messages received by rank 0. The communicator has to
+  // return MPI errors instead of handling them.
+  MPI_Comm errorComm;
+  MPI_Comm_dup(comm, &errorComm);
+  MPI_Comm_set_errhandler(errorComm, MPI_ERRORS_RETURN);
+  {
+    Dune::RemoteIndices<ParallelIndexSet> errorRemoteIndices(indexSet, indexSet, errorComm);
+    errorRemoteIndices.rebuild<false>();
+
+    TruncatedInterface truncated;
+    truncated.build(errorRemoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                    Dune::EnumItem<GridFlags,overlap>());
+    if(rank == 0)
+      truncated.truncateReceives();
+
+    for(auto mode : { Dune::CommunicationErrorMode::local, Dune::CommunicationErrorMode::collective }) {
+      // a request that failed cannot be started again, thus build anew
+      Dune::BufferedCommunicator failing;
+      failing.build<Array>(truncated);
+      failing.setErrorMode(mode);
+      bool thrown = false;
+      try{
+        failing.forward<ArrayGatherScatter>(array);
+      }catch(const Dune::CommunicationError&) {
+        thrown = true;
+      }
+      if(mode == Dune::CommunicationErrorMode::local)
+        assert(thrown == (rank == 0));
+      else
+        assert(thrown);
+    }
+  }
+  MPI_Comm_free(&errorComm);
+}
+
+void testSendModes(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  for(auto mode : { Dune::CommunicationSendMode::standard,
+                    Dune::CommunicationSendMode::synchronous,
+                    Dune::CommunicationSendMode::ready }) {
+    Dune::BufferedCommunicator buffered;
+    assert(buffered.sendMode() == Dune::CommunicationSendMode::standard);
+    buffered.setSendMode(mode);
+    assert(buffered.sendMode() == mode);
+    buffered.build<Array>(interface);
+
+    Dune::DatatypeCommunicator<ParallelIndexSet> datatype;
+    assert(datatype.sendMode() == Dune::CommunicationSendMode::standard);
+    datatype.setSendMode(mode);
+    assert(datatype.sendMode() == mode);
+    datatype.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(), array,
+                   Dune::EnumItem<GridFlags,overlap>(), array);
+
+    for(int i=0; i<3; ++i) {
+      setOwnedToGlobal(array, indexSet);
+      buffered.forward<ArrayGatherScatter>(array);
+      for(const auto& pair : indexSet)
+        assert(array[pair.local()] == pair.global());
+
+      setOwnedToGlobal(array, indexSet);
+      buffered.startForward<ArrayGatherScatter>(array);
+      while(!buffered.test())
+        ;
+      for(const auto& pair : indexSet)
+        assert(array[pair.local()] == pair.global());
+
+      setOwnedToGlobal(array, indexSet);
+      datatype.forward();
+      for(const auto& pair : indexSet)
+        assert(array[pair.local()] == pair.global());
+
+      // send the overlap back to the owners
+      for(const auto& pair : indexSet)
+        array[pair.local()] = pair.local().attribute()==owner ? -1 : pair.global();
+      buffered.backward<ArrayGatherScatter>(array);
+      datatype.backward();
+      for(const auto& pair : indexSet)
+        assert(array[pair.local()] == -1 || array[pair.local()] == pair.global());
+    }
+  }
+}
+
+void testBufferModes(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<Dune::FieldVector<double,3> > Vector;
+  typedef Dune::CopyGatherScatter<Vector> GatherScatter;
+
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  Vector initial(indexSet.size());
+  for(const auto& pair : indexSet)
+    for(int k=0; k<3; ++k)
+      initial[pair.local()][k] = pair.local().attribute()==owner ? pair.global()/3.0 + k : -1.0/(k+1);
+
+  // run a sequence of exchanges, partly on different data
+  auto exchange = [&](Dune::BufferedCommunicator& communicator, Vector& first, Vector& second)
+  {
+    first = second = initial;
+    communicator.forward<GatherScatter>(first);
+    communicator.forward<GatherScatter>(initial, second);
+    for(auto& v : second)
+      v *= 2;
+    communicator.backward<GatherScatter>(second, first);
+    communicator.startForward<GatherScatter>(second);
+    while(!communicator.test())
+      ;
+    communicator.forward<GatherScatter>(first);
+  };
+
+  Dune::BufferedCommunicator reference;
+  assert(reference.bufferMode() == Dune::CommunicationBufferMode::automatic);
+  reference.setBufferMode(Dune::CommunicationBufferMode::buffered);
+  reference.build<Vector>(interface);
+  assert(!reference.direct());
+  Vector first, second;
+  exchange(reference, first, second);
+
+  for(auto backend : { Dune::CommunicationBackend::pointToPoint, Dune::CommunicationBackend::neighborhood,
+                        Dune::CommunicationBackend::sharedMemory })
+    for(auto sendMode : { Dune::CommunicationSendMode::standard, Dune::CommunicationSendMode::ready })
+      for(auto mode : { Dune::CommunicationBufferMode::buffered, Dune::CommunicationBufferMode::automatic,
+                        Dune::CommunicationBufferMode::direct }) {
+        Dune::BufferedCommunicator communicator;
+        assert(communicator.backend() == Dune::CommunicationBackend::pointToPoint);
+        communicator.setBackend(backend);
+        assert(communicator.backend() == backend);
+        communicator.setSendMode(sendMode);
+        communicator.setBufferMode(mode);
+        assert(communicator.bufferMode() == mode);
+        communicator.build(initial, initial, interface);
+        if(backend == Dune::CommunicationBackend::sharedMemory)
+          assert(!communicator.direct());
+        else
+          assert(communicator.direct() == (mode == Dune::CommunicationBufferMode::direct)
+                 || mode == Dune::CommunicationBufferMode::automatic);
+
+        Vector firstResult, secondResult;
+        for(int i=0; i<2; ++i) {
+          exchange(communicator, firstResult, secondResult);
+          // the results have to be identical to the buffered exchange
+          assert(std::memcmp(firstResult.data(), first.data(), first.size()*sizeof(first[0])) == 0);
+          assert(std::memcmp(secondResult.data(), second.data(), second.size()*sizeof(second[0])) == 0);
+        }
+      }
+
+  // data that is not contiguous is always copied through the buffers
+  for(auto backend : { Dune::CommunicationBackend::pointToPoint, Dune::CommunicationBackend::neighborhood,
+                        Dune::CommunicationBackend::sharedMemory }) {
+    Dune::BufferedCommunicator communicator;
+    communicator.setBackend(backend);
+    communicator.setBufferMode(Dune::CommunicationBufferMode::direct);
+    communicator.build<Array>(interface);
+    assert(!communicator.direct());
+    setOwnedToGlobal(array, indexSet);
+    communicator.forward<ArrayGatherScatter>(array);
+    for(const auto& pair : indexSet)
+      assert(array[pair.local()] == pair.global());
+  }
+}
+
+void testInPlaceDirect(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<Dune::FieldVector<double,3> > Vector;
+  typedef Dune::CopyGatherScatter<Vector> GatherScatter;
+
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  // every index shared with a neighbour is both sent and received
+  Dune::Combine<Dune::EnumItem<GridFlags,owner>,Dune::EnumItem<GridFlags,overlap>,GridFlags> flags;
+  Dune::Interface interface;
+  interface.build(remoteIndices, flags, flags);
+
+  Vector initial(indexSet.size());
+  for(const auto& pair : indexSet)
+    for(int k=0; k<3; ++k)
+      initial[pair.local()][k] = pair.global() + 1000*rank + k;
+
+  Dune::BufferedCommunicator reference;
+  reference.setBufferMode(Dune::CommunicationBufferMode::buffered);
+  reference.build<Vector>(interface);
+  Vector expected = initial;
+  reference.forward<GatherScatter>(expected);
+  reference.backward<GatherScatter>(expected);
+
+  for(auto backend : { Dune::CommunicationBackend::pointToPoint, Dune::CommunicationBackend::neighborhood }) {
+    Dune::BufferedCommunicator communicator;
+    communicator.setBackend(backend);
+    communicator.setBufferMode(Dune::CommunicationBufferMode::direct);
+    communicator.build(initial, initial, interface);
+    assert(communicator.direct());
+
+    // the in-place exchange has to copy through the buffers
+    Vector data = initial;
+    communicator.forward<GatherScatter>(data);
+    communicator.backward<GatherScatter>(data);
+    assert(std::memcmp(data.data(), expected.data(), data.size()*sizeof(data[0])) == 0);
+
+    // while separate source and destination are still sent directly
+    Vector dest = initial;
+    communicator.forward<GatherScatter>(initial, dest);
+    data = initial;
+    reference.forward<GatherScatter>(data);
+    assert(std::memcmp(dest.data(), data.data(), dest.size()*sizeof(dest[0])) == 0);
+  }
+}
+
+void testSharedMemoryNodes(MPI_Comm comm)
+{
+  const int Nx = 32;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<Dune::FieldVector<double,3> > Vector;
+  typedef Dune::CopyGatherScatter<Vector> GatherScatter;
+
+  ParallelIndexSet indexSet;
+  Array array;
+  setupDistributed<Nx,Ny>(array, indexSet, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  Vector initial(indexSet.size());
+  for(const auto& pair : indexSet)
+    for(int k=0; k<3; ++k)
+      initial[pair.local()][k] = pair.local().attribute()==owner ? pair.global() + 1000*rank + k : -1.0;
+
+  Dune::BufferedCommunicator reference;
+  reference.build<Vector>(interface);
+  Vector forward = initial, backward = initial;
+  reference.forward<GatherScatter>(forward);
+  reference.backward<GatherScatter>(backward);
+
+  // pretend that pairs of processes form a node, so that neighbours
+  // are reached both through shared memory and point to point
+  for(auto sendMode : { Dune::CommunicationSendMode::standard, Dune::CommunicationSendMode::ready }) {
+    Dune::BufferedCommunicator communicator;
+    communicator.setBackend(Dune::CommunicationBackend::sharedMemory);
+    communicator.setSendMode(sendMode);
+    assert(communicator.sharedMemoryColor() == 0);
+    communicator.setSharedMemoryColor(rank/2);
+    assert(communicator.sharedMemoryColor() == rank/2);
+    communicator.build<Vector>(interface);
+
+    for(int i=0; i<3; ++i) {
+      Vector data = initial;
+      communicator.startForward<GatherScatter>(data);
+      while(!communicator.test())
+        ;
+      assert(std::memcmp(data.data(), forward.data(), data.size()*sizeof(data[0])) == 0);
+      data = initial;
+      communicator.backward<GatherScatter>(data);
+      assert(std::memcmp(data.data(), backward.data(), data.size()*sizeof(data[0])) == 0);
+    }
+  }
+}
+
+void testNeighbourDiscovery(MPI_Comm comm)
+{
+  const int n = 5;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef Dune::ParallelLocalIndex<GridFlags> LocalIndex;
+
+  // Overlapping blocks, an index known everywhere and a private index
+  // that every process knows but nobody publishes
+  ParallelIndexSet source, destination;
+  source.beginResize();
+  source.add(-2, LocalIndex(0, owner, false));
+  source.add(-1, LocalIndex(1, overlap, true));
+  for(int i=0; i < n+1; ++i)
+    source.add(rank*n+i, LocalIndex(i+2, i<n ? owner : overlap, i==0 || i>=n-1));
+  source.endResize();
+
+  // The destination is shifted by one process
+  destination.beginResize();
+  int shifted = (rank+1)%procs;
+  for(int i=0; i < n; ++i)
+    destination.add(shifted*n+i, LocalIndex(i, owner, true));
+  destination.endResize();
+
+  std::vector<int> everybody;
+  for(int p=0; p < procs; ++p)
+    everybody.push_back(p);
+
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+
+  RemoteIndices discovered(source, source, comm);
+  RemoteIndices reference(source, source, comm, everybody);
+  discovered.rebuild<false>();
+  reference.rebuild<false>();
+  assert(discovered==reference);
+  assert(discovered.neighbours() == procs-1);
+  assert(discovered.getNeighbours().empty());
+
+  discovered.rebuild<true>();
+  reference.rebuild<true>();
+  assert(discovered==reference);
+
+  RemoteIndices discoveredTwo(source, destination, comm);
+  RemoteIndices referenceTwo(source, destination, comm, everybody);
+  discoveredTwo.rebuild<false>();
+  referenceTwo.rebuild<false>();
+  assert(discoveredTwo==referenceTwo);
+}
+
+template<class IndexSet>
+void adaptIndexSet(IndexSet& indexSet, std::mt19937& rng, int noGlobals, int noChanges)
+{
+  typedef typename IndexSet::LocalIndex LocalIndex;
+  std::uniform_int_distribution<int> global(0, noGlobals-1), attribute(0, 2), coin(0, 1);
+  std::uniform_int_distribution<int> pick(0, indexSet.size()>0 ? indexSet.size()-1 : 0);
+
+  indexSet.beginResize();
+  if(indexSet.size()>0)
+    for(int i=0; i < noChanges; ++i) {
+      auto index = indexSet.begin();
+      for(int n=pick(rng); n>0; --n)
+        ++index;
+      if(index->local().state()!=Dune::DELETED)
+        indexSet.markAsDeleted(index);
+    }
+  for(int i=0; i < noChanges; ++i)
+    indexSet.add(global(rng), LocalIndex(indexSet.size()+i, GridFlags(attribute(rng)), coin(rng)));
+  indexSet.endResize();
+}
+
+// A global index that is ordered but has no Dune::hash
+struct OrderedIndex
+{
+  OrderedIndex(int v=0)
+    : value(v)
+  {}
+
+  bool operator<(const OrderedIndex& other) const
+  {
+    return value < other.value;
+  }
+
+  bool operator==(const OrderedIndex& other) const
+  {
+    return value == other.value;
+  }
+
+  int value;
+};
+
+std::ostream& operator<<(std::ostream& os, const OrderedIndex& index)
+{
+  return os<<index.value;
+}
+
+namespace Dune
+{
+  template<>
+  struct MPITraits<OrderedIndex>
+  {
+    static MPI_Datatype getType()
+    {
+      return MPI_INT;
+    }
+  };
+}
+
+template<class GlobalIndex>
+void testIncrementalUpdate(MPI_Comm comm)
+{
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef Dune::ParallelIndexSet<GlobalIndex,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef Dune::RemoteIndices<ParallelIndexSet> RemoteIndices;
+
+  // Processes randomly share global indices, some of them even twice
+  const int noGlobals = 200*procs;
+  std::mt19937 rng(rank);
+  ParallelIndexSet source, destination;
+  adaptIndexSet(source, rng, noGlobals, 40);
+  adaptIndexSet(destination, rng, noGlobals, 40);
+
+  std::vector<int> everybody;
+  for(int p=0; p < procs; ++p)
+    everybody.push_back(p);
+
+  RemoteIndices discovered(source, source, comm);
+  RemoteIndices given(source, source, comm, everybody);
+  RemoteIndices discoveredTwo(source, destination, comm);
+  RemoteIndices givenTwo(source, destination, comm, everybody);
+  discoveredTwo.setIncludeSelf(true);
+
+  for(int step=0; step < 6; ++step) {
+    discovered.template rebuild<false>();
+    given.template rebuild<false>();
+    discoveredTwo.template rebuild<false>();
+    givenTwo.template rebuild<true>();
+
+    RemoteIndices reference(source, source, comm);
+    RemoteIndices referenceTwo(source, destination, comm);
+    RemoteIndices referenceTwoPublic(source, destination, comm);
+    referenceTwo.setIncludeSelf(true);
+    reference.template rebuild<false>();
+    referenceTwo.template rebuild<false>();
+    referenceTwoPublic.template rebuild<true>();
+
+    assert(discovered==reference);
+    assert(given==reference);
+    assert(discoveredTwo==referenceTwo);
+    assert(givenTwo==referenceTwoPublic);
+
+    adaptIndexSet(source, rng, noGlobals, 5);
+    adaptIndexSet(destination, rng, noGlobals, 5);
+  }
+}
+
 void testRedistributeIndices(MPI_Comm comm)
 {
   using namespace Dune;
@@ -716,6 +1350,34 @@ int main(int argc, char **argv)
 
   //  testRedistributeIndices(comm);
   testRedistributeIndicesBuffered(comm);
+  MPI_Barrier(comm);
+
+  testSplitPhaseBuffered(comm);
+  MPI_Barrier(comm);
+
+  testErrorModes(comm);
+  MPI_Barrier(comm);
+
+  testSendModes(comm);
+  MPI_Barrier(comm);
+
+  testBufferModes(comm);
+  MPI_Barrier(comm);
+
+  testInPlaceDirect(comm);
+  MPI_Barrier(comm);
+
+  testSharedMemoryNodes(comm);
+  MPI_Barrier(comm);
+
+  testNeighbourDiscovery(comm);
+  MPI_Barrier(comm);
+
+  testIncrementalUpdate<int>(comm);
+  MPI_Barrier(comm);
+
+  // Without Dune::hash the directory is split into blocks of global indices
+  testIncrementalUpdate<OrderedIndex>(comm);
   MPI_Comm_free(&comm);
   MPI_Finalize();
 
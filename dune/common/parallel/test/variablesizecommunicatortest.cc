@@ -120,6 +120,15 @@ int main(int argc, char** argv)
         comm.forward(vhandle);
         std::cout<<"===================== backward ========================="<<std::endl;
         comm.backward(vhandle);
+        std::cout<<"================== adaptive buffers ===================="<<std::endl;
+        Dune::VariableSizeCommunicator<> acomm(MPI_COMM_SELF, inf);
+        acomm.forward(handle);
+        std::cout<<"===================== backward ========================="<<std::endl;
+        acomm.backward(handle);
+        std::cout<<"================== variable size ======================="<<std::endl;
+        acomm.forward(vhandle);
+        std::cout<<"===================== backward ========================="<<std::endl;
+        acomm.backward(vhandle);
     }
     else
     {
@@ -192,6 +201,20 @@ int main(int argc, char** argv)
         if(rank==0)
             std::cout<<"===================== backward ========================="<<std::endl;
         comm.backward(vhandle);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"================== adaptive buffers ===================="<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        Dune::VariableSizeCommunicator<> acomm(MPI_COMM_WORLD, inf);
+        acomm.forward(handle);
+        acomm.backward(handle);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"================== variable size ======================="<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        acomm.forward(vhandle);
+        acomm.backward(vhandle);
     }
 
     MPI_Finalize();
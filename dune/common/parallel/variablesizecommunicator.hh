@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <memory>
@@ -93,6 +94,15 @@ public:
     position_=0;
   }
 
+  /**
+   * @brief Skip items without reading or writing them.
+   * @param noItems The number of items to skip, e.g. a header.
+   */
+  void skip(std::size_t noItems)
+  {
+    position_+=noItems;
+  }
+
   /**
    * @brief Test whether the whole buffer was read.
    * @return True if we read or wrot until the end of the buffer.
@@ -281,6 +291,17 @@ private:
  *
  * In contrast to BufferedCommunicator the amount of data is determined by the container
  * whose entries are sent and not known at the receiving side a priori.
+ *
+ * By default the buffers are sized adaptively: all data for a neighbour is
+ * aggregated into one message that is sized to fit exactly. For variable sized
+ * data this message starts with the number of data items per index, so no
+ * separate exchange of the sizes is needed. The receiving side learns the
+ * length of the message by probing.
+ *
+ * If a maximum buffer size is given, the memory used for the buffers is bounded.
+ * Then the sizes and the data are sent separately and big messages are split
+ * into several rounds of messages that fit into the buffers. All processes have
+ * to use the same kind of buffers.
  */
 template<class Allocator=std::allocator<std::pair<InterfaceInformation,InterfaceInformation> > >
 class VariableSizeCommunicator
@@ -296,22 +317,22 @@ public:
 
 #ifndef DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE
   /**
-   * @brief Creates a communicator with the default maximum buffer size.
+   * @brief Creates a communicator with adaptively sized buffers.
    *
-   * The default size ist either what the macro DUNE_MAX_COMMUNICATION_BUFFER_SIZE
-   * is set to or 32768 if is not set.
+   * If the macro DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE is set, the
+   * buffer size is bounded by its value instead.
    */
   VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf)
-    : maxBufferSize_(32768), interface_(&inf)
+    : maxBufferSize_(0), interface_(&inf)
   {
     MPI_Comm_dup(comm, &communicator_);
   }
   /**
-   * @brief Creates a communicator with the default maximum buffer size.
+   * @brief Creates a communicator with adaptively sized buffers.
    * @param inf The communication interface.
    */
   VariableSizeCommunicator(const Interface& inf)
-  : maxBufferSize_(32768), interface_(&inf.interfaces())
+  : maxBufferSize_(0), interface_(&inf.interfaces())
   {
     MPI_Comm_dup(inf.communicator(), &communicator_);
   }
@@ -319,8 +340,8 @@ public:
   /**
    * @brief Creates a communicator with the default maximum buffer size.
    *
-   * The default size ist either what the macro DUNE_MAX_COMMUNICATION_BUFFER_SIZE
-   * is set to or 32768 if is not set.
+   * The default size is what the macro DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE
+   * is set to.
    */
   VariableSizeCommunicator(MPI_Comm comm, InterfaceMap& inf)
     : maxBufferSize_(DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE),
@@ -343,7 +364,8 @@ public:
   * @brief Creates a communicator with a specific maximum buffer size.
   * @param comm The MPI communicator to use.
   * @param inf The communication interface.
-  * @param max_buffer_size The maximum buffer size allowed.
+  * @param max_buffer_size The maximum buffer size allowed. Zero selects
+  * adaptively sized buffers.
   */
   VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf, std::size_t max_buffer_size)
     : maxBufferSize_(max_buffer_size), interface_(&inf)
@@ -354,7 +376,8 @@ public:
   /**
   * @brief Creates a communicator with a specific maximum buffer size.
   * @param inf The communication interface.
-  * @param max_buffer_size The maximum buffer size allowed.
+  * @param max_buffer_size The maximum buffer size allowed. Zero selects
+  * adaptively sized buffers.
   */
   VariableSizeCommunicator(const Interface& inf, std::size_t max_buffer_size)
     : maxBufferSize_(max_buffer_size), interface_(&inf.interfaces())
@@ -462,9 +485,23 @@ private:
    */
   template<bool FORWARD, class DataHandle>
   void communicateVariableSize(DataHandle& handle);
+  /**
+   * @brief Communicate all data for a neighbour in one message of exactly fitting size.
+   *
+   * For variable sized data the message starts with the sizes of the entries.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @tparam DataHandle DataHandle The type of the data handle.
+   * @param handle The handle describing the data and responsible for gather
+   * and scatter operations.
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicateAggregated(DataHandle& handle);
   /**
    * @brief The maximum size if the buffers used for gather and scatter.
    *
+   * Zero means that the buffers are sized adaptively to hold the whole
+   * message for a neighbour.
+   *
    * @note If this process has n neighbours, then a maximum of 2n buffers of this size
    * is allocate. Memory needed will be n*sizeof(std::size_t)+n*sizeof(Datahandle::DataType)
    */
@@ -826,6 +863,8 @@ struct NullPackUnpackFunctor
  * be the same as requests.
  * @param comm The MPI communicator to use.
  * @param buffer_func The functor that does the packing or unpacking of the data.
+ * @param wait If true, block until at least one of the requests finished
+ * instead of only testing them.
  */
 template<class DataHandle, class BufferFunctor, class CommunicationFunctor>
 std::size_t checkAndContinue(DataHandle& handle,
@@ -837,14 +876,21 @@ std::size_t checkAndContinue(DataHandle& handle,
                              BufferFunctor buffer_func,
                              CommunicationFunctor comm_func,
                              bool valid=true,
-                             bool getCount=false)
+                             bool getCount=false,
+                             bool wait=false)
 {
   std::size_t size=requests.size();
   std::vector<MPI_Status> statuses(size);
   int no_completed;
   std::vector<int> indices(size, -1); // the indices for which the communication finished.
 
-  MPI_Testsome(size, &(requests[0]), &no_completed, &(indices[0]), &(statuses[0]));
+  if(wait)
+    MPI_Waitsome(size, &(requests[0]), &no_completed, &(indices[0]), &(statuses[0]));
+  else
+    MPI_Testsome(size, &(requests[0]), &no_completed, &(indices[0]), &(statuses[0]));
+  if(no_completed==MPI_UNDEFINED)
+    // There are no active requests.
+    return 0;
   indices.resize(no_completed);
   for(std::vector<int>::iterator index=indices.begin(), end=indices.end();
       index!=end; ++index)
@@ -868,7 +914,9 @@ std::size_t checkAndContinue(DataHandle& handle,
       comm_func(handle, tracker, buffers[*index], requests2[*index], comm);
       tracker.skipZeroIndices();
       if(valid)
-      no_completed-=!tracker.finished(); // communication not finished, decrement counter for finished ones.
+        // Another communication was started (a send tracker might already be finished
+        // with it), decrement counter for finished ones.
+        no_completed-=(requests2[*index]!=MPI_REQUEST_NULL);
     }
   }
   return no_completed;
@@ -903,16 +951,19 @@ std::size_t receiveSizeAndSetupReceive(DataHandle& handle,
  * @param requests The requests for the asynchronous communication.
  * @param buffers The buffers to use for sending.
  * @param comm The mpi communicator to use.
+ * @param wait If true, block until at least one request finished.
  */
 template<class DataHandle>
 std::size_t checkSendAndContinueSending(DataHandle& handle,
                                         std::vector<InterfaceTracker>& trackers,
                                         std::vector<MPI_Request>& requests,
                                         std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                                        MPI_Comm comm)
+                                        MPI_Comm comm,
+                                        bool wait=false)
 {
   return checkAndContinue(handle, trackers, requests, requests, buffers, comm,
-                          NullPackUnpackFunctor<DataHandle>(), SetupSendRequest<DataHandle>());
+                          NullPackUnpackFunctor<DataHandle>(), SetupSendRequest<DataHandle>(),
+                          true, false, wait);
 }
 
 /**
@@ -922,17 +973,19 @@ std::size_t checkSendAndContinueSending(DataHandle& handle,
  * @param requests The requests for the asynchronous communication.
  * @param buffers The buffers to use for receiving.
  * @param comm The mpi communicator to use.
+ * @param wait If true, block until at least one request finished.
  */
 template<class DataHandle>
 std::size_t checkReceiveAndContinueReceiving(DataHandle& handle,
                                              std::vector<InterfaceTracker>& trackers,
                                              std::vector<MPI_Request>& requests,
                                              std::vector<MessageBuffer<typename DataHandle::DataType> >& buffers,
-                                             MPI_Comm comm)
+                                             MPI_Comm comm,
+                                             bool wait=false)
 {
   return checkAndContinue(handle, trackers, requests, requests, buffers, comm,
                           UnpackEntries<DataHandle>(), SetupRecvRequest<DataHandle>(),
-                          true, !handle.fixedsize());
+                          true, !handle.fixedsize(), wait);
 }
 
 
@@ -954,6 +1007,7 @@ bool validRecvRequests(const std::vector<MPI_Request> reqs)
  * @param buffers The buffers for the comunication. One for each neighbour.
  * @param requests The send requests for each neighbour.
  * @param setupFunctor The functor responsible for setting up the request.
+ * @return The number of interfaces for which no request was set up.
  */
 template<class DataHandle, class Functor>
 std::size_t setupRequests(DataHandle& handle,
@@ -971,10 +1025,128 @@ std::size_t setupRequests(DataHandle& handle,
   for(TIter titer=trackers.begin(), end=trackers.end(); titer!=end; ++titer, ++biter, ++riter)
   {
     setupFunctor(handle, *titer, *biter, *riter, communicator);
-    complete+=titer->finished();
+    // Interfaces with a pending request are completed by checkAndContinue.
+    complete+=(*riter==MPI_REQUEST_NULL);
   }
   return complete;
 }
+
+/**
+ * @brief The tag of the aggregated messages.
+ */
+const int aggregatedMessageTag=933400;
+
+/**
+ * @brief Get the number of data items occupied by the sizes at the start
+ * of an aggregated message.
+ * @param handle The data handle describing the data.
+ * @param noIndices The number of indices in the message.
+ */
+template<class DataHandle>
+std::size_t aggregatedHeaderSize(DataHandle& handle, std::size_t noIndices)
+{
+  typedef typename DataHandle::DataType DataType;
+  if(handle.fixedsize())
+    return 0;
+  return (noIndices*sizeof(std::size_t)+sizeof(DataType)-1)/sizeof(DataType);
+}
+
+/**
+ * @brief Get the MPI datatype of one unit of an aggregated message.
+ *
+ * Messages with a header of sizes are sent as bytes.
+ */
+template<class DataHandle>
+MPI_Datatype aggregatedType(DataHandle& handle)
+{
+  if(handle.fixedsize())
+    return MPITraits<typename DataHandle::DataType>::getType();
+  return MPI_BYTE;
+}
+
+/**
+ * @brief Get the number of units of an aggregated message.
+ * @param handle The data handle describing the data.
+ * @param items The number of data items in the message.
+ */
+template<class DataHandle>
+std::size_t aggregatedCount(DataHandle& handle, std::size_t items)
+{
+  return handle.fixedsize() ? items : items*sizeof(typename DataHandle::DataType);
+}
+
+/**
+ * @brief Gathers the data of all indices of an interface into one buffer.
+ * @param handle The data handle describing the data.
+ * @param info The local indices to gather the data from.
+ * @return The buffer holding the message.
+ */
+template<class DataHandle>
+std::unique_ptr<MessageBuffer<typename DataHandle::DataType> >
+packAggregated(DataHandle& handle, const InterfaceInformation& info)
+{
+  typedef typename DataHandle::DataType DataType;
+  std::size_t header=aggregatedHeaderSize(handle, info.size());
+  std::size_t items=header;
+  for(std::size_t i=0; i<info.size(); ++i)
+    items+=handle.size(info[i]);
+
+  std::unique_ptr<MessageBuffer<DataType> > buffer(new MessageBuffer<DataType>(items));
+  if(header)
+  {
+    char* sizes=reinterpret_cast<char*>(static_cast<DataType*>(*buffer));
+    for(std::size_t i=0; i<info.size(); ++i)
+    {
+      std::size_t size=handle.size(info[i]);
+      std::memcpy(sizes+i*sizeof(std::size_t), &size, sizeof(std::size_t));
+    }
+    buffer->skip(header);
+  }
+  for(std::size_t i=0; i<info.size(); ++i)
+    handle.gather(*buffer, info[i]);
+  assert(buffer->finished());
+  return buffer;
+}
+
+/**
+ * @brief Receives a probed aggregated message and scatters its data.
+ * @param handle The data handle describing the data.
+ * @param info The local indices to scatter the data to.
+ * @param status The status of the probed message.
+ * @param comm The mpi communicator to use.
+ */
+template<class DataHandle>
+void receiveAggregated(DataHandle& handle, const InterfaceInformation& info,
+                       MPI_Status& status, MPI_Comm comm)
+{
+  typedef typename DataHandle::DataType DataType;
+  int count;
+  MPI_Get_count(&status, aggregatedType(handle), &count);
+  std::size_t items=handle.fixedsize() ? count : count/sizeof(DataType);
+  MessageBuffer<DataType> buffer(items);
+  MPI_Recv(buffer, count, aggregatedType(handle), status.MPI_SOURCE,
+           aggregatedMessageTag, comm, MPI_STATUS_IGNORE);
+
+  if(handle.fixedsize())
+  {
+    std::size_t fixedSize=items/info.size();
+    for(std::size_t i=0; i<info.size(); ++i)
+      handle.scatter(buffer, info[i], fixedSize);
+  }
+  else
+  {
+    const char* sizes=reinterpret_cast<const char*>(static_cast<DataType*>(buffer));
+    buffer.skip(aggregatedHeaderSize(handle, info.size()));
+    for(std::size_t i=0; i<info.size(); ++i)
+    {
+      std::size_t size;
+      std::memcpy(&size, sizes+i*sizeof(std::size_t), sizeof(std::size_t));
+      if(size)
+        handle.scatter(buffer, info[i], size);
+    }
+  }
+  assert(buffer.finished());
+}
 } // end unnamed namespace
 
 template<class Allocator>
@@ -1052,11 +1224,13 @@ void VariableSizeCommunicator<Allocator>::communicateFixedSize(DataHandle& handl
     // Check send completion and initiate other necessary sends
     if(no_to_send)
       no_to_send -= checkSendAndContinueSending(handle, send_trackers, data_send_req,
-                                              send_buffers, communicator_);
+                                              send_buffers, communicator_,
+                                              !(no_size_to_recv+no_to_recv));
     if(validRecvRequests(data_recv_req))
       // Receive data and setup new unblocking receives if necessary
       no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, data_recv_req,
-                                                     recv_buffers, communicator_);
+                                                     recv_buffers, communicator_,
+                                                     !(no_size_to_recv+no_to_send));
   }
 
   // Wait for completion of sending the size.
@@ -1073,8 +1247,8 @@ void VariableSizeCommunicator<Allocator>::communicateSizes(DataHandle& handle,
   std::vector<InterfaceTracker> send_trackers;
   std::vector<InterfaceTracker> recv_trackers;
   std::size_t size = interface_->size();
-  std::vector<MPI_Request> send_requests(size);
-  std::vector<MPI_Request> recv_requests(size);
+  std::vector<MPI_Request> send_requests(size, MPI_REQUEST_NULL);
+  std::vector<MPI_Request> recv_requests(size, MPI_REQUEST_NULL);
   std::vector<MessageBuffer<std::size_t> >
     send_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_)),
     recv_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_));
@@ -1099,7 +1273,7 @@ void VariableSizeCommunicator<Allocator>::communicateSizes(DataHandle& handle,
     if(size_to_send)
       size_to_send -=
         checkSendAndContinueSending(size_handle, send_trackers, send_requests,
-                                    send_buffers, communicator_);
+                                    send_buffers, communicator_, !size_to_recv);
     if(size_to_recv)
       // Could have done this using checkSendAndContinueSending
       // But the call below is more efficient as UnpackSizeEntries
@@ -1107,7 +1281,8 @@ void VariableSizeCommunicator<Allocator>::communicateSizes(DataHandle& handle,
       size_to_recv -=
         checkAndContinue(size_handle, recv_trackers, recv_requests, recv_requests,
                          recv_buffers, communicator_, UnpackSizeEntries<DataHandle>(),
-                         SetupRecvRequest<SizeDataHandle<DataHandle> >());
+                         SetupRecvRequest<SizeDataHandle<DataHandle> >(),
+                         true, false, !size_to_send);
   }
 }
 
@@ -1130,6 +1305,12 @@ void VariableSizeCommunicator<Allocator>::communicateVariableSize(DataHandle& ha
   communicateSizes<FORWARD>(handle, recv_trackers);
   std::size_t no_to_send, no_to_recv;
   no_to_send = no_to_recv =  interface_->size();
+
+  // Skip empty interfaces.
+  typedef typename std::vector<InterfaceTracker>::const_iterator Iter;
+  for(Iter i=recv_trackers.begin(), end=recv_trackers.end(); i!=end; ++i)
+    if(i->empty())
+      --no_to_recv;
   // Setup requests for sending and receiving.
   no_to_send -= setupRequests(handle, send_trackers, send_buffers, send_requests,
                 SetupSendRequest<DataHandle>(), communicator_);
@@ -1141,12 +1322,73 @@ void VariableSizeCommunicator<Allocator>::communicateVariableSize(DataHandle& ha
     // Check send completion and initiate other necessary sends
     if(no_to_send)
       no_to_send -= checkSendAndContinueSending(handle, send_trackers, send_requests,
-                                              send_buffers, communicator_);
+                                              send_buffers, communicator_, !no_to_recv);
     if(no_to_recv)
       // Receive data and setup new unblocking receives if necessary
       no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, recv_requests,
-                                                     recv_buffers, communicator_);
+                                                     recv_buffers, communicator_, !no_to_send);
+  }
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicateAggregated(DataHandle& handle)
+{
+  typedef typename DataHandle::DataType DataType;
+  typedef typename InterfaceMap::const_iterator IIter;
+  std::vector<std::unique_ptr<MessageBuffer<DataType> > > send_buffers;
+  std::vector<MPI_Request> send_requests;
+  send_buffers.reserve(interface_->size());
+  send_requests.reserve(interface_->size());
+
+  // Send all data for a neighbour in one message.
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf)
+  {
+    const InterfaceInformation& info=InterfaceInformationChooser<FORWARD>::getSend(inf->second);
+    if(!info.size())
+      continue;
+    send_buffers.push_back(packAggregated(handle, info));
+    std::size_t items=send_buffers.back()->size();
+    send_requests.push_back(MPI_REQUEST_NULL);
+    MPI_Isend(*send_buffers.back(), aggregatedCount(handle, items), aggregatedType(handle),
+              inf->first, aggregatedMessageTag, communicator_, &send_requests.back());
   }
+
+  std::vector<IIter> pending;
+  pending.reserve(interface_->size());
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf)
+    if(InterfaceInformationChooser<FORWARD>::getReceive(inf->second).size())
+      pending.push_back(inf);
+
+  while(!pending.empty())
+  {
+    // Unpack every message that already arrived.
+    typename std::vector<IIter>::iterator next=pending.begin();
+    for(typename std::vector<IIter>::iterator inf=pending.begin(); inf!=pending.end(); ++inf)
+    {
+      int flag;
+      MPI_Status status;
+      MPI_Iprobe((*inf)->first, aggregatedMessageTag, communicator_, &flag, &status);
+      if(flag)
+        receiveAggregated(handle, InterfaceInformationChooser<FORWARD>::getReceive((*inf)->second),
+                          status, communicator_);
+      else
+        *next++=*inf;
+    }
+    if(next==pending.end())
+    {
+      // Nothing arrived yet. Block instead of polling.
+      MPI_Status status;
+      MPI_Probe(pending.front()->first, aggregatedMessageTag, communicator_, &status);
+      receiveAggregated(handle, InterfaceInformationChooser<FORWARD>::getReceive(pending.front()->second),
+                        status, communicator_);
+      next=std::copy(pending.begin()+1, pending.end(), pending.begin());
+    }
+    pending.erase(next, pending.end());
+  }
+
+  if(!send_requests.empty())
+    MPI_Waitall(send_requests.size(), &(send_requests[0]), MPI_STATUSES_IGNORE);
 }
 
 template<class Allocator>
@@ -1158,7 +1400,9 @@ void VariableSizeCommunicator<Allocator>::communicate(DataHandle& handle)
     // either for MPI_Wait_all or MPI_Test_some.
     return;
 
-  if(handle.fixedsize())
+  if(maxBufferSize_==0)
+    communicateAggregated<FORWARD>(handle);
+  else if(handle.fixedsize())
     communicateFixedSize<FORWARD>(handle);
   else
     communicateVariableSize<FORWARD>(handle);
@@ -3,15 +3,206 @@
 #ifndef DUNE_COMMON_PARAMETERIZEDOBJECT_HH
 #define DUNE_COMMON_PARAMETERIZEDOBJECT_HH
 
+#include <cassert>
+#include <cstddef>
 #include <functional>
 #include <map>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/flathashmap.hh>
+#include <dune/common/hash.hh>
 #include <dune/common/std/memory.hh>
+#include <dune/common/typetraits.hh>
 #include <dune/common/typeutilities.hh>
 
 namespace Dune {
 
+namespace Impl {
+
+    /**
+     * @brief Copyable function wrapper storing small callables in place
+     *
+     * This behaves like std::function<R(Args...)>, but callables of at
+     * most bufferSize bytes which can be moved without throwing are
+     * stored inside the object instead of on the heap. Copying such a
+     * wrapper does not allocate and calling it costs one indirect call.
+     * Larger callables are allocated on the heap.
+     */
+    template<class Signature, std::size_t bufferSize = 4*sizeof(void*)>
+    class SmallFunction;
+
+    template<class R, class... Args, std::size_t bufferSize>
+    class SmallFunction<R(Args...), bufferSize>
+    {
+        enum class Operation { copy, move, destroy };
+
+        using Storage = typename std::aligned_storage<bufferSize, alignof(std::max_align_t)>::type;
+
+        template<class F>
+        using StoredInPlace = std::integral_constant<bool,
+            sizeof(F) <= sizeof(Storage)
+            and alignof(std::max_align_t) % alignof(F) == 0
+            and std::is_nothrow_move_constructible<F>::value>;
+
+        template<class F, class = void>
+        struct IsCallable : std::false_type {};
+
+        template<class F>
+        struct IsCallable<F, void_t<decltype(std::declval<F&>()(std::declval<Args>()...))> >
+            : std::is_convertible<decltype(std::declval<F&>()(std::declval<Args>()...)), R> {};
+
+    public:
+
+        SmallFunction() = default;
+
+        template<class F,
+            typename std::enable_if<
+                IsCallable<std::decay_t<F> >::value
+                and not std::is_same<std::decay_t<F>, SmallFunction>::value,
+                int>::type = 0>
+        SmallFunction(F&& f)
+        {
+            using D = std::decay_t<F>;
+            construct<D>(std::forward<F>(f), StoredInPlace<D>());
+            invoke_ = &invoke<D>;
+            manage_ = &manage<D>;
+        }
+
+        SmallFunction(const SmallFunction& other)
+        {
+            if (other.manage_)
+                other.manage_(Operation::copy, const_cast<Storage*>(&other.storage_), &storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+        }
+
+        SmallFunction(SmallFunction&& other) noexcept
+        {
+            takeOver(other);
+        }
+
+        ~SmallFunction()
+        {
+            reset();
+        }
+
+        SmallFunction& operator=(const SmallFunction& other)
+        {
+            if (this != &other)
+                *this = SmallFunction(other);
+            return *this;
+        }
+
+        SmallFunction& operator=(SmallFunction&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                takeOver(other);
+            }
+            return *this;
+        }
+
+        explicit operator bool() const
+        {
+            return invoke_ != nullptr;
+        }
+
+        R operator()(Args... args) const
+        {
+            if (not invoke_)
+                throw std::bad_function_call();
+            return invoke_(&storage_, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        template<class F>
+        static F* target(void* storage, std::true_type)
+        {
+            return static_cast<F*>(storage);
+        }
+
+        template<class F>
+        static F* target(void* storage, std::false_type)
+        {
+            return *static_cast<F**>(storage);
+        }
+
+        template<class F, class G>
+        void construct(G&& g, std::true_type)
+        {
+            new (&storage_) F(std::forward<G>(g));
+        }
+
+        template<class F, class G>
+        void construct(G&& g, std::false_type)
+        {
+            *reinterpret_cast<F**>(&storage_) = new F(std::forward<G>(g));
+        }
+
+        template<class F>
+        static R invoke(void* storage, Args&&... args)
+        {
+            return (*target<F>(storage, StoredInPlace<F>()))(std::forward<Args>(args)...);
+        }
+
+        template<class F>
+        static void manage(Operation op, void* from, void* to)
+        {
+            F* f = target<F>(from, StoredInPlace<F>());
+            switch (op) {
+                case Operation::copy:
+                    if (StoredInPlace<F>::value)
+                        new (to) F(*f);
+                    else
+                        *static_cast<F**>(to) = new F(*f);
+                    break;
+                case Operation::move:
+                    if (StoredInPlace<F>::value) {
+                        new (to) F(std::move(*f));
+                        f->~F();
+                    }
+                    else
+                        *static_cast<F**>(to) = f;
+                    break;
+                case Operation::destroy:
+                    if (StoredInPlace<F>::value)
+                        f->~F();
+                    else
+                        delete f;
+                    break;
+            }
+        }
+
+        void takeOver(SmallFunction& other)
+        {
+            if (other.manage_)
+                other.manage_(Operation::move, &other.storage_, &storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+        }
+
+        void reset()
+        {
+            if (manage_)
+                manage_(Operation::destroy, &storage_, nullptr);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+
+        mutable Storage storage_;
+        R (*invoke_)(void*, Args&&...) = nullptr;
+        void (*manage_)(Operation, void*, void*) = nullptr;
+    };
+
+} // end namespace Impl
+
 /**
  * @brief A factory class for parameterized objects.
  *
@@ -26,6 +217,12 @@ namespace Dune {
  * Each type constructed by this factory is identified by a different key. This class
  * allows for easy registration of type with new keys.
  *
+ * Keys are looked up in a hash table if Dune::hash supports the key type
+ * and in a sorted tree otherwise. Code creating objects repeatedly can
+ * resolve the key once using handle() and pass the returned Handle to
+ * create(), which then skips the lookup altogether. Small creator
+ * functions are stored without a separate heap allocation.
+ *
  * @tparam Signature Signature of the "virtual" constructor call in the form for Interface(Args...). For default constructors one can omit the ()-brackets.
  * @tparam KeyT The type of the objects that are used as keys in the lookup [DEFAULT: std::string].
  */
@@ -48,7 +245,7 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
 
     protected:
 
-        using Creator = std::function<Type(Args...)>;
+        using Creator = Impl::SmallFunction<Type(Args...)>;
 
         template<class F>
         static constexpr auto has_proper_signature(Dune::PriorityTag<1>)
@@ -65,6 +262,24 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
 
     public:
 
+        /**
+         * @brief Pre-resolved key of a registered creator
+         *
+         * A handle is obtained from handle() and stays valid for the
+         * lifetime of the factory it was obtained from, even if the
+         * creator for its key is redefined later on.
+         */
+        class Handle
+        {
+            friend class ParameterizedObjectFactory;
+
+            explicit Handle(std::size_t index) :
+                index_(index)
+            {}
+
+            std::size_t index_;
+        };
+
         /**
          * @brief Creates an object identified by a key from given parameters
          *
@@ -72,14 +287,35 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
          * @param args The parameters used for the construction.
          * @return The object wrapped as Type
          */
-        Type create(Key const& key, Args ... args) {
-            typename Registry::const_iterator i = registry_.find(key);
-            if (i == registry_.end()) {
-                DUNE_THROW(Dune::InvalidStateException,
-                    "ParametrizedObjectFactory: key ``" <<
-                    key << "'' not registered");
-            }
-            else return i->second(args...);
+        Type create(Key const& key, Args ... args) const {
+            return creators_[lookup(key)](std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Creates an object identified by a handle from given parameters
+         *
+         * @param handle Handle of the key the object is registered with @see handle.
+         * @param args The parameters used for the construction.
+         * @return The object wrapped as Type
+         */
+        Type create(Handle handle, Args ... args) const {
+            assert(handle.index_ < creators_.size());
+            return creators_[handle.index_](std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Resolves a key to a handle for repeated creation
+         *
+         * @param key The key the object is registered with @see define.
+         * @throw InvalidStateException if the key is not registered
+         */
+        Handle handle(Key const& key) const {
+            return Handle(lookup(key));
+        }
+
+        /** @brief Whether a creator is registered for the given key */
+        bool contains(Key const& key) const {
+            return registry_.find(key) != registry_.end();
         }
 
         /**
@@ -98,7 +334,7 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
         template<class Impl>
         void define(Key const& key)
         {
-            registry_[key] = DefaultCreator<Impl>();
+            insert(key, DefaultCreator<Impl>());
         }
 
         /**
@@ -118,7 +354,7 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
             typename std::enable_if<has_proper_signature<F>(PriorityTag<42>()), int>::type = 0>
         void define(Key const& key, F&& f)
         {
-            registry_[key] = f;
+            insert(key, std::forward<F>(f));
         }
 
         /**
@@ -142,7 +378,7 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
                 int>::type = 0>
         void define(Key const& key, Impl&& t)
         {
-            registry_[key] = [=](Args...) { return t;};
+            insert(key, [t](Args...) { return t;});
         }
 
     private:
@@ -176,8 +412,32 @@ class ParameterizedObjectFactory<TypeT(Args...), KeyT>
 
         };
 
-        typedef std::map<Key, Creator> Registry;
+        std::size_t lookup(Key const& key) const {
+            auto i = registry_.find(key);
+            if (i == registry_.end()) {
+                DUNE_THROW(Dune::InvalidStateException,
+                    "ParametrizedObjectFactory: key ``" <<
+                    key << "'' not registered");
+            }
+            return i->second;
+        }
+
+        template<class F>
+        void insert(Key const& key, F&& f) {
+            auto result = registry_.emplace(key, creators_.size());
+            if (result.second)
+                creators_.emplace_back(std::forward<F>(f));
+            else
+                creators_[result.first->second] = Creator(std::forward<F>(f));
+        }
+
+        // maps each key to the position of its creator in creators_
+        typedef typename std::conditional<Impl::IsHashable<Key>::value,
+            FlatHashMap<Key, std::size_t>,
+            std::map<Key, std::size_t> >::type Registry;
+
         Registry registry_;
+        std::vector<Creator> creators_;
 };
 
 
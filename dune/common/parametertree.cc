@@ -26,49 +26,58 @@ const Dune::ParameterTree Dune::ParameterTree::empty_;
 
 void ParameterTree::report(std::ostream& stream, const std::string& prefix) const
 {
-  typedef std::map<std::string, std::string>::const_iterator ValueIt;
-  ValueIt vit = values_.begin();
-  ValueIt vend = values_.end();
-
-  for(; vit!=vend; ++vit)
-    stream << vit->first << " = \"" << vit->second << "\"" << std::endl;
-
-  typedef std::map<std::string, ParameterTree>::const_iterator SubIt;
-  SubIt sit = subs_.begin();
-  SubIt send = subs_.end();
-  for(; sit!=send; ++sit)
+  // the hash tables are unordered, report the keys in sorted order
+  KeyVector valueKeys = valueKeys_;
+  std::sort(valueKeys.begin(), valueKeys.end());
+  for(const std::string& key : valueKeys)
+    stream << key << " = \"" << values_.find(key)->second.string << "\"" << std::endl;
+
+  KeyVector subKeys = subKeys_;
+  std::sort(subKeys.begin(), subKeys.end());
+  for(const std::string& key : subKeys)
   {
-    stream << "[ " << prefix + prefix_ + sit->first << " ]" << std::endl;
-    (sit->second).report(stream, prefix);
+    stream << "[ " << prefix + prefix_ + key << " ]" << std::endl;
+    subs_.find(key)->second.report(stream, prefix);
   }
 }
 
-bool ParameterTree::hasKey(const std::string& key) const
+const ParameterTree::Value* ParameterTree::findValue(const std::string& key) const
 {
-  std::string::size_type dot = key.find(".");
+  const ParameterTree* tree = this;
+  std::string name;
+  std::string::size_type begin = 0;
+  std::string::size_type dot = key.find('.');
 
-  if (dot != std::string::npos)
+  // descend into the subtree named by each dotted prefix
+  while (dot != std::string::npos)
   {
-    std::string prefix = key.substr(0,dot);
-    if (subs_.count(prefix) == 0)
-      return false;
+    name.assign(key, begin, dot-begin);
+    auto sit = tree->subs_.find(name);
+    if (sit == tree->subs_.end())
+      return nullptr;
 
-    if (values_.count(prefix) > 0)
-      DUNE_THROW(RangeError,"key " << prefix << " occurs as value and as subtree");
+    if (tree->values_.count(name) > 0)
+      DUNE_THROW(RangeError,"key " << name << " occurs as value and as subtree");
 
-    const ParameterTree& s = sub(prefix);
-    return s.hasKey(key.substr(dot+1));
+    tree = &sit->second;
+    begin = dot+1;
+    dot = key.find('.', begin);
   }
-  else
-    if (values_.count(key) != 0)
-      {
-        if (subs_.count(key) > 0)
-          DUNE_THROW(RangeError,"key " << key << " occurs as value and as subtree");
-        return true;
-      }
-    else
-      return false;
 
+  name.assign(key, begin, std::string::npos);
+  auto vit = tree->values_.find(name);
+  if (vit == tree->values_.end())
+    return nullptr;
+
+  if (tree->subs_.count(name) > 0)
+    DUNE_THROW(RangeError,"key " << name << " occurs as value and as subtree");
+
+  return &vit->second;
+}
+
+bool ParameterTree::hasKey(const std::string& key) const
+{
+  return findValue(key) != nullptr;
 }
 
 bool ParameterTree::hasSub(const std::string& key) const
@@ -158,40 +167,33 @@ std::string& ParameterTree::operator[] (const std::string& key)
   {
     if (! hasKey(key))
       valueKeys_.push_back(key);
-    return values_[key];
+    return values_[key].string;
   }
 }
 
 const std::string& ParameterTree::operator[] (const std::string& key) const
 {
-  std::string::size_type dot = key.find(".");
-
-  if (dot != std::string::npos)
-  {
-    const ParameterTree& s = sub(key.substr(0,dot));
-    return s[key.substr(dot+1)];
-  }
-  else
-  {
-    if (! hasKey(key))
-      DUNE_THROW(Dune::RangeError, "Key '" << key
-        << "' not found in ParameterTree (prefix " + prefix_ + ")");
-    return values_.find(key)->second;
-  }
+  const Value* value = findValue(key);
+  if (! value)
+    DUNE_THROW(Dune::RangeError, "Key '" << key
+      << "' not found in ParameterTree (prefix " + prefix_ + ")");
+  return value->string;
 }
 
 std::string ParameterTree::get(const std::string& key, const std::string& defaultValue) const
 {
-  if (hasKey(key))
-    return (*this)[key];
+  const Value* value = findValue(key);
+  if (value)
+    return value->string;
   else
     return defaultValue;
 }
 
 std::string ParameterTree::get(const std::string& key, const char* defaultValue) const
 {
-  if (hasKey(key))
-    return (*this)[key];
+  const Value* value = findValue(key);
+  if (value)
+    return value->string;
   else
     return defaultValue;
 }
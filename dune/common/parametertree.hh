@@ -13,11 +13,16 @@
 #include <istream>
 #include <iterator>
 #include <locale>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <typeindex>
 #include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <algorithm>
 #include <bitset>
@@ -30,6 +35,12 @@ namespace Dune {
 
   /** \brief Hierarchical structure of string parameters
    * \ingroup Common
+   *
+   * Keys are looked up in hash tables. The value of a key converted by
+   * get<T>() is cached per type and reused until the string stored for
+   * the key changes, so repeated reads of the same parameter do not parse
+   * it again. Code reading a parameter in a loop can resolve its key once
+   * using handle<T>() and then read it through the returned Handle.
    */
   class ParameterTree
   {
@@ -38,6 +49,52 @@ namespace Dune {
     template<typename T>
     struct Parser;
 
+    // a value converted to some type, together with the string it was
+    // converted from
+    struct CachedValueBase
+    {
+      explicit CachedValueBase(const std::string& s) :
+        source(s)
+      {}
+
+      virtual ~CachedValueBase() = default;
+
+      std::string source;
+    };
+
+    template<typename T>
+    struct CachedValue : public CachedValueBase
+    {
+      CachedValue(const std::string& s, const T& v) :
+        CachedValueBase(s), value(v)
+      {}
+
+      T value;
+    };
+
+    // a value string and its converted values, which are not copied along
+    // with the string
+    struct Value
+    {
+      Value() = default;
+
+      Value(const Value& other) :
+        string(other.string)
+      {}
+
+      Value& operator=(const Value& other)
+      {
+        string = other.string;
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.clear();
+        return *this;
+      }
+
+      std::string string;
+      mutable std::mutex mutex;
+      mutable std::vector<std::pair<std::type_index, std::unique_ptr<CachedValueBase> > > cache;
+    };
+
   public:
 
     /** \brief storage for key lists
@@ -154,8 +211,9 @@ namespace Dune {
      */
     template<typename T>
     T get(const std::string& key, const T& defaultValue) const {
-      if(hasKey(key))
-        return get<T>(key);
+      const Value* value = findValue(key);
+      if(value)
+        return parse<T>(*value, key);
       else
         return defaultValue;
     }
@@ -170,18 +228,91 @@ namespace Dune {
      */
     template <class T>
     T get(const std::string& key) const {
-      if(not hasKey(key))
+      const Value* value = findValue(key);
+      if(not value)
         DUNE_THROW(Dune::RangeError, "Key '" << key
           << "' not found in ParameterTree (prefix " + prefix_ + ")");
-      try {
-        return Parser<T>::parse((*this)[key]);
+      return parse<T>(*value, key);
+    }
+
+    /** \brief Pre-resolved key for repeated reads of a value
+     *
+     * A handle refers to the value of one key in the tree it was obtained
+     * from and converts it to T. The converted value is kept in the
+     * handle and only converted again after the value string has been
+     * changed. A handle stays valid as long as that tree exists and is
+     * not assigned to. It must not be read concurrently from several
+     * threads.
+     *
+     * \tparam T Type of the value
+     */
+    template<class T>
+    class Handle
+    {
+      friend class ParameterTree;
+
+      Handle(const Value& value, const std::string& key) :
+        value_(&value),
+        key_(key),
+        source_(value.string),
+        converted_(Handle::convert(source_, key_))
+      {}
+
+    public:
+
+      /** \brief get the value converted to T
+       *
+       * \throws RangeError if the value cannot be converted
+       */
+      const T& operator*() const
+      {
+        if(value_->string != source_)
+        {
+          converted_ = convert(value_->string, key_);
+          source_ = value_->string;
+        }
+        return converted_;
       }
-      catch(const RangeError& e) {
-        // rethrow the error and add more information
-        DUNE_THROW(RangeError, "Cannot parse value \"" << (*this)[key]
-          << "\" for key \"" << prefix_ << "." << key << "\""
-          << e.what());
+
+      /** \brief access members of the value converted to T */
+      const T* operator->() const
+      {
+        return &**this;
+      }
+
+    private:
+
+      static T convert(const std::string& str, const std::string& key)
+      {
+        try {
+          return Parser<T>::parse(str);
+        }
+        catch(const RangeError& e) {
+          DUNE_THROW(RangeError, "Cannot parse value \"" << str
+            << "\" for key \"" << key << "\"" << e.what());
+        }
       }
+
+      const Value* value_;
+      std::string key_;
+      mutable std::string source_;
+      mutable T converted_;
+    };
+
+    /** \brief Resolve a key for repeated reads of its value
+     *
+     * \tparam T Type of the value
+     * \param key Key name
+     * \throws RangeError if key does not exist or its value cannot be
+     *         converted to T
+     */
+    template<class T>
+    Handle<T> handle(const std::string& key) const {
+      const Value* value = findValue(key);
+      if(not value)
+        DUNE_THROW(Dune::RangeError, "Key '" << key
+          << "' not found in ParameterTree (prefix " + prefix_ + ")");
+      return Handle<T>(*value, prefix_ + "." + key);
     }
 
     /** \brief get value keys
@@ -212,8 +343,54 @@ namespace Dune {
     KeyVector valueKeys_;
     KeyVector subKeys_;
 
-    std::map<std::string, std::string> values_;
-    std::map<std::string, ParameterTree> subs_;
+    std::unordered_map<std::string, Value> values_;
+    std::unordered_map<std::string, ParameterTree> subs_;
+
+    // find the value of a possibly dotted key, nullptr if it does not exist
+    const Value* findValue(const std::string& key) const;
+
+    // convert a value, reusing a cached conversion if possible
+    template<class T>
+    T parse(const Value& value, const std::string& key) const
+    {
+      try {
+        return cachedParse<T>(value, std::is_copy_constructible<T>());
+      }
+      catch(const RangeError& e) {
+        // rethrow the error and add more information
+        DUNE_THROW(RangeError, "Cannot parse value \"" << value.string
+          << "\" for key \"" << prefix_ << "." << key << "\""
+          << e.what());
+      }
+    }
+
+    template<class T>
+    static T cachedParse(const Value& value, std::false_type)
+    {
+      return Parser<T>::parse(value.string);
+    }
+
+    template<class T>
+    static T cachedParse(const Value& value, std::true_type)
+    {
+      std::lock_guard<std::mutex> lock(value.mutex);
+      for(auto& entry : value.cache)
+        if(entry.first == std::type_index(typeid(T)))
+        {
+          CachedValue<T>& cached = static_cast<CachedValue<T>&>(*entry.second);
+          if(cached.source != value.string)
+          {
+            cached.value = Parser<T>::parse(value.string);
+            cached.source = value.string;
+          }
+          return cached.value;
+        }
+      std::unique_ptr<CachedValue<T> > cached(
+        new CachedValue<T>(value.string, Parser<T>::parse(value.string)));
+      T result = cached->value;
+      value.cache.emplace_back(std::type_index(typeid(T)), std::move(cached));
+      return result;
+    }
 
     static std::string ltrim(const std::string& s);
     static std::string rtrim(const std::string& s);
@@ -0,0 +1,173 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_COMMON_RESERVEDDENSEVECTOR_HH
+#define DUNE_COMMON_RESERVEDDENSEVECTOR_HH
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+
+#include "boundschecking.hh"
+#include "densevector.hh"
+#include "ftraits.hh"
+#include "reservedvector.hh"
+
+namespace Dune {
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /*! \file
+   * \brief A dense vector with a dynamic size bounded at compile time,
+   *        stored in a ReservedVector.
+   */
+
+  template< class K, int n > class ReservedDenseVector;
+  template< class K, int n >
+  struct DenseMatVecTraits< ReservedDenseVector< K, n > >
+  {
+    typedef ReservedDenseVector< K, n > derived_type;
+    typedef ReservedVector< K, n > container_type;
+    typedef K value_type;
+    typedef typename container_type::size_type size_type;
+  };
+
+  template< class K, int n >
+  struct FieldTraits< ReservedDenseVector< K, n > >
+  {
+    typedef typename FieldTraits< K >::field_type field_type;
+    typedef typename FieldTraits< K >::real_type real_type;
+  };
+
+  /** \brief DenseVector interface on top of a ReservedVector.
+   *
+   * The size may change at run time up to the capacity n, but no
+   * memory is ever allocated. The underlying ReservedVector can be
+   * accessed through container(), e.g. to communicate it.
+   *
+   * \tparam K is the field type (use float, double, complex, etc)
+   * \tparam n the maximal size of the vector
+   */
+  template< class K, int n >
+  class ReservedDenseVector : public DenseVector< ReservedDenseVector< K, n > >
+  {
+    ReservedVector< K, n > _data;
+
+    typedef DenseVector< ReservedDenseVector< K, n > > Base;
+  public:
+    typedef typename Base::size_type size_type;
+    typedef typename Base::value_type value_type;
+    typedef ReservedVector< K, n > container_type;
+
+    //! Constructor making empty vector
+    ReservedDenseVector()
+    {}
+
+    //! Constructor making vector with identical coordinates
+    explicit ReservedDenseVector( size_type s, value_type c = value_type() )
+    {
+      resize(s,c);
+    }
+
+    /** \brief Construct from a std::initializer_list */
+    ReservedDenseVector (std::initializer_list<K> const &l) :
+      _data(l)
+    {}
+
+    //! Construct from a ReservedVector
+    explicit ReservedDenseVector (const container_type & x) :
+      _data(x)
+    {}
+
+    //! Copy constructor
+    ReservedDenseVector(const ReservedDenseVector & x) :
+      Base(), _data(x._data)
+    {}
+
+    //! Copy constructor from another DenseVector
+    template< class X >
+    ReservedDenseVector(const DenseVector< X > & x)
+    {
+      const size_type s = x.size();
+      DUNE_ASSERT_BOUNDS(s <= n);
+      for( size_type i =0; i<s ;++i)
+        _data.push_back( x[ i ] );
+    }
+
+    using Base::operator=;
+
+    //! Copy assignment operator
+    ReservedDenseVector &operator=(const ReservedDenseVector &other)
+    {
+      _data = other._data;
+      return *this;
+    }
+
+    //==== forward some methods of ReservedVector
+    static constexpr size_type capacity()
+    {
+      return n;
+    }
+
+    void resize (size_type s, value_type c = value_type() )
+    {
+      DUNE_ASSERT_BOUNDS(s <= n);
+      const size_type old = _data.size();
+      _data.resize(s);
+      for( size_type i = old; i < s; ++i )
+        _data[ i ] = c;
+    }
+
+    void push_back (const value_type & k)
+    {
+      DUNE_ASSERT_BOUNDS(size() < n);
+      _data.push_back(k);
+    }
+
+    //! Access the underlying ReservedVector
+    container_type & container() { return _data; }
+
+    //! Access the underlying ReservedVector
+    const container_type & container() const { return _data; }
+
+    //==== make this thing a vector
+    size_type size() const { return _data.size(); }
+    K & operator[](size_type i) {
+      DUNE_ASSERT_BOUNDS(i < size());
+      return _data[i];
+    }
+    const K & operator[](size_type i) const {
+      DUNE_ASSERT_BOUNDS(i < size());
+      return _data[i];
+    }
+  };
+
+  /** \brief Read a ReservedDenseVector from an input stream
+   *  \relates ReservedDenseVector
+   *
+   *  \note This operator is STL compilant, i.e., the content of v is only
+   *        changed if the read operation is successful.
+   *
+   *  \param[in]  in  std :: istream to read from
+   *  \param[out] v   ReservedDenseVector to be read
+   *
+   *  \returns the input stream (in)
+   */
+  template< class K, int n >
+  inline std::istream &operator>> ( std::istream &in,
+                                    ReservedDenseVector< K, n > &v )
+  {
+    ReservedDenseVector< K, n > w(v);
+    for( typename ReservedDenseVector< K, n >::size_type i = 0; i < w.size(); ++i )
+      in >> w[ i ];
+    if(in)
+      v = w;
+    return in;
+  }
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif // DUNE_COMMON_RESERVEDDENSEVECTOR_HH
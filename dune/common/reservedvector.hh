@@ -8,10 +8,13 @@
  */
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <iterator>
 #include <cstddef>
 #include <dune/common/genericiterator.hh>
 #include <initializer_list>
+#include <utility>
 
 #include <dune/common/hash.hh>
 
@@ -23,6 +26,9 @@
 
 namespace Dune
 {
+  template<typename T>
+  struct MPITraits;
+
   /**
      \brief A Vector class with statically reserved memory.
 
@@ -33,6 +39,12 @@ namespace Dune
      This implies that the vector can not grow bigger than the predefined
      maximum size.
 
+     ReservedVector is trivially copyable if T is, i.e. it may be copied
+     with memcpy and sent as a whole through MPI, see MPITraits. Then all
+     n entries are sent, including those beyond size(), which hold their
+     last values or are value-initialized. All methods not involving
+     iterators or streams and the constructors are constexpr.
+
      \tparam T The data type ReservedVector stores.
      \tparam n The maximum number of objects the ReservedVector can store.
 
@@ -66,53 +78,96 @@ namespace Dune
     /** @{ Constructors */
 
     //! Constructor
-    ReservedVector() : sz(0) {}
-
-    ReservedVector(std::initializer_list<T> const &l)
+    /**
+     * The storage is value-initialized, as this is required for the
+     * constructor to be usable in constant expressions. Thus the entries
+     * beyond size() of trivial types are defined, also when the vector is
+     * sent as a whole, at the cost of zeroing n entries.
+     */
+    constexpr ReservedVector() : storage{}, sz(0) {}
+
+    //! Constructor from an initializer list
+    /**
+     * The storage is value-initialized like in the default constructor.
+     */
+    constexpr ReservedVector(std::initializer_list<T> const &l)
+      : storage{}, sz(l.size())
     {
       assert(l.size() <= n);// Actually, this is not needed any more!
-      sz = l.size();
-      std::copy_n(l.begin(), sz, data);
+      for (size_type i=0; i<sz; ++i)
+        storage[i] = l.begin()[i];
     }
 
     /** @} */
 
-    bool operator == (const ReservedVector & other) const
+    constexpr bool operator == (const ReservedVector & other) const
     {
       bool eq = (sz == other.sz);
       for (size_type i=0; i<sz && eq; ++i)
-        eq = eq && (data[i] == other.data[i]);
+        eq = eq && (storage[i] == other.storage[i]);
       return eq;
     }
 
     /** @{ Data access operations */
 
     //! Erases all elements.
-    void clear()
+    constexpr void clear()
     {
       sz = 0;
     }
 
     //! Specifies a new size for the vector.
-    void resize(size_t s)
+    constexpr void resize(size_t s)
     {
       CHECKSIZE(s<=n);
       sz = s;
     }
 
     //! Appends an element to the end of a vector, up to the maximum size n, O(1) time.
-    void push_back(const T& t)
+    constexpr void push_back(const T& t)
+    {
+      CHECKSIZE(sz<n);
+      storage[sz++] = t;
+    }
+
+    //! Appends an element to the end of a vector by moving it, O(1) time.
+    constexpr void push_back(T&& t)
+    {
+      CHECKSIZE(sz<n);
+      storage[sz++] = std::move(t);
+    }
+
+    //! Appends an element constructed from args to the end of a vector, O(1) time.
+    template<class... Args>
+    constexpr reference emplace_back(Args&&... args)
     {
       CHECKSIZE(sz<n);
-      data[sz++] = t;
+      storage[sz] = T(std::forward<Args>(args)...);
+      return storage[sz++];
     }
 
     //! Erases the last element of the vector, O(1) time.
-    void pop_back()
+    constexpr void pop_back()
     {
       if (! empty()) sz--;
     }
 
+    /** \brief Inserts the elements of the range [first,last) before pos.
+     *
+     * \return An iterator pointing to the first inserted element.
+     */
+    template<class ForwardIterator>
+    iterator insert(const_iterator pos, ForwardIterator first, ForwardIterator last)
+    {
+      const size_type i = pos - const_iterator(*this, 0);
+      const size_type count = std::distance(first, last);
+      CHECKSIZE(sz+count<=n);
+      std::move_backward(storage+i, storage+sz, storage+sz+count);
+      std::copy(first, last, storage+i);
+      sz += count;
+      return iterator(*this, i);
+    }
+
     //! Returns a iterator pointing to the beginning of the vector.
     iterator begin(){
       return iterator(*this, 0);
@@ -134,45 +189,57 @@ namespace Dune
     }
 
     //! Returns reference to the i'th element.
-    reference operator[] (size_type i)
+    constexpr reference operator[] (size_type i)
     {
       CHECKSIZE(sz>i);
-      return data[i];
+      return storage[i];
     }
 
     //! Returns a const reference to the i'th element.
-    const_reference operator[] (size_type i) const
+    constexpr const_reference operator[] (size_type i) const
     {
       CHECKSIZE(sz>i);
-      return data[i];
+      return storage[i];
     }
 
     //! Returns reference to first element of vector.
-    reference front()
+    constexpr reference front()
     {
       CHECKSIZE(sz>0);
-      return data[0];
+      return storage[0];
     }
 
     //! Returns const reference to first element of vector.
-    const_reference front() const
+    constexpr const_reference front() const
     {
       CHECKSIZE(sz>0);
-      return data[0];
+      return storage[0];
     }
 
     //! Returns reference to last element of vector.
-    reference back()
+    constexpr reference back()
     {
       CHECKSIZE(sz>0);
-      return data[sz-1];
+      return storage[sz-1];
     }
 
     //! Returns const reference to last element of vector.
-    const_reference back() const
+    constexpr const_reference back() const
     {
       CHECKSIZE(sz>0);
-      return data[sz-1];
+      return storage[sz-1];
+    }
+
+    //! Returns a pointer to the first element of the contiguous storage.
+    constexpr pointer data()
+    {
+      return storage;
+    }
+
+    //! Returns a const pointer to the first element of the contiguous storage.
+    constexpr const T* data() const
+    {
+      return storage;
     }
 
     /** @} */
@@ -180,13 +247,13 @@ namespace Dune
     /** @{ Informative Methods */
 
     //! Returns number of elements in the vector.
-    size_type size () const
+    constexpr size_type size () const
     {
       return sz;
     }
 
     //! Returns true if vector has no elements.
-    bool empty() const
+    constexpr bool empty() const
     {
       return sz==0;
     }
@@ -215,11 +282,13 @@ namespace Dune
 
     inline friend std::size_t hash_value(const ReservedVector& v) noexcept
     {
-      return hash_range(v.data,v.data+v.sz);
+      return hash_range(v.storage,v.storage+v.sz);
     }
 
   private:
-    T data[n];
+    friend struct MPITraits<ReservedVector>;
+
+    T storage[n];
     size_type sz;
   };
 
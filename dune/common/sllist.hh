@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <cassert>
+#include <cstddef>
+#include <type_traits>
 #include "iteratorfacades.hh"
 #include <ostream>
 
@@ -30,12 +32,40 @@ namespace Dune
   template<typename T, class A>
   class SLListModifyIterator;
 
+  template<class T, std::size_t s>
+  class PoolAllocator;
+
+  namespace Impl
+  {
+    /**
+     * @brief The maximal number of elements SLList allocates at once.
+     *
+     * Allocators which only hand out single objects, like PoolAllocator,
+     * have to specialize this to one.
+     */
+    template<class A>
+    struct SLListChunkSize
+      : std::integral_constant<std::size_t, 256>
+    {};
+
+    template<class T, std::size_t s>
+    struct SLListChunkSize<PoolAllocator<T,s> >
+      : std::integral_constant<std::size_t, 1>
+    {};
+  }
+
   /**
    * @brief A single linked list.
    *
    * The list is capable of insertions at the front and at
    * the end and of removing elements at the front. Those
    * operations require constant time.
+   *
+   * The elements are allocated in chunks of growing size which are
+   * owned by the list, and removed elements are reused by later
+   * insertions. This saves allocator calls and keeps the elements of
+   * a list close together in memory. The chunks are released by
+   * clear() and the destructor.
    */
   template<typename T, class A=std::allocator<T> >
   class SLList
@@ -237,6 +267,19 @@ namespace Dune
      */
     template<bool watchForTail>
     void deleteNext(Element* current);
+
+    /** @brief Get uninitialized memory for an element. */
+    Element* allocateElement();
+
+    /** @brief Return the memory of a destroyed element. */
+    void deallocateElement(Element* element);
+
+    /** @brief Release all chunks of elements. */
+    void releaseChunks();
+
+    /** @brief The number of elements in the chunk allocated as index-th. */
+    static std::size_t chunkSize(int index);
+
     /**
      * @brief Insert an element after another one in the list.
      * @param current The element after which we insert.
@@ -259,6 +302,29 @@ namespace Dune
 
     /** brief The number of elements the list holds. */
     int size_;
+
+    /** @brief The maximal number of elements allocated at once. */
+    static const std::size_t maxChunkSize = Impl::SLListChunkSize<Allocator>::value;
+
+    /**
+     * @brief The most recently allocated chunk.
+     *
+     * The first element of each chunk is not used for storage, its next_
+     * pointer links to the previously allocated chunk.
+     */
+    Element* chunks_;
+
+    /** @brief The number of allocated chunks. */
+    int chunkCount_;
+
+    /** @brief The next unused element in the newest chunk. */
+    Element* chunkNext_;
+
+    /** @brief One past the last element of the newest chunk. */
+    Element* chunkEnd_;
+
+    /** @brief Elements removed from the list, linked by next_. */
+    Element* free_;
   };
 
   /**
@@ -580,7 +646,8 @@ namespace Dune
 
   template<typename T, class A>
   SLList<T,A>::SLList()
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      chunks_(0), chunkCount_(0), chunkNext_(0), chunkEnd_(0), free_(0)
   {
     beforeHead_.next_=0;
     assert(&beforeHead_==tail_);
@@ -589,7 +656,8 @@ namespace Dune
 
   template<typename T, class A>
   SLList<T,A>::SLList(const SLList<T,A>& other)
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      chunks_(0), chunkCount_(0), chunkNext_(0), chunkEnd_(0), free_(0)
   {
     copyElements(other);
   }
@@ -597,7 +665,8 @@ namespace Dune
   template<typename T, class A>
   template<typename T1, class A1>
   SLList<T,A>::SLList(const SLList<T1,A1>& other)
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      chunks_(0), chunkCount_(0), chunkNext_(0), chunkEnd_(0), free_(0)
   {
     copyElements(other);
   }
@@ -621,6 +690,65 @@ namespace Dune
     clear();
   }
 
+  template<typename T, class A>
+  inline std::size_t SLList<T,A>::chunkSize(int index)
+  {
+    // start small and double the size up to maxChunkSize
+    std::size_t n = 8;
+    for(int i=0; i < index && n < maxChunkSize; ++i)
+      n *= 2;
+    return n < maxChunkSize ? n : maxChunkSize;
+  }
+
+  template<typename T, class A>
+  inline typename SLList<T,A>::Element* SLList<T,A>::allocateElement()
+  {
+    if(maxChunkSize < 2)
+      return allocator_.allocate(1, 0);
+
+    if(free_) {
+      Element* element = free_;
+      free_ = free_->next_;
+      return element;
+    }
+
+    if(chunkNext_ == chunkEnd_) {
+      const std::size_t n = chunkSize(chunkCount_);
+      Element* chunk = allocator_.allocate(n);
+      chunk->next_ = chunks_;
+      chunks_ = chunk;
+      ++chunkCount_;
+      chunkNext_ = chunk + 1;
+      chunkEnd_ = chunk + n;
+    }
+    return chunkNext_++;
+  }
+
+  template<typename T, class A>
+  inline void SLList<T,A>::deallocateElement(Element* element)
+  {
+    if(maxChunkSize < 2) {
+      allocator_.deallocate(element, 1);
+      return;
+    }
+    element->next_ = free_;
+    free_ = element;
+  }
+
+  template<typename T, class A>
+  inline void SLList<T,A>::releaseChunks()
+  {
+    // the newest chunk comes first
+    while(chunks_) {
+      --chunkCount_;
+      Element* previous = chunks_->next_;
+      allocator_.deallocate(chunks_, chunkSize(chunkCount_));
+      chunks_ = previous;
+    }
+    assert(chunkCount_==0);
+    chunkNext_ = chunkEnd_ = free_ = 0;
+  }
+
   template<typename T, class A>
   bool SLList<T,A>::operator==(const SLList& other) const
   {
@@ -657,7 +785,7 @@ namespace Dune
   inline void SLList<T,A>::push_back(const MemberType& item)
   {
     assert(size_>0 || tail_==&beforeHead_);
-    tail_->next_ = allocator_.allocate(1, 0);
+    tail_->next_ = allocateElement();
     assert(size_>0 || tail_==&beforeHead_);
     tail_ = tail_->next_;
     ::new (static_cast<void*>(&(tail_->item_)))T(item);
@@ -681,7 +809,7 @@ namespace Dune
     assert(!changeTail || !tmp);
 
     // Allocate space
-    current->next_ = allocator_.allocate(1, 0);
+    current->next_ = allocateElement();
 
     // Use copy constructor to initialize memory
     allocator_.construct(current->next_, Element(item,tmp));
@@ -702,11 +830,11 @@ namespace Dune
   {
     if(tail_ == &beforeHead_) {
       // list was empty
-      beforeHead_.next_ = tail_ = allocator_.allocate(1, 0);
+      beforeHead_.next_ = tail_ = allocateElement();
       ::new(static_cast<void*>(&beforeHead_.next_->item_))T(item);
       beforeHead_.next_->next_=0;
     }else{
-      Element* added = allocator_.allocate(1, 0);
+      Element* added = allocateElement();
       ::new(static_cast<void*>(&added->item_))T(item);
       added->next_=beforeHead_.next_;
       beforeHead_.next_=added;
@@ -737,7 +865,7 @@ namespace Dune
 
     current->next_ = next->next_;
     allocator_.destroy(next);
-    allocator_.deallocate(next, 1);
+    deallocateElement(next);
     --size_;
     assert(!watchForTail || &beforeHead_ != tail_ || size_==0);
   }
@@ -758,6 +886,7 @@ namespace Dune
     assert(size_==0);
     // update the tail!
     tail_ = &beforeHead_;
+    releaseChunks();
   }
 
   template<typename T, class A>
@@ -0,0 +1,286 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_SMALLDYNVECTOR_HH
+#define DUNE_SMALLDYNVECTOR_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "boundschecking.hh"
+#include "densevector.hh"
+#include "ftraits.hh"
+
+namespace Dune {
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /*! \file
+   * \brief This file implements a dense vector with a dynamic size which
+   *        stores small vectors without dynamic memory allocation.
+   */
+
+  template< class K, int inlineSize, class Allocator > class SmallDynamicVector;
+  template< class K, int inlineSize, class Allocator >
+  struct DenseMatVecTraits< SmallDynamicVector< K, inlineSize, Allocator > >
+  {
+    typedef SmallDynamicVector< K, inlineSize, Allocator > derived_type;
+    typedef K value_type;
+    typedef std::size_t size_type;
+  };
+
+  template< class K, int inlineSize, class Allocator >
+  struct FieldTraits< SmallDynamicVector< K, inlineSize, Allocator > >
+  {
+    typedef typename FieldTraits< K >::field_type field_type;
+    typedef typename FieldTraits< K >::real_type real_type;
+  };
+
+  /** \brief Construct a vector with a dynamic size and inline storage for small sizes.
+   *
+   * The interface is the one of DynamicVector. Vectors with at most
+   * inlineSize entries are stored inside the object itself. Only larger
+   * vectors allocate their entries from the heap. Shrinking a vector to
+   * at most inlineSize entries moves it back into the inline storage, the
+   * heap memory is kept for later growth.
+   *
+   * \tparam K is the field type (use float, double, complex, etc)
+   * \tparam inlineSize maximal number of entries stored without allocation,
+   *                default inlineSize = 32.
+   * \tparam Allocator type of allocator object used for vectors larger than inlineSize,
+   *                default Allocator = std::allocator< K >.
+   */
+  template< class K, int inlineSize = 32, class Allocator = std::allocator< K > >
+  class SmallDynamicVector
+    : public DenseVector< SmallDynamicVector< K, inlineSize, Allocator > >
+  {
+    static_assert(inlineSize > 0, "SmallDynamicVector needs an inline size of at least one");
+
+    typedef DenseVector< SmallDynamicVector< K, inlineSize, Allocator > > Base;
+
+    // moving entries out of the inline storage must not throw
+    static constexpr bool nothrowMove =
+      std::is_nothrow_default_constructible< K >::value
+      && std::is_nothrow_move_assignable< K >::value;
+  public:
+    typedef typename Base::size_type size_type;
+    typedef typename Base::value_type value_type;
+
+    typedef Allocator allocator_type;
+
+    //! Constructor making empty vector
+    explicit SmallDynamicVector(const allocator_type &a = allocator_type() ) :
+      _size(0), _heap( a )
+    {
+      update();
+    }
+
+    explicit SmallDynamicVector(size_type n, const allocator_type &a = allocator_type() ) :
+      _size(0), _heap( a )
+    {
+      update();
+      resize(n);
+    }
+
+    //! Constructor making vector with identical coordinates
+    SmallDynamicVector( size_type n, value_type c, const allocator_type &a = allocator_type() ) :
+      _size(0), _heap( a )
+    {
+      update();
+      resize(n,c);
+    }
+
+    /** \brief Construct from a std::initializer_list */
+    SmallDynamicVector (std::initializer_list<K> const &l) :
+      _size(0)
+    {
+      assign(l.begin(), l.end(), l.size());
+    }
+
+    //! Copy constructor
+    SmallDynamicVector(const SmallDynamicVector & x) :
+      Base(), _size(0),
+      _heap(std::allocator_traits< Allocator >::select_on_container_copy_construction(x._heap.get_allocator()))
+    {
+      assign(x._data, x._data + x._size, x._size);
+    }
+
+    //! Move constructor
+    SmallDynamicVector(SmallDynamicVector && x) noexcept(nothrowMove) :
+      _size(0), _heap(x._heap.get_allocator())
+    {
+      steal(x);
+    }
+
+    //! Copy constructor from another DenseVector
+    template< class X >
+    SmallDynamicVector(const DenseVector< X > & x, const allocator_type &a = allocator_type() ) :
+      _size(0), _heap(a)
+    {
+      const size_type n = x.size();
+      update();
+      resize(n);
+      for( size_type i =0; i<n ;++i)
+        _data[ i ] = x[ i ];
+    }
+
+    using Base::operator=;
+
+    //! Copy assignment operator
+    SmallDynamicVector &operator=(const SmallDynamicVector &other)
+    {
+      if (this != &other)
+        assign(other._data, other._data + other._size, other._size);
+      return *this;
+    }
+
+    //! Move assignment operator
+    SmallDynamicVector &operator=(SmallDynamicVector &&other)
+      noexcept(nothrowMove && std::is_nothrow_move_assignable< std::vector< K, Allocator > >::value)
+    {
+      if (this != &other)
+        steal(other);
+      return *this;
+    }
+
+    //==== forward some methods of std::vector
+    /** \brief Number of elements for which memory has been allocated.
+
+        capacity() is always greater than or equal to size() and inlineSize.
+     */
+    size_type capacity() const
+    {
+      return std::max< size_type >(inlineSize, _heap.capacity());
+    }
+
+    void resize (size_type n, value_type c = value_type() )
+    {
+      if (n <= size_type(inlineSize))
+      {
+        if (!_heap.empty())
+        {
+          // move back into the inline storage
+          std::move(_heap.begin(), _heap.begin() + std::min(n, _size), _inline);
+          _heap.clear();
+        }
+        std::fill(_inline + std::min(n, _size), _inline + n, c);
+      }
+      else
+      {
+        if (_heap.empty())
+        {
+          _heap.reserve(n);
+          _heap.insert(_heap.end(),
+                       std::make_move_iterator(_inline),
+                       std::make_move_iterator(_inline + _size));
+        }
+        _heap.resize(n,c);
+      }
+      _size = n;
+      update();
+    }
+
+    void reserve (size_type n)
+    {
+      if (n > size_type(inlineSize))
+      {
+        _heap.reserve(n);
+        update();
+      }
+    }
+
+    //! Returns true if the entries are stored without dynamic memory allocation.
+    bool isInline() const
+    {
+      return _heap.empty();
+    }
+
+    //==== make this thing a vector
+    size_type size() const { return _size; }
+    K & operator[](size_type i) {
+      DUNE_ASSERT_BOUNDS(i < size());
+      return _data[i];
+    }
+    const K & operator[](size_type i) const {
+      DUNE_ASSERT_BOUNDS(i < size());
+      return _data[i];
+    }
+
+  private:
+    // point _data to the storage currently in use
+    void update()
+    {
+      _data = _heap.empty() ? _inline : _heap.data();
+    }
+
+    template< class It >
+    void assign(It first, It last, size_type n)
+    {
+      if (n <= size_type(inlineSize))
+      {
+        _heap.clear();
+        std::copy(first, last, _inline);
+      }
+      else
+        _heap.assign(first, last);
+      _size = n;
+      update();
+    }
+
+    void steal(SmallDynamicVector &other)
+    {
+      if (other._heap.empty())
+      {
+        _heap.clear();
+        std::move(other._inline, other._inline + other._size, _inline);
+      }
+      else
+        _heap = std::move(other._heap);
+      _size = other._size;
+      update();
+      other._heap.clear();
+      other._size = 0;
+      other.update();
+    }
+
+    size_type _size;
+    K* _data;
+    std::vector< K, Allocator > _heap;
+    K _inline[inlineSize];
+  };
+
+  /** \brief Read a SmallDynamicVector from an input stream
+   *  \relates SmallDynamicVector
+   *
+   *  \note This operator is STL compilant, i.e., the content of v is only
+   *        changed if the read operation is successful.
+   *
+   *  \param[in]  in  std :: istream to read from
+   *  \param[out] v   SmallDynamicVector to be read
+   *
+   *  \returns the input stream (in)
+   */
+  template< class K, int inlineSize, class Allocator >
+  inline std::istream &operator>> ( std::istream &in,
+                                    SmallDynamicVector< K, inlineSize, Allocator > &v )
+  {
+    SmallDynamicVector< K, inlineSize, Allocator > w(v);
+    for( typename SmallDynamicVector< K, inlineSize, Allocator >::size_type i = 0; i < w.size(); ++i )
+      in >> w[ i ];
+    if(in)
+      v = std::move(w);
+    return in;
+  }
+
+  /** @} end documentation */
+
+} // end namespace
+
+#endif
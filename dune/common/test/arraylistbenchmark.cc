@@ -0,0 +1,80 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+// Times the ParallelIndexSet build path, which stores its indices in an
+// ArrayList, and copying, erasing and purging a large ArrayList.
+//
+// usage: arraylistbenchmark [indices] [runs]
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include <dune/common/arraylist.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/localindex.hh>
+#include <dune/common/timer.hh>
+
+int main(int argc, char** argv)
+{
+  const int indices = argc > 1 ? std::atoi(argv[1]) : 50000;
+  const int runs = argc > 2 ? std::atoi(argv[2]) : 15;
+
+  double build = 1e100, copy = 1e100, move = 1e100;
+  std::size_t checksum = 0;
+  for (int run = 0; run < runs; ++run)
+  {
+    // 10 resize steps, each merging new indices into the set
+    Dune::Timer timer;
+    for (int rep = 0; rep < 5; ++rep)
+    {
+      Dune::ParallelIndexSet<int,Dune::LocalIndex,100> indexSet;
+      for (int step = 0; step < 10; ++step)
+      {
+        indexSet.beginResize();
+        for (int i = 0; i < indices; ++i)
+          indexSet.add(step + 10*i, Dune::LocalIndex(i));
+        indexSet.endResize();
+      }
+      checksum += indexSet.size();
+    }
+    build = std::min(build, timer.elapsed());
+
+    timer.reset();
+    for (int rep = 0; rep < 50; ++rep)
+    {
+      Dune::ArrayList<double,16> list, copied;
+      for (int i = 0; i < 2*indices; ++i)
+        list.push_back(i);
+      copied = list;
+      auto it = copied.begin();
+      it += indices;
+      it.eraseToHere();
+      copied.purge();
+      checksum += copied.size();
+    }
+    copy = std::min(copy, timer.elapsed());
+
+    timer.reset();
+    for (int rep = 0; rep < 50; ++rep)
+    {
+      Dune::ArrayList<double,16> list;
+      for (int i = 0; i < 2*indices; ++i)
+        list.push_back(i);
+      Dune::ArrayList<double,16> moved(std::move(list));
+      checksum += moved.size();
+    }
+    move = std::min(move, timer.elapsed());
+  }
+
+  std::cout << "best of " << runs << " runs:\n"
+            << "ParallelIndexSet, 5 times 10 resize steps: " << build << " s\n"
+            << "ArrayList fill, copy, erase and purge, 50 times: " << copy << " s\n"
+            << "ArrayList fill and move, 50 times: " << move << " s\n"
+            << "(checksum " << checksum << ")" << std::endl;
+  return 0;
+}
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <utility>
 
 class Double {
 public:
@@ -170,6 +171,46 @@ int testComparison(){
   return 0;
 }
 
+int testCopyAndMove(){
+  using namespace Dune;
+  ArrayList<double,10> alist;
+  alist.reserve(35);
+  initConsecutive(alist);
+
+  ArrayList<double,10>::iterator iter=alist.begin();
+  iter+=14;
+  iter.eraseToHere();
+
+  // copies do not share their entries
+  ArrayList<double,10> copy(alist);
+  copy[0]=-1;
+  if(copy.size()!=alist.size() || alist[0]!=15 || copy[1]!=16) {
+    std::cerr<<"Copying failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+
+  ArrayList<double,10> moved(std::move(copy));
+  if(copy.size()!=0 || moved.size()!=85 || moved[0]!=-1 || moved[84]!=99) {
+    std::cerr<<"Moving failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+
+  copy=std::move(moved);
+  copy.push_back(alist.begin(), alist.end());
+  copy.push_back(100.0);
+  if(copy.size()!=171 || copy[85]!=15 || copy[170]!=100) {
+    std::cerr<<"Appending a range failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+
+  moved=copy;
+  moved.purge();
+  if(moved.size()!=171 || *(moved.begin())!=-1 || copy[0]!=-1) {
+    std::cerr<<"Assignment failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+  return 0;
+}
 
 int main(){
   using namespace Dune;
@@ -199,6 +240,11 @@ int main(){
     ret++;
     cerr<< "Erasing failed!"<<endl;
   }
+
+  if(0!=testCopyAndMove()) {
+    ret++;
+    cerr<< "Copying and moving failed!"<<endl;
+  }
   return ret;
 
 }
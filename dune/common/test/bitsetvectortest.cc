@@ -181,8 +181,78 @@ void doTest() {
 #endif
 }
 
+template<int block_size>
+void testBitOperations() {
+  typedef Dune::BitSetVector<block_size> BBF;
+  typedef typename BBF::value_type bitset;
+
+  const int n = 37;
+  BBF a(n), b(n, true);
+  assert(a.count() == 0);
+  assert(b.count() == std::size_t(n*block_size));
+
+  // set a pattern bit by bit and compare against std::bitset
+  std::vector<bitset> reference(n);
+  for (int i=0; i<n; ++i)
+    for (int j=0; j<block_size; ++j)
+      if ((i*7+j*3)%5 == 0) {
+        a[i][j] = true;
+        reference[i].set(j);
+      }
+
+  std::size_t total = 0;
+  for (int i=0; i<n; ++i) {
+    assert(a[i] == reference[i]);
+    assert(a[i].count() == reference[i].count());
+    assert(a[i].any() == reference[i].any());
+    assert(a[i].all() == reference[i].all());
+    assert(bitset(a[i]) == reference[i]);
+    total += reference[i].count();
+  }
+  assert(a.count() == total);
+
+  // iterate over the set bits
+  std::size_t visited = 0;
+  a.forEachSetBit([&](std::size_t i, std::size_t j) {
+      assert(reference[i].test(j));
+      ++visited;
+    });
+  assert(visited == total);
+
+  // whole vector operations
+  BBF c = ~a;
+  assert(c.count() == std::size_t(n*block_size) - total);
+  assert((a & c).count() == 0);
+  assert((a | c).count() == std::size_t(n*block_size));
+  assert((a ^ b) == c);
+  c &= a;
+  assert(c.count() == 0);
+
+  // block operations
+  b[1] = a[2];
+  assert(b[1] == reference[2]);
+  b[1] ^= reference[3];
+  assert(b[1] == (reference[2] ^ reference[3]));
+  b[2].reset();
+  assert(b[2].none());
+  b[2].flip();
+  assert(b[2].all());
+
+  // resizing keeps the tail clean
+  b.resize(n+3, false);
+  assert(b[n].none() && b[n+2].none());
+  b.resize(n+5, true);
+  assert(b[n+2].none() && b[n+3].all() && b[n+4].all());
+  DUNE_UNUSED_PARAMETER(visited);
+}
+
 int main()
 {
+  testBitOperations<1>();
+  testBitOperations<3>();
+  testBitOperations<64>();
+  testBitOperations<100>();
+
   doTest<4, std::allocator<bool> >();
 #if defined(__GNUC__) && ! defined(__clang__)
   doTest<4, __gnu_cxx::malloc_allocator<bool> >();
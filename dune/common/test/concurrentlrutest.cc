@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <dune/common/concurrentlru.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/test/testsuite.hh>
+
+void sequentialTest(Dune::TestSuite & test)
+{
+  std::atomic<int> evicted(0);
+  Dune::concurrent_lru<int, double> cache(8, 2,
+    [&](const int &, double &) { ++evicted; });
+  test.check(cache.capacity() == 8 && cache.shards() == 2);
+
+  double value = 0;
+  test.check(!cache.find(1, value));
+  cache.insert(1, 1.5);
+  test.check(cache.find(1, value) && value == 1.5);
+  test.check(cache.touch(1) == 1.5);
+
+  bool thrown = false;
+  try {
+    cache.touch(2);
+  }
+  catch (Dune::RangeError &) {
+    thrown = true;
+  }
+  test.check(thrown) << "touching a missing key should throw";
+
+  int calls = 0;
+  auto compute = [&]() { ++calls; return 2.5; };
+  test.check(cache.get_or_compute(2, compute) == 2.5);
+  test.check(cache.get_or_compute(2, compute) == 2.5);
+  test.check(calls == 1) << "value computed " << calls << " times";
+
+  auto stats = cache.stats();
+  test.check(stats.hits == 3 && stats.misses == 3 && stats.evictions == 0);
+
+  for (int k = 0; k < 100; ++k)
+    cache.insert(k, k);
+  test.check(cache.size() <= cache.capacity());
+  test.check(cache.stats().evictions == std::size_t(evicted));
+  test.check(evicted == 100 - int(cache.size()));
+
+  thrown = false;
+  try {
+    cache.get_or_compute(1000, []() -> double { throw std::runtime_error("failed"); });
+  }
+  catch (std::runtime_error &) {
+    thrown = true;
+  }
+  test.check(thrown && !cache.find(1000, value))
+    << "failed computation should not be cached";
+
+  cache.clear();
+  cache.reset_statistics();
+  test.check(cache.size() == 0 && cache.stats().hits == 0);
+}
+
+void concurrentTest(Dune::TestSuite & test)
+{
+  const int threads = 4;
+  const int keys = 64;
+  // room for all keys even if they end up in the same shard
+  Dune::concurrent_lru<int, int> cache(4*keys, 4);
+  std::vector<std::atomic<int> > computed(keys);
+  for (auto & c : computed)
+    c = 0;
+
+  std::atomic<bool> correct(true);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&, t]()
+      {
+        for (int i = 0; i < 10000; ++i)
+        {
+          const int k = (i * 7 + t) % keys;
+          const int v = cache.get_or_compute(k, [&]()
+            {
+              ++computed[k];
+              std::this_thread::yield();
+              return 3*k;
+            });
+          int found;
+          if (v != 3*k || (cache.find(k, found) && found != 3*k))
+            correct = false;
+        }
+      });
+  for (auto & w : workers)
+    w.join();
+
+  test.check(correct) << "wrong value returned";
+  bool once = true;
+  for (auto & c : computed)
+    once = once && c == 1;
+  // no key is evicted, so each is computed exactly once
+  test.check(once) << "concurrent misses were not deduplicated";
+  auto stats = cache.stats();
+  test.check(stats.misses == std::size_t(keys) && stats.evictions == 0);
+}
+
+int main()
+{
+  Dune::TestSuite test;
+  sequentialTest(test);
+  concurrentTest(test);
+  return test.exit();
+}
@@ -0,0 +1,87 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+// Compares the run time of allocation heavy containers using
+// std::allocator, FastDebugAllocator and DebugAllocator.
+//
+// usage: debugallocatorbenchmark [entries] [rounds]
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <dune/common/debugallocator.hh>
+#include <dune/common/timer.hh>
+
+// Builds a map, a list and vectors of varying size, touches all entries and frees them again
+template<template<class> class Allocator>
+double workload(int entries, int rounds)
+{
+  typedef std::map<int, double, std::less<int>, Allocator<std::pair<const int, double> > > Map;
+  typedef std::list<double, Allocator<double> > List;
+  typedef std::vector<double, Allocator<double> > Vector;
+
+  double sum = 0;
+  for (int r = 0; r < rounds; ++r)
+  {
+    Map map;
+    List list;
+    std::vector<Vector, Allocator<Vector> > vectors;
+    for (int i = 0; i < entries; ++i)
+    {
+      map[(i * 7919) % entries] = i;
+      list.push_back(i);
+      if (i % 16 == 0)
+        vectors.emplace_back(i % 1024, 1.0);
+    }
+    for (const auto& entry : map)
+      sum += entry.second;
+    for (double v : list)
+      sum += v;
+    for (const auto& v : vectors)
+      for (double x : v)
+        sum += x;
+  }
+  return sum;
+}
+
+template<template<class> class Allocator>
+double measure(const char* name, int entries, int rounds, double reference)
+{
+  Dune::Timer timer;
+  const double sum = workload<Allocator>(entries, rounds);
+  const double time = timer.elapsed();
+  std::cout << name << ": " << time << " s";
+  if (reference > 0)
+    std::cout << ", " << 100 * (time / reference - 1) << " % overhead";
+  std::cout << " (checksum " << sum << ")" << std::endl;
+  return time;
+}
+
+int main(int argc, char** argv)
+{
+  const int entries = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  const double reference = measure<std::allocator>("std::allocator", entries, rounds, 0);
+
+  Dune::DebugMemory::fast_allocation_manager().setSampleRate(1000);
+  measure<Dune::FastDebugAllocator>("FastDebugAllocator, sample rate 1000", entries, rounds, reference);
+  Dune::DebugMemory::fast_allocation_manager().setSampleRate(0);
+  measure<Dune::FastDebugAllocator>("FastDebugAllocator, no sampling", entries, rounds, reference);
+
+  // one page per allocation, thus only a fraction of the work
+  const int fraction = 10;
+  const double time = measure<Dune::DebugAllocator>("DebugAllocator, a tenth of the entries",
+                                                    entries / fraction, rounds, 0);
+  std::cout << "DebugAllocator, extrapolated: " << fraction * time << " s, "
+            << 100 * (fraction * time / reference - 1) << " % overhead" << std::endl;
+  return 0;
+}
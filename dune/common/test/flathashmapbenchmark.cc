@@ -0,0 +1,103 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+// Compares std::unordered_map and FlatHashMap with long keys: inserting
+// all keys, looking up keys of which half are missing, iterating over
+// the map, and copying the map and erasing every second key. Random and
+// sequential keys are measured separately.
+//
+// usage: flathashmapbenchmark [keys] [lookups] [runs]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <dune/common/flathashmap.hh>
+#include <dune/common/timer.hh>
+
+// Returns the best run time of f
+template<class F>
+double best(int runs, F&& f)
+{
+  double time = 1e100;
+  for (int run = 0; run < runs; ++run)
+  {
+    Dune::Timer timer;
+    f();
+    time = std::min(time, timer.elapsed());
+  }
+  return time;
+}
+
+template<class Map>
+void measure(const char* name, const std::vector<long>& keys,
+             const std::vector<long>& lookups, int runs)
+{
+  unsigned long sum = 0;
+  const double insert = best(runs, [&] {
+      Map map;
+      for (long key : keys)
+        map[key] = key;
+      sum += map.size();
+    });
+
+  Map map;
+  for (long key : keys)
+    map[key] = key;
+
+  const double find = best(runs, [&] {
+      for (long key : lookups)
+      {
+        auto it = map.find(key);
+        if (it != map.end())
+          sum += it->second;
+      }
+    });
+  const double iterate = best(runs, [&] {
+      for (const auto& entry : map)
+        sum += entry.second;
+    });
+  const double erase = best(runs, [&] {
+      Map copy(map);
+      for (std::size_t i = 0; i < keys.size(); i += 2)
+        copy.erase(keys[i]);
+      sum += copy.size();
+    });
+
+  std::cout << "  " << name << ": insert " << insert << " s, find " << find
+            << " s, iterate " << iterate << " s, copy and erase " << erase
+            << " s (checksum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t size = argc > 1 ? std::atol(argv[1]) : 1000000;
+  const std::size_t lookups = argc > 2 ? std::atol(argv[2]) : 4*size;
+  const int runs = argc > 3 ? std::atoi(argv[3]) : 3;
+
+  std::cout << "best of " << runs << " runs, " << size << " keys, "
+            << lookups << " lookups" << std::endl;
+
+  std::mt19937_64 generator(1);
+  for (bool sequential : { false, true })
+  {
+    std::vector<long> keys(size), queries(lookups);
+    for (std::size_t i = 0; i < size; ++i)
+      keys[i] = sequential ? long(i) : long(generator() >> 1);
+    // half of the lookups hit, the others most likely miss
+    for (long& query : queries)
+      query = (generator() & 1) ? keys[generator() % size] : long(generator() >> 1);
+
+    std::cout << (sequential ? "sequential keys" : "random keys") << std::endl;
+    measure<std::unordered_map<long,long> >("std::unordered_map", keys, queries, runs);
+    measure<Dune::FlatHashMap<long,long> >("FlatHashMap", keys, queries, runs);
+  }
+  return 0;
+}
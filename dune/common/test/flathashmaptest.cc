@@ -0,0 +1,222 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/flathashmap.hh>
+#include <dune/common/test/iteratortest.hh>
+#include <dune/common/test/testsuite.hh>
+
+// a hash function putting all keys into the same bucket
+struct ConstantHash
+{
+  std::size_t operator()(int) const { return 42; }
+};
+
+template<class Map, class Reference>
+bool sameEntries(const Map& map, const Reference& reference)
+{
+  if (map.size() != reference.size())
+    return false;
+  std::size_t n = 0;
+  for (const auto& entry : map)
+  {
+    auto it = reference.find(entry.first);
+    if (it == reference.end() || it->second != entry.second)
+      return false;
+    ++n;
+  }
+  return n == reference.size();
+}
+
+void testRandomOperations(Dune::TestSuite& test)
+{
+  Dune::FlatHashMap<int, std::string> map;
+  std::unordered_map<int, std::string> reference;
+  std::mt19937 rng(17);
+  std::uniform_int_distribution<int> key(0, 2000);
+  bool consistent = true;
+  for (int i = 0; i < 50000; ++i)
+  {
+    const int k = key(rng);
+    switch (i % 5)
+    {
+    case 0 :
+    case 1 :
+      consistent &= (map.insert(std::make_pair(k, std::to_string(i))).second
+                     == reference.insert(std::make_pair(k, std::to_string(i))).second);
+      break;
+    case 2 :
+      map[k] = std::to_string(-i);
+      reference[k] = std::to_string(-i);
+      break;
+    case 3 :
+      consistent &= (map.erase(k) == reference.erase(k));
+      break;
+    case 4 :
+      consistent &= (map.count(k) == reference.count(k));
+      break;
+    }
+  }
+  test.check(consistent) << "FlatHashMap disagrees with std::unordered_map";
+  test.check(sameEntries(map, reference));
+  test.check(map.load_factor() <= map.max_load_factor());
+
+  // erase during iteration
+  for (auto it = map.begin(); it != map.end(); )
+    if (it->first % 3 == 0)
+      it = map.erase(it);
+    else
+      ++it;
+  for (auto it = reference.begin(); it != reference.end(); )
+    if (it->first % 3 == 0)
+      it = reference.erase(it);
+    else
+      ++it;
+  test.check(sameEntries(map, reference)) << "erasing while iterating failed";
+
+  // copies and moves
+  Dune::FlatHashMap<int, std::string> copy(map);
+  test.check(copy == map);
+  copy[-1] = "new";
+  test.check(copy != map && copy.size() == map.size() + 1);
+  Dune::FlatHashMap<int, std::string> moved(std::move(copy));
+  test.check(copy.empty() && moved.at(-1) == "new");
+  copy = moved;
+  moved = std::move(map);
+  test.check(map.empty() && sameEntries(moved, reference));
+  map.swap(moved);
+  test.check(moved.empty() && sameEntries(map, reference));
+
+  map.clear();
+  test.check(map.empty() && map.begin() == map.end());
+}
+
+void testReserve(Dune::TestSuite& test)
+{
+  Dune::FlatHashMap<int, double> map;
+  test.check(map.bucket_count() == 0 && map.find(1) == map.end());
+  map.reserve(1000);
+  const std::size_t buckets = map.bucket_count();
+  test.check(buckets >= 1000 && (buckets & (buckets-1)) == 0)
+    << "bucket count " << buckets << " is no power of two";
+  for (int i = 0; i < 1000; ++i)
+    map.try_emplace(i, 0.5*i);
+  test.check(map.bucket_count() == buckets) << "reserved table was rehashed";
+  map.rehash(4*buckets);
+  test.check(map.bucket_count() == 4*buckets && map.size() == 1000);
+  bool found = true;
+  for (int i = 0; i < 1000; ++i)
+    found &= (map.at(i) == 0.5*i);
+  test.check(found);
+
+  map.max_load_factor(0.5);
+  test.check(map.load_factor() <= 0.5);
+
+  bool thrown = false;
+  try {
+    map.at(-1);
+  }
+  catch (Dune::RangeError&) {
+    thrown = true;
+  }
+  test.check(thrown) << "at() did not throw for missing key";
+
+  auto result = map.insert_or_assign(3, 7.0);
+  test.check(!result.second && map[3] == 7.0);
+}
+
+void testSet(Dune::TestSuite& test)
+{
+  Dune::FlatHashSet<int> set = { 5, 3, 5, 8 };
+  std::unordered_set<int> reference = { 5, 3, 8 };
+  test.check(set.size() == 3);
+  for (int i = 0; i < 10000; i += 7)
+  {
+    set.insert(i);
+    reference.insert(i);
+  }
+  for (int i = 0; i < 10000; i += 11)
+    test.check(set.erase(i) == reference.erase(i));
+  bool same = set.size() == reference.size();
+  for (int i : set)
+    same &= (reference.count(i) == 1);
+  test.check(same) << "FlatHashSet disagrees with std::unordered_set";
+  Dune::FlatHashSet<int> copy(set.begin(), set.end());
+  test.check(copy == set);
+  test.check(*set.find(7) == 7 && set.find(11) == set.end());
+  const Dune::FlatHashSet<int>& constSet = set;
+  Printer<const int> print;
+  test.check(testIterator(constSet, print) == 0);
+}
+
+void testCollisions(Dune::TestSuite& test)
+{
+  // identity hashes of multiples of a power of two are spread by the table
+  Dune::FlatHashMap<long, int> map;
+  for (long i = 0; i < 100000; ++i)
+    map[i << 20] = int(i);
+  test.check(map.size() == 100000 && map.at(99999l << 20) == 99999);
+
+  // a constant hash function is rejected instead of growing without bound
+  Dune::FlatHashMap<int, int, ConstantHash> bad;
+  bool thrown = false;
+  int inserted = 0;
+  try {
+    for (; inserted < 10000; ++inserted)
+      bad[inserted] = inserted;
+  }
+  catch (Dune::RangeError&) {
+    thrown = true;
+  }
+  test.check(thrown) << "constant hash function was not detected";
+  bool intact = bad.size() == std::size_t(inserted);
+  for (int i = 0; i < inserted; ++i)
+    intact &= (bad.at(i) == i);
+  test.check(intact) << "table was corrupted by a failed insertion";
+}
+
+void testSelfReference(Dune::TestSuite& test)
+{
+  // the inserted values refer into the map, also when the insertion rehashes
+  const std::string value(100, 'x');
+  Dune::FlatHashMap<int, std::string> map;
+  map[0] = value;
+  bool rehashed = false;
+  bool intact = true;
+  for (int i = 1; i <= 200; ++i)
+  {
+    const std::size_t buckets = map.bucket_count();
+    if (i % 3 == 0)
+      map.try_emplace(i, map.at(i-1));
+    else if (i % 3 == 1)
+      map.insert_or_assign(i, map.at(i-1));
+    else
+      map.emplace(i, map.at(0));
+    rehashed |= map.bucket_count() != buckets;
+  }
+  for (const auto& entry : map)
+    intact &= (entry.second == value);
+  test.check(rehashed && intact && map.size() == 201)
+    << "inserting a reference into the map failed";
+}
+
+int main()
+{
+  Dune::TestSuite test;
+  testRandomOperations(test);
+  testReserve(test);
+  testSet(test);
+  testCollisions(test);
+  testSelfReference(test);
+  return test.exit();
+}
@@ -0,0 +1,154 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/flatmap.hh>
+#include <dune/common/test/testsuite.hh>
+
+template<class Map, class Reference>
+bool sameEntries(const Map& map, const Reference& reference)
+{
+  if (map.size() != reference.size())
+    return false;
+  auto it = reference.begin();
+  for (const auto& entry : map)
+  {
+    if (entry.first != it->first || entry.second != it->second)
+      return false;
+    ++it;
+  }
+  return true;
+}
+
+void testRandomOperations(Dune::TestSuite& test)
+{
+  Dune::FlatMap<int, std::string> map;
+  std::map<int, std::string> reference;
+  std::mt19937 rng(17);
+  std::uniform_int_distribution<int> key(0, 500);
+  bool consistent = true;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int k = key(rng);
+    switch (i % 5)
+    {
+    case 0 :
+    case 1 :
+      consistent &= (map.insert(std::make_pair(k, std::to_string(i))).second
+                     == reference.insert(std::make_pair(k, std::to_string(i))).second);
+      break;
+    case 2 :
+      map[k] = std::to_string(-i);
+      reference[k] = std::to_string(-i);
+      break;
+    case 3 :
+      consistent &= (map.erase(k) == reference.erase(k));
+      break;
+    case 4 :
+      consistent &= (map.count(k) == reference.count(k));
+      consistent &= ((map.lower_bound(k) == map.end()) == (reference.lower_bound(k) == reference.end()));
+      consistent &= ((map.upper_bound(k) == map.end()) == (reference.upper_bound(k) == reference.end()));
+      break;
+    }
+  }
+  test.check(consistent) << "FlatMap and std::map disagree on the result of an operation";
+  test.check(sameEntries(map, reference)) << "FlatMap and std::map differ after random operations";
+
+  // erase every other entry while iterating
+  for (auto it = map.begin(); it != map.end(); )
+  {
+    it = map.erase(it);
+    if (it != map.end())
+      ++it;
+  }
+  for (auto it = reference.begin(); it != reference.end(); )
+  {
+    it = reference.erase(it);
+    if (it != reference.end())
+      ++it;
+  }
+  test.check(sameEntries(map, reference)) << "Erasing while iterating failed";
+}
+
+void testConstruction(Dune::TestSuite& test)
+{
+  typedef Dune::FlatMap<int, int> Map;
+  std::vector<std::pair<int, int> > sorted;
+  for (int i = 0; i < 10; ++i)
+    sorted.emplace_back(2*i, i);
+
+  Map fromSorted(Dune::SortedUnique(), sorted.begin(), sorted.end());
+  test.check(fromSorted.size() == 10 && fromSorted.find(8)->second == 4)
+    << "Construction from sorted input failed";
+
+  // duplicates keep the first occurrence
+  Map fromList{{3, 1}, {1, 2}, {3, 3}, {2, 4}};
+  test.check(fromList.size() == 3 && fromList.at(3) == 1 && fromList.begin()->first == 1)
+    << "Construction from unsorted input failed";
+
+  std::vector<std::pair<int, int> > more = {{1, 0}, {4, 0}, {19, 0}, {30, 0}};
+  fromSorted.insert(Dune::SortedUnique(), more.begin(), more.end());
+  test.check(fromSorted.size() == 13 && fromSorted.at(4) == 2 && fromSorted.at(30) == 0 && fromSorted.at(18) == 9)
+    << "Inserting sorted input failed";
+  test.check(std::is_sorted(fromSorted.begin(), fromSorted.end(), fromSorted.value_comp()))
+    << "Inserting sorted input left the map unsorted";
+
+  Map moved(Dune::SortedUnique(), std::move(sorted));
+  test.check(moved.size() == 10) << "Construction from a sorted vector failed";
+
+  Map reserved;
+  reserved.reserve(32);
+  test.check(reserved.capacity() >= 32) << "reserve did not allocate";
+  for (int i = 0; i < 32; ++i)
+    reserved.emplace_hint(reserved.end(), i, -i);
+  test.check(reserved.capacity() == 32 && reserved.at(31) == -31)
+    << "Appending in order reallocated or failed";
+
+  auto range = reserved.equal_range(7);
+  test.check(range.first != range.second && range.first->first == 7
+             && std::next(range.first) == range.second) << "equal_range failed";
+  range = reserved.equal_range(40);
+  test.check(range.first == range.second) << "equal_range of missing key is not empty";
+
+  Map copy = reserved;
+  test.check(copy == reserved) << "Copies are not equal";
+  copy.insert_or_assign(3, 4);
+  test.check(copy != reserved && copy.at(3) == 4) << "insert_or_assign failed";
+  bool thrown = false;
+  try {
+    copy.at(100);
+  }
+  catch (Dune::RangeError&) {
+    thrown = true;
+  }
+  test.check(thrown) << "at() did not throw for missing key";
+}
+
+void testCompare(Dune::TestSuite& test)
+{
+  Dune::FlatMap<int, int, std::greater<int> > map;
+  for (int i = 0; i < 5; ++i)
+    map[i] = i;
+  test.check(map.begin()->first == 4 && map.rbegin()->first == 0)
+    << "Custom comparison not respected";
+}
+
+int main()
+{
+  Dune::TestSuite test;
+  testRandomOperations(test);
+  testConstruction(test);
+  testCompare(test);
+  return test.exit();
+}
@@ -0,0 +1,159 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/test/testsuite.hh>
+
+namespace ns {
+
+  template<typename T>
+  struct Index
+  {
+    T global;
+    T local;
+
+    friend bool operator==(const Index& a, const Index& b)
+    {
+      return a.global == b.global && a.local == b.local;
+    }
+  };
+
+  struct Point
+  {
+    double x, y;
+
+    friend std::size_t hash_value(const Point& p)
+    {
+      std::size_t seed = 0;
+      Dune::hash_combine(seed,p.x);
+      Dune::hash_combine(seed,p.y);
+      return seed;
+    }
+  };
+
+}
+
+DUNE_DEFINE_BYTEWISE_HASH(DUNE_HASH_TEMPLATE_ARGS(typename T),DUNE_HASH_TYPE(ns::Index<T>))
+DUNE_DEFINE_HASH(DUNE_HASH_TEMPLATE_ARGS(),DUNE_HASH_TYPE(ns::Point))
+
+int main()
+{
+  Dune::TestSuite test;
+
+  static_assert(Dune::IsBytewiseHashable<int>::value, "int should be hashed bytewise");
+  static_assert(!Dune::IsBytewiseHashable<double>::value, "double must not be hashed bytewise");
+  static_assert(!Dune::IsBytewiseHashable<ns::Point>::value, "Point must not be hashed bytewise");
+  static_assert(Dune::IsBytewiseHashable<ns::Index<std::int64_t> >::value,
+                "Index should be hashed bytewise");
+
+  // hash_bytes depends on every byte, the length and the seed
+  {
+    std::vector<unsigned char> bytes(200);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+      bytes[i] = static_cast<unsigned char>(i*37);
+    std::set<std::size_t> values;
+    std::size_t count = 0;
+    for (std::size_t len = 0; len <= bytes.size(); ++len)
+    {
+      values.insert(Dune::hash_bytes(bytes.data(),len));
+      ++count;
+    }
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+      std::vector<unsigned char> flipped(bytes);
+      flipped[i] ^= 1;
+      values.insert(Dune::hash_bytes(flipped.data(),flipped.size()));
+      ++count;
+    }
+    values.insert(Dune::hash_bytes(bytes.data(),bytes.size(),1));
+    ++count;
+    test.check(values.size() == count) << "hash_bytes produced collisions";
+    test.check(Dune::hash_bytes(bytes.data(),bytes.size())
+               == Dune::hash_bytes(bytes.data(),bytes.size()));
+  }
+
+  // contiguous ranges of integers take the bytewise path
+  {
+    std::vector<int> v = { 1, 2, 3, 4, 5, 6, 7 };
+    const std::array<int,7> a = {{ 1, 2, 3, 4, 5, 6, 7 }};
+    test.check(Dune::hash_range(v.data(),v.data()+v.size())
+               == Dune::hash_bytes(v.data(),v.size()*sizeof(int)));
+    test.check(Dune::hash_range(v.data(),v.data()+v.size())
+               == Dune::hash_range(a.data(),a.data()+a.size()));
+    std::size_t seed = 42;
+    Dune::hash_range(seed,v.data(),v.data()+v.size());
+    test.check(seed == Dune::hash_bytes(v.data(),v.size()*sizeof(int),42));
+    v[3] = 0;
+    test.check(Dune::hash_range(v.data(),v.data()+v.size())
+               != Dune::hash_range(a.data(),a.data()+a.size()));
+
+    // so do the iterators of contiguous containers
+    test.check(Dune::hash_range(v.begin(),v.end())
+               == Dune::hash_bytes(v.data(),v.size()*sizeof(int)));
+    const std::vector<int>& cv = v;
+    test.check(Dune::hash_range(cv.begin(),cv.end()) == Dune::hash_range(v.begin(),v.end()));
+    test.check(Dune::hash_range(a.begin(),a.end())
+               == Dune::hash_bytes(a.data(),a.size()*sizeof(int)));
+    Dune::FieldVector<int,3> fv = { 1, 2, 3 };
+    const Dune::FieldVector<int,3>& cfv = fv;
+    test.check(Dune::hash_range(fv.begin(),fv.end()) == Dune::hash_bytes(&fv[0],3*sizeof(int)));
+    test.check(Dune::hash_range(cfv.begin(),cfv.end()) == Dune::hash_bytes(&fv[0],3*sizeof(int)));
+    Dune::DynamicVector<int> dv(a.size());
+    std::copy(a.begin(),a.end(),dv.begin());
+    test.check(Dune::hash_range(dv.begin(),dv.end())
+               == Dune::hash_bytes(a.data(),a.size()*sizeof(int)));
+    test.check(Dune::hash_range(v.begin(),v.begin()) == Dune::hash_bytes(nullptr,0));
+
+    // other iterators still combine element by element
+    std::list<int> l(a.begin(),a.end());
+    std::size_t combined = 0;
+    for (int i : a)
+      Dune::hash_combine(combined,i);
+    test.check(Dune::hash_range(l.begin(),l.end()) == combined);
+    const std::vector<bool> bits = { true, false, true };
+    combined = 0;
+    for (bool bit : bits)
+      Dune::hash_combine(combined,bit);
+    test.check(Dune::hash_range(bits.begin(),bits.end()) == combined);
+  }
+
+  // floating point ranges combine the element hashes, so 0.0 and -0.0 agree
+  {
+    const double p[2] = { 0.0, 1.0 };
+    const double m[2] = { -0.0, 1.0 };
+    test.check(Dune::hash_range(p,p+2) == Dune::hash_range(m,m+2));
+  }
+
+  // types opting in via DUNE_DEFINE_BYTEWISE_HASH
+  {
+    Dune::hash<ns::Index<std::int64_t> > hasher;
+    const ns::Index<std::int64_t> i0 = { 17, 3 }, i1 = { 17, 3 }, i2 = { 3, 17 };
+    test.check(hasher(i0) == hasher(i1));
+    test.check(hasher(i0) != hasher(i2));
+    std::vector<ns::Index<std::int64_t> > indices = { i0, i2 };
+    test.check(Dune::hash_range(indices.data(),indices.data()+2)
+               == Dune::hash_bytes(indices.data(),2*sizeof(i0)));
+
+    Dune::hash<const ns::Point> phasher;
+    test.check(phasher(ns::Point{1.0,2.0}) == phasher(ns::Point{1.0,2.0}));
+    std::size_t seed = 0;
+    Dune::hash_combine(seed,1.0);
+    Dune::hash_combine(seed,2.0);
+    test.check(phasher(ns::Point{1.0,2.0}) == seed);
+  }
+
+  return test.exit();
+}
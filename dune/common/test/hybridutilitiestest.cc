@@ -5,9 +5,12 @@
 #include "config.h"
 #endif
 
+#include <cmath>
+#include <functional>
 #include <tuple>
 #include <vector>
 
+#include <dune/common/fvector.hh>
 #include <dune/common/hybridutilities.hh>
 #include <dune/common/tuplevector.hh>
 #include <dune/common/test/testsuite.hh>
@@ -68,6 +71,24 @@ auto sumSubsequence(C&& c, I&& indices)
   return result;
 }
 
+template<class C1, class C2>
+auto zippedDot(C1&& c1, C2&& c2)
+{
+  using namespace Dune::Hybrid;
+  return transformReduce(zip(c1, c2), 0.0, std::plus<double>(), [](auto&& a, auto&& b) {
+    return a*b;
+  });
+}
+
+template<class C1, class C2>
+void zippedAdd(C1&& c1, C2&& c2)
+{
+  using namespace Dune::Hybrid;
+  forEach(zip(c1, c2), [](auto&& entries) {
+    std::get<0>(entries) += std::get<1>(entries);
+  });
+}
+
 
 
 int main()
@@ -106,5 +127,40 @@ int main()
   test.check((29*28)/2 == sumSubsequence(values, std::make_integer_sequence<std::size_t, 29>()))
     << "Summing up subsequence failed.";
 
+  auto vector2 = std::vector<double>{1, 2, 3};
+  auto numberTuple2 = Dune::makeTupleVector(1, 2.0, 3);
+  test.check(zippedDot(vector, vector2) == 28)
+    << "transformReduce() over zipped vectors yields incorrect result.";
+  test.check(zippedDot(numberTuple, numberTuple2) == 1.1+8+18)
+    << "transformReduce() over zipped tuples yields incorrect result.";
+  test.check(Dune::Hybrid::transformReduce(values, 0, std::plus<int>(), [](auto i) { return 2*i; }) == 30*29)
+    << "transformReduce() over integer sequence yields incorrect result.";
+
+  zippedAdd(vector, vector2);
+  test.check(vector == std::vector<int>{3, 6, 9})
+    << "Modifying vector entries through Hybrid::zip failed.";
+  zippedAdd(numberTuple, numberTuple2);
+  test.check(numberTuple == Dune::makeTupleVector(2.1, 6, 9))
+    << "Modifying tuple entries through Hybrid::zip failed.";
+
+  using Velocity = Dune::FieldVector<double, 3>;
+  auto x = Dune::makeTupleVector(Velocity{1, 2, 3}, -4.0);
+  auto y = Dune::makeTupleVector(Velocity{1, 0, -1}, 2.0);
+  test.check(x.dot(y) == -10.0)
+    << "TupleVector::dot() yields incorrect result.";
+  test.check(x.two_norm2() == 30.0 && std::abs(x.two_norm() - std::sqrt(30.0)) < 1e-14)
+    << "TupleVector::two_norm() yields incorrect result.";
+  test.check(x.one_norm() == 10.0)
+    << "TupleVector::one_norm() yields incorrect result.";
+  test.check(x.infinity_norm() == 4.0)
+    << "TupleVector::infinity_norm() yields incorrect result.";
+  x.axpy(2.0, y);
+  test.check(x == Dune::makeTupleVector(Velocity{3, 2, 1}, 0.0))
+    << "TupleVector::axpy() failed.";
+
+  auto nested = Dune::makeTupleVector(x, 1.0);
+  test.check(nested.two_norm2() == 15.0)
+    << "Norm of nested TupleVector yields incorrect result.";
+
   return test.exit();
 }
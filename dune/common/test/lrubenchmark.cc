@@ -0,0 +1,67 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+// Compares lru and fixed_lru used as a cache of fixed capacity: random
+// keys are looked up, touched on a hit and inserted on a miss, evicting
+// the least recently used entry once the cache is full.
+//
+// usage: lrubenchmark [operations] [keys] [capacity] [runs]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include <dune/common/lru.hh>
+#include <dune/common/timer.hh>
+
+template<class Cache>
+void measure(const char* name, Cache& cache, std::size_t capacity, int operations, int keys, int runs)
+{
+  double best = 1e100;
+  double sum = 0;
+  // lru has no end(), but keys are non-negative
+  const auto end = cache.find(-1);
+  for (int run = 0; run < runs; ++run)
+  {
+    std::mt19937 generator(run);
+    std::uniform_int_distribution<int> distribution(0, keys - 1);
+    Dune::Timer timer;
+    for (int i = 0; i < operations; ++i)
+    {
+      const int key = distribution(generator);
+      if (cache.find(key) != end)
+        sum += cache.touch(key);
+      else
+      {
+        if (cache.size() == capacity)
+          cache.pop_back();
+        cache.insert(key, key);
+      }
+    }
+    best = std::min(best, timer.elapsed());
+  }
+  std::cout << name << ": " << best << " s (checksum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  const int operations = argc > 1 ? std::atoi(argv[1]) : 2000000;
+  const int keys = argc > 2 ? std::atoi(argv[2]) : 4096;
+  const std::size_t capacity = argc > 3 ? std::atoi(argv[3]) : 1024;
+  const int runs = argc > 4 ? std::atoi(argv[4]) : 5;
+
+  std::cout << "best of " << runs << " runs of " << operations << " operations on "
+            << keys << " keys, capacity " << capacity << std::endl;
+
+  Dune::lru<int,double> lru;
+  measure("lru", lru, capacity, operations, keys, runs);
+
+  Dune::fixed_lru<int,double> fixedLru(capacity);
+  measure("fixed_lru", fixedLru, capacity, operations, keys, runs);
+  return 0;
+}
@@ -2,6 +2,7 @@
 // vi: set et ts=4 sw=2 sts=2:
 #include <assert.h>
 #include <iostream>
+#include <vector>
 #include <dune/common/lru.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
@@ -35,11 +36,91 @@ void lru_test()
   std::cout << "... passed\n";
 }
 
+void fixed_lru_test()
+{
+  std::cout << "testing Dune::fixed_lru<int,double>\n";
+
+  std::vector<int> evicted;
+  Dune::fixed_lru<int, double> lru(5,
+    [&](const int & key, double &) { evicted.push_back(key); });
+  assert(lru.capacity() == 5);
+  lru.insert(10, 1.0);
+  assert(lru.front() == lru.back());
+  lru.insert(11, 2.0);
+  assert(lru.front() == 2.0 && lru.back() == 1.0);
+  lru.insert(12, 99);
+  lru.insert(13, 1.3);
+  lru.insert(14, 12345);
+  assert(lru.size() == 5 && evicted.empty());
+  // evict 10
+  lru.insert(15, -17);
+  assert(lru.size() == 5 && evicted.size() == 1 && evicted[0] == 10);
+  assert(lru.front() == -17 && lru.back() == 2.0);
+  assert(lru.find(10) == lru.end());
+  // update
+  lru.insert(11);
+  assert(lru.front() == 2.0 && lru.back() == 99);
+  // update
+  lru.touch(13);
+  assert(lru.front() == 1.3 && lru.back() == 99);
+  // replace existing entry, no eviction
+  lru.insert(12, 4.0);
+  assert(lru.front() == 4.0 && lru.back() == 12345 && evicted.size() == 1);
+  // remove item
+  lru.pop_front();
+  assert(lru.front() == 1.3 && lru.back() == 12345);
+  assert(lru.find(12) == lru.end());
+  // remove item
+  lru.pop_back();
+  assert(lru.front() == 1.3 && lru.back() == -17 && lru.size() == 3);
+  // iteration goes from most to least recently used
+  const int order[] = { 13, 11, 15 };
+  int i = 0;
+  for (const auto & entry : lru)
+    assert(entry.first == order[i++]);
+  assert(i == 3);
+  assert(lru.find(15)->second == -17);
+  bool thrown = false;
+  try {
+    lru.touch(10);
+  }
+  catch (Dune::RangeError &) {
+    thrown = true;
+  }
+  assert(thrown);
+  lru.clear();
+  assert(lru.size() == 0 && lru.begin() == lru.end());
+
+  // churn through many keys, colliding in the hash table
+  Dune::fixed_lru<int, int> cache(64);
+  for (int k = 0; k < 10000; ++k)
+  {
+    cache.insert(k*1024, k);
+    if (k > 0 && k % 3 == 0)
+      cache.touch((k-1)*1024);
+    assert(cache.find(k*1024) != cache.end());
+    assert(cache.size() == std::min<std::size_t>(k+1, 64));
+  }
+  int found = 0;
+  for (int k = 0; k < 10000; ++k)
+    if (cache.find(k*1024) != cache.end())
+    {
+      assert(cache.find(k*1024)->second == k);
+      ++found;
+    }
+  assert(found == 64);
+  cache.resize(10);
+  assert(cache.size() == 10 && cache.find(9999*1024) != cache.end());
+
+  std::cout << "... passed\n";
+}
+
 int main (int argc, char** argv)
 {
   Dune::MPIHelper::instance(argc,argv);
 
   lru_test();
+  fixed_lru_test();
 
   return 0;
 }
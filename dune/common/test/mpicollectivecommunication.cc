@@ -6,6 +6,7 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/common/parallel/mpicollectivecommunication.hh>
+#include <dune/common/reservedvector.hh>
 #include <dune/common/test/testsuite.hh>
 
 #include <iostream>
@@ -59,6 +60,17 @@ int main(int argc, char** argv)
       t.check(sum == comm.size())
         << "sum of 1 must be equal to number of processes";
     }
+    {
+      // ReservedVector is sent as a whole without packing
+      Dune::ReservedVector<double, 8> rv[2];
+      if (comm.rank() == 0) {
+        rv[0] = {1.0, 2.0, 3.0};
+        rv[1] = {4.0};
+      }
+      comm.broadcast(rv, 2, 0);
+      t.check(rv[0].size() == 3 && rv[0][2] == 3.0 && rv[1].size() == 1 && rv[1][0] == 4.0)
+        << "broadcast of ReservedVector failed";
+    }
   }
 
   std::cout << "We are at the end!"<<std::endl;
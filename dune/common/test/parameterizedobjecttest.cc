@@ -1,6 +1,8 @@
 #include "config.h"
 #include <iostream>
+#include <array>
 #include <cassert>
+#include <numeric>
 #include <tuple>
 #include <dune/common/parametertree.hh>
 #include <dune/common/shared_ptr.hh>
@@ -36,6 +38,21 @@ struct AImp : public InterfaceA
     std::string s_;
 };
 
+struct OrderedKey
+{
+    int id;
+
+    friend bool operator<(const OrderedKey& a, const OrderedKey& b)
+    {
+        return a.id < b.id;
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, const OrderedKey& key)
+    {
+        return s << key.id;
+    }
+};
+
 int main()
 {
     // int as parameter
@@ -97,4 +114,44 @@ int main()
     assert(FactoryC.create("fi", 42)(0) == 42);
     assert(FactoryC.create("fi1", 42)(0) == 43);
 
+    // pre-resolved handles
+    auto handleAi = globalPtrFactory<InterfaceA>().handle("Ai");
+    assert(globalPtrFactory<InterfaceA>().create(handleAi, 0)->info() == "Ai");
+    auto handleFi = FactoryC.handle("fi");
+    assert(FactoryC.create(handleFi, 1)(1) == 2);
+    assert(FactoryC.contains("fi") and not FactoryC.contains("fi2"));
+    bool thrown = false;
+    try {
+        FactoryC.handle("fi2");
+    }
+    catch (Dune::InvalidStateException&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // redefinition keeps existing handles valid
+    FactoryC.define("fi", [](int i) {
+        return [=](double x) { return x-i;};
+    });
+    assert(FactoryC.create(handleFi, 1)(1) == 0);
+    assert(FactoryC.create("fi", 1)(1) == 0);
+
+    // creators too large to be stored in place
+    std::array<double, 16> values;
+    values.fill(1.0);
+    FactoryC.define("sum", [values](int i) {
+        return [=](double x) { return x+i*std::accumulate(values.begin(), values.end(), 0.0);};
+    });
+    auto FactoryCopy = FactoryC;
+    FactoryC.define("sum", [](int) {
+        return [=](double x) { return x;};
+    });
+    assert(FactoryCopy.create("sum", 2)(1) == 33);
+    assert(FactoryC.create("sum", 2)(1) == 1);
+
+    // keys without hash support
+    Dune::ParameterizedObjectFactory<int(), OrderedKey> FactoryOrdered;
+    FactoryOrdered.define(OrderedKey{2}, [](){ return 3;});
+    assert(FactoryOrdered.create(OrderedKey{2}) == 3);
+
 }
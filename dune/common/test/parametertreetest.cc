@@ -9,6 +9,8 @@
 #include <iostream>
 #include <ostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/parametertree.hh>
@@ -252,6 +254,49 @@ void testFS1523()
   check_assert(ptree.get<int>("setting") == -1);
 }
 
+// check that cached conversions and handles follow changes of the values
+void testCache()
+{
+  Dune::ParameterTree ptree;
+  ptree["a.b.x"] = "1";
+  ptree["y"] = "2 3";
+
+  check_assert(ptree.get<int>("a.b.x") == 1);
+  check_assert(ptree.get<double>("a.b.x") == 1.0);
+  check_assert(ptree.get<int>("a.b.x") == 1);
+  check_assert(ptree.get("a.b.x", 5) == 1);
+  check_assert(ptree.get("a.b.z", 5) == 5);
+
+  auto x = ptree.handle<int>("a.b.x");
+  const Dune::ParameterTree& sub = ptree.sub("a");
+  auto subX = sub.handle<double>("b.x");
+  auto y = ptree.handle<std::vector<int> >("y");
+  check_assert(*x == 1 && *subX == 1.0);
+  check_assert(y->size() == 2 && (*y)[1] == 3);
+
+  // writing through the reference invalidates the cached values
+  std::string& value = ptree["a.b.x"];
+  value = "7";
+  check_assert(ptree.get<int>("a.b.x") == 7);
+  check_assert(ptree.get<double>("a.b.x") == 7.0);
+  check_assert(*x == 7 && *subX == 7.0);
+  ptree.sub("a")["b.x"] = "junk";
+  check_throw(ptree.get<int>("a.b.x"), Dune::RangeError);
+  check_throw(*x, Dune::RangeError);
+  ptree["a.b.x"] = "8";
+  check_assert(*x == 8 && ptree.get<int>("a.b.x") == 8);
+
+  // copies do not share the cache
+  Dune::ParameterTree copy = ptree;
+  copy["a.b.x"] = "9";
+  check_assert(copy.get<int>("a.b.x") == 9 && ptree.get<int>("a.b.x") == 8);
+  copy = ptree;
+  check_assert(copy.get<int>("a.b.x") == 8);
+
+  check_throw(ptree.handle<int>("a.b.missing"), Dune::RangeError);
+  check_throw(ptree.handle<int>("y"), Dune::RangeError);
+}
+
 void check_recursiveTreeCompare(const Dune::ParameterTree & p1,
   const Dune::ParameterTree & p2)
 {
@@ -314,6 +359,9 @@ int main()
     // check report
     testReport();
 
+    // check cached conversions
+    testCache();
+
     // check for specific bugs
     testFS1527();
     testFS1523();
@@ -6,12 +6,26 @@
 #endif
 
 #include <iostream>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <dune/common/test/testsuite.hh>
 #include <dune/common/classname.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/reserveddensevector.hh>
 #include <dune/common/reservedvector.hh>
 
+constexpr Dune::ReservedVector<int, 4> makeConstexprVector()
+{
+  Dune::ReservedVector<int, 4> v = {1, 2};
+  v.push_back(3);
+  v.emplace_back(4);
+  v.pop_back();
+  v[0] = 0;
+  return v;
+}
+
 int main() {
   Dune::TestSuite test;
   // check that make_array works
@@ -52,5 +66,46 @@ int main() {
   // try and try again with a const ReservedVector
   std::unordered_map< const Dune::ReservedVector<unsigned int, 8>, double> const_rv_map;
 
-  return 0;
+  // check that the vector may be copied with memcpy
+  static_assert(std::is_trivially_copyable< Dune::ReservedVector<unsigned int, 8> >::value,
+                "ReservedVector of a trivially copyable type must be trivially copyable");
+
+  // check the constexpr interface
+  constexpr auto crv = makeConstexprVector();
+  static_assert(crv.size() == 3 && crv[0] == 0 && crv.back() == 3,
+                "ReservedVector does not work in constant expressions");
+  constexpr Dune::ReservedVector<int, 4> empty{};
+  static_assert(empty.size() == 0 && empty.empty(),
+                "default constructed ReservedVector does not work in constant expressions");
+
+  // the entries beyond size() are value-initialized
+  Dune::ReservedVector<int, 4> zeros;
+  zeros.push_back(1);
+  zeros.resize(4);
+  test.check(zeros[1] == 0 && zeros[3] == 0);
+
+  // check emplace_back and insert
+  Dune::ReservedVector<std::vector<int>, 4> rv3;
+  rv3.emplace_back(2, 1);
+  test.check(rv3.size() == 1 && rv3.back().size() == 2);
+  std::vector<unsigned int> more = {6, 7};
+  auto it = rv2.insert(rv2.begin() + 1, more.begin(), more.end());
+  test.check(rv2.size() == 6 && *it == 6 && rv2[2] == 7 && rv2[3] == 2 && rv2.back() == 4);
+  test.check(rv2.data()[1] == 6);
+
+  // check the DenseVector adapter
+  Dune::ReservedDenseVector<double, 4> dv = {1.0, 2.0};
+  Dune::ReservedDenseVector<double, 4> dw(2, 3.0);
+  dv += dw;
+  test.check(dv.size() == 2 && dv[0] == 4.0 && dv[1] == 5.0);
+  test.check(dv * dw == 27.0);
+  dv.axpy(2.0, dw);
+  test.check(dv.two_norm2() == 221.0);
+  dv.push_back(1.0);
+  test.check(dv.container().size() == 3 && dv.one_norm() == 22.0);
+  Dune::FieldVector<double, 3> fv = {1.0, 1.0, 1.0};
+  Dune::ReservedDenseVector<double, 4> dfv(fv);
+  test.check(dfv.size() == 3 && dfv * fv == 3.0);
+
+  return test.exit();
 }
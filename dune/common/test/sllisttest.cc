@@ -365,6 +365,61 @@ int testPushPop(){
   return ret;
 }
 
+int testChunkedStorage()
+{
+  // the default allocator lets the list allocate its elements in chunks
+  typedef Dune::SLList<int> List;
+  int ret=0;
+  List alist;
+
+  for(int i=0; i<1000; ++i)
+    alist.push_back(i);
+
+  // remove every second element and insert new ones reusing their memory
+  List::ModifyIterator iter=alist.beginModify();
+  for(int i=0; i<1000; ++i) {
+    if(i%2==0)
+      iter.remove();
+    else
+      ++iter;
+  }
+  for(int i=0; i<500; ++i)
+    alist.push_front(-i);
+
+  if(alist.size()!=1000) {
+    std::cerr<<"Wrong size "<<alist.size()<<" after removal and insertion! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+
+  int expected=-499;
+  List::const_iterator citer=alist.begin();
+  for(int i=0; i<500; ++i, ++citer, ++expected)
+    if(*citer!=expected) {
+      std::cerr<<"Entry "<<*citer<<" should be "<<expected<<"! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+  for(expected=1; citer != alist.end(); ++citer, expected+=2)
+    if(*citer!=expected) {
+      std::cerr<<"Entry "<<*citer<<" should be "<<expected<<"! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ++ret;
+    }
+
+  List copied(alist);
+  if(copied!=alist) {
+    std::cerr<<"Copied list differs! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+
+  alist.clear();
+  alist.push_back(42);
+  if(alist.size()!=1 || *alist.begin()!=42 || copied.size()!=1000) {
+    std::cerr<<"Reusing cleared list failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ++ret;
+  }
+  ret+=testIterator(copied);
+  return ret;
+}
+
 int main()
 {
   int ret=0;
@@ -433,6 +488,8 @@ int main()
   ret+=testDelete();
 
   ret+=testAssign();
+  std::cout<< "test chunked storage"<<std::endl;
+  ret+=testChunkedStorage();
   list.clear();
   list1.clear();
   list2.clear();
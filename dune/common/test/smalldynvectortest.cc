@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/smalldynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/unused.hh>
+
+using Dune::SmallDynamicVector;
+
+template<class ct, int inlineSize>
+void smallDynamicVectorTest(int d) {
+  typedef SmallDynamicVector<ct,inlineSize> Vector;
+  ct a = 1;
+  Vector v(d,1);
+  Vector w(d,2);
+  Vector z(d,2);
+  bool b DUNE_UNUSED;
+
+  if (v.isInline() != (d <= inlineSize))
+    DUNE_THROW(Dune::Exception, "Wrong storage for vector of size " << d);
+
+  // Test whether the norm methods compile
+  (w+v).two_norm();
+  (w+v).two_norm2();
+  (w+v).one_norm();
+  (w+v).one_norm_real();
+  (w+v).infinity_norm();
+  (w+v).infinity_norm_real();
+
+  // test op(vec,vec)
+  z = v + w;
+  z = v - w;
+  Vector z2 = v + w;
+  w -= v;
+  w += v;
+
+  // test op(vec,scalar)
+  w +=a;
+  w -= a;
+  w *= a;
+  w /= a;
+
+  // test scalar product, axpy
+  a = v * w;
+  z = v.axpy(a,w);
+
+  // test comparison
+  b = (w != v);
+  b = (w == v);
+
+  // test mixing with DynamicVector
+  Dune::DynamicVector<ct> dv(d,3);
+  z = dv;
+  z += dv;
+  Vector z3(dv);
+  if (z3 != dv)
+    DUNE_THROW(Dune::Exception, "Conversion from DynamicVector failed");
+
+  // test istream operator
+  std::stringstream s;
+  for (int i=0; i<d; i++)
+  {
+    s << i << " ";
+    v[i] = i;
+  }
+  s >> w;
+  assert(v == w);
+
+  // test copy and move
+  Vector c(v);
+  Vector m(std::move(c));
+  if (m != v || c.size() != 0)
+    DUNE_THROW(Dune::Exception, "Copy or move of vector of size " << d << " failed");
+
+  // test growing beyond and shrinking into the inline storage
+  m.resize(2*inlineSize+d, 7);
+  if (m.isInline() || m[d-1] != ct(d-1) || m[2*inlineSize+d-1] != ct(7))
+    DUNE_THROW(Dune::Exception, "Growing vector of size " << d << " failed");
+  m.resize(d);
+  if (m != v || m.isInline() != (d <= inlineSize))
+    DUNE_THROW(Dune::Exception, "Shrinking vector of size " << d << " failed");
+}
+
+// moving a vector of arithmetic entries never throws
+static_assert(std::is_nothrow_move_constructible<SmallDynamicVector<double,3> >::value,
+              "SmallDynamicVector move constructor should be noexcept");
+static_assert(std::is_nothrow_move_assignable<SmallDynamicVector<double,3> >::value,
+              "SmallDynamicVector move assignment should be noexcept");
+
+int main()
+{
+  try {
+    for (int d=1; d<6; d++)
+    {
+      smallDynamicVectorTest<int,3>(d);
+      smallDynamicVectorTest<float,3>(d);
+      smallDynamicVectorTest<double,3>(d);
+      smallDynamicVectorTest<double,32>(d);
+    }
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
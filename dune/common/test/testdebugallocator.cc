@@ -24,10 +24,10 @@ public:
 
 void basic_tests ()
 {
-  using Dune::DebugMemory::alloc_man;
+  using Dune::DebugMemory::allocation_manager;
 
   size_t s = 256;
-  double * x = alloc_man.allocate<double>(s);
+  double * x = allocation_manager().allocate<double>(s);
   x[s-1] = 10;
 
   // access out of bounds
@@ -37,16 +37,23 @@ void basic_tests ()
 
   // lost allocation, free and double-free
 #ifndef FAILURE2
-  alloc_man.deallocate<double>(x);
+  allocation_manager().deallocate<double>(x);
 #endif
 #ifdef FAILURE3
-  alloc_man.deallocate<double>(x);
+  allocation_manager().deallocate<double>(x);
 #endif
 
   // access after free
 #ifdef FAILURE4
   x[s-1] = 10;
 #endif
+
+  // chunks ending at a page boundary, through the old name of the manager
+  for (size_t n : { 0, 512, 1024 })
+  {
+    double * y = Dune::DebugMemory::alloc_man.allocate<double>(n);
+    Dune::DebugMemory::alloc_man.deallocate<double>(y, n);
+  }
 }
 
 void allocator_tests()
@@ -62,6 +69,48 @@ void allocator_tests()
 #endif
 }
 
+void fast_tests()
+{
+  using Dune::DebugMemory::fast_allocation_manager;
+
+  // guard every second allocation
+  fast_allocation_manager().setSampleRate(2);
+
+  std::vector<double*> ptrs;
+  for (size_t s = 1; s < 2048; s *= 3)
+  {
+    double * x = fast_allocation_manager().allocate<double>(s);
+    x[0] = 1;
+    x[s-1] = 10;
+    ptrs.push_back(x);
+  }
+  fast_allocation_manager().check();
+  for (double * x : ptrs)
+    fast_allocation_manager().deallocate<double>(x);
+
+  // reuse pooled chunks
+  fast_allocation_manager().setSampleRate(0);
+  double * y = fast_allocation_manager().allocate<double>(3);
+  y[2] = 3;
+
+  // access out of bounds
+#ifdef FAILURE6
+  y[3] = 1;
+#endif
+
+  fast_allocation_manager().deallocate<double>(y);
+
+  // double-free
+#ifdef FAILURE7
+  fast_allocation_manager().deallocate<double>(y);
+#endif
+
+  std::vector<double, Dune::FastDebugAllocator<double> > v;
+  for (int i = 0; i < 100; ++i)
+    v.push_back(i);
+  std::cout << v[99] << "\n";
+}
+
 void new_delete_tests()
 {
   std::cout << "alloc double[3]\n";
@@ -99,6 +148,7 @@ int main(int, char**)
 
   basic_tests();
   allocator_tests();
+  fast_tests();
   new_delete_tests();
 #ifdef EXPECTED_SIGNAL
   return 1;
@@ -0,0 +1,113 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file
+ * \brief Exercise the tuple and type list metaprograms with large tuples
+ *
+ * This is built for several values of TUPLE_SIZE. Besides checking the
+ * results, the targets serve as a benchmark for the compile time and
+ * memory of the metaprograms, e.g. by running
+ * \code
+ * /usr/bin/time -v make tuplecompiletimetest256
+ * \endcode
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/tupleutility.hh>
+#include <dune/common/typelist.hh>
+
+#ifndef TUPLE_SIZE
+#define TUPLE_SIZE 64
+#endif
+
+constexpr std::size_t tupleSize = TUPLE_SIZE;
+
+template<std::size_t i>
+using Entry = std::integral_constant<std::size_t, i>;
+
+template<class Seq>
+struct Types;
+
+template<std::size_t... i>
+struct Types<std::index_sequence<i...> >
+{
+  typedef std::tuple<Entry<i>...> Tuple;
+  typedef Dune::TypeList<Entry<i>...> List;
+};
+
+typedef Types<std::make_index_sequence<tupleSize> >::Tuple Tuple;
+typedef Types<std::make_index_sequence<tupleSize> >::List List;
+
+// check element access and search for every index
+template<std::size_t... i>
+constexpr bool checkElements(std::index_sequence<i...>)
+{
+  const bool ok[] = {
+    (std::is_same<Dune::TypeListEntry_t<i, List>, Entry<i> >::value
+     && std::is_same<typename Dune::AtType<i, Tuple>::Type, Entry<tupleSize-1-i> >::value
+     && Dune::FirstTypeIndex<Tuple, Entry<i> >::value == i)...
+  };
+  for (bool b : ok)
+    if (!b)
+      return false;
+  return true;
+}
+
+static_assert(checkElements(std::make_index_sequence<tupleSize>()),
+              "Element access or type search failed!");
+
+static_assert(std::tuple_size<Dune::JoinTuples<Tuple, Tuple>::type>::value == 2*tupleSize,
+              "JoinTuples failed!");
+
+static_assert(std::tuple_size<Dune::FlattenTuple<std::tuple<Tuple, Tuple, Tuple> >::type>::value == 3*tupleSize,
+              "FlattenTuple failed!");
+
+template<class Sum, class Value>
+struct SumAccumulator
+{
+  typedef std::integral_constant<std::size_t, Sum::value + Value::value> type;
+};
+
+static_assert(Dune::ReduceTuple<SumAccumulator, Tuple, Entry<0> >::type::value == tupleSize*(tupleSize-1)/2,
+              "ReduceTuple failed!");
+
+template<class T>
+struct AddConst
+{
+  typedef const T Type;
+};
+
+static_assert(std::is_same<std::tuple_element<tupleSize-1, Dune::ForEachType<AddConst, Tuple>::Type>::type,
+                           const Entry<tupleSize-1> >::value,
+              "ForEachType failed!");
+
+int main()
+{
+  Tuple t;
+  std::size_t sum = 0;
+  Dune::Hybrid::forEach(t, [&](auto&& ti) {
+    sum += ti.value;
+  });
+
+  auto pointers = Dune::transformTuple<Dune::AddPtrTypeEvaluator>(t);
+  Dune::Hybrid::forEach(pointers, [&](auto&& pi) {
+    sum += pi->value;
+  });
+
+  if (sum != tupleSize*(tupleSize-1))
+  {
+    std::cerr << "Traversal of tuple with " << tupleSize << " entries failed!" << std::endl;
+    return 1;
+  }
+  return 0;
+}
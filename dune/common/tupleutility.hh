@@ -12,6 +12,7 @@
 #include <dune/common/hybridutilities.hh>
 #include <dune/common/std/type_traits.hh>
 #include <dune/common/std/utility.hh>
+#include <dune/common/typelist.hh>
 
 namespace Dune {
 
@@ -25,6 +26,81 @@ namespace Dune {
    * @brief Contains utility classes which can be used with std::tuple.
    */
 
+#ifndef DOXYGEN
+  namespace Impl {
+
+    // The element types of a tuple-like type as std::tuple
+    template<class Tuple, class Indices>
+    struct TupleTypesImpl;
+
+    template<class Tuple, std::size_t... i>
+    struct TupleTypesImpl<Tuple, std::index_sequence<i...> >
+    {
+      typedef std::tuple<typename std::tuple_element<i, Tuple>::type...> type;
+    };
+
+    template<class Tuple>
+    struct TupleTypes :
+      public TupleTypesImpl<Tuple, std::make_index_sequence<std::tuple_size<Tuple>::value> >
+    {};
+
+    template<class... T>
+    struct TupleTypes<std::tuple<T...> >
+    {
+      typedef std::tuple<T...> type;
+    };
+
+    // std::tuple_element without recursion for std::tuple
+    template<std::size_t i, class Tuple>
+    struct TupleElement :
+      public std::tuple_element<i, Tuple>
+    {};
+
+    template<std::size_t i, class... T>
+    struct TupleElement<i, std::tuple<T...> > :
+      public TypePackElement<i, T...>
+    {};
+
+    // Index of the first type accepted by Predicate, starting at start
+    template<template<class> class Predicate, class... T>
+    constexpr std::size_t firstPredicateIndex(std::size_t start, const std::tuple<T...>*)
+    {
+      const bool accepted[] = { static_cast<bool>(Predicate<T>::value)..., false };
+      std::size_t i = start;
+      while (i < sizeof...(T) && !accepted[i])
+        ++i;
+      return i;
+    }
+
+    // Concatenation of std::tuple types, recursive in the number of tuples only
+    template<class... Tuples>
+    struct JoinAll
+    {
+      typedef std::tuple<> type;
+    };
+
+    template<class... T>
+    struct JoinAll<std::tuple<T...> >
+    {
+      typedef std::tuple<T...> type;
+    };
+
+    template<class... T1, class... T2, class... Tuples>
+    struct JoinAll<std::tuple<T1...>, std::tuple<T2...>, Tuples...> :
+      public JoinAll<std::tuple<T1..., T2...>, Tuples...>
+    {};
+
+    template<class TupleTuple>
+    struct FlattenTupleTypes;
+
+    template<class... Tuples>
+    struct FlattenTupleTypes<std::tuple<Tuples...> > :
+      public JoinAll<typename TupleTypes<Tuples>::type...>
+    {};
+
+  } // namespace Impl
+#endif // DOXYGEN
+
   template<class T>
   struct TupleAccessTraits
   {
@@ -361,7 +437,7 @@ namespace Dune {
   template<int N, class Tuple>
   struct AtType
   {
-    typedef typename std::tuple_element<std::tuple_size<Tuple>::value - N - 1, Tuple>::type Type;
+    typedef typename Impl::TupleElement<std::tuple_size<Tuple>::value - N - 1, Tuple>::type Type;
   };
 
   /**
@@ -421,32 +497,28 @@ namespace Dune {
    *                   always be equal to the size of the std::tuple.
    *
    * This class can search for a type in std::tuple. It will apply the predicate
-   * to each type in std::tuple in turn, and set its member constant \c value to
-   * the index of the first type that was accepted by the predicate.  If none
-   * of the types are accepted by the predicate, a static_assert is triggered.
+   * to each type in std::tuple, and set its member constant \c value to
+   * the index of the first type after start that was accepted by the predicate.
+   * If none of the types are accepted by the predicate, a static_assert is
+   * triggered.
+   *
+   * The predicate is evaluated for all types at once, so the search does
+   * not need recursive template instantiations.
    */
   template<class Tuple, template<class> class Predicate, std::size_t start = 0,
       std::size_t size = std::tuple_size<Tuple>::value>
   class FirstPredicateIndex :
-    public std::conditional<Predicate<typename std::tuple_element<start,
-                Tuple>::type>::value,
-        std::integral_constant<std::size_t, start>,
-        FirstPredicateIndex<Tuple, Predicate, start+1> >::type
+    public std::integral_constant<std::size_t,
+        Impl::firstPredicateIndex<Predicate>(start,
+          static_cast<const typename Impl::TupleTypes<Tuple>::type*>(nullptr))>
   {
     static_assert(std::tuple_size<Tuple>::value == size, "The \"size\" "
                        "template parameter of FirstPredicateIndex is an "
                        "implementation detail and should never be set "
                        "explicitly!");
-  };
-
-#ifndef DOXYGEN
-  template<class Tuple, template<class> class Predicate, std::size_t size>
-  class FirstPredicateIndex<Tuple, Predicate, size, size>
-  {
-    static_assert(Std::to_false_type<Tuple>::value, "None of the std::tuple element "
+    static_assert(FirstPredicateIndex::value < size, "None of the std::tuple element "
                        "types matches the predicate!");
   };
-#endif // !DOXYGEN
 
   /**
    * @brief Generator for predicates accepting one particular type
@@ -533,7 +605,7 @@ namespace Dune {
   struct ReduceTuple
   {
     typedef typename ReduceTuple<F, Tuple, Seed, N-1>::type Accumulated;
-    typedef typename std::tuple_element<N-1, Tuple>::type Value;
+    typedef typename Impl::TupleElement<N-1, Tuple>::type Value;
 
     //! Result of the reduce operation
     typedef typename F<Accumulated, Value>::type type;
@@ -572,7 +644,7 @@ namespace Dune {
   struct JoinTuples
   {
     //! Result of the join operation
-    typedef typename ReduceTuple<PushBackTuple, Tail, Head>::type type;
+    typedef typename Impl::JoinAll<Head, typename Impl::TupleTypes<Tail>::type>::type type;
   };
 
   /**
@@ -587,7 +659,7 @@ namespace Dune {
   struct FlattenTuple
   {
     //! Result of the flatten operation
-    typedef typename ReduceTuple<JoinTuples, Tuple>::type type;
+    typedef typename Impl::FlattenTupleTypes<typename Impl::TupleTypes<Tuple>::type>::type type;
   };
 
   /** }@ */
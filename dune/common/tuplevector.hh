@@ -3,10 +3,18 @@
 #ifndef DUNE_COMMON_TUPLEVECTOR_HH
 #define DUNE_COMMON_TUPLEVECTOR_HH
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
+#include <dune/common/dotproduct.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/indices.hh>
+#include <dune/common/typetraits.hh>
 
 
 
@@ -19,12 +27,90 @@
 namespace Dune
 {
 
+namespace Impl
+{
+
+  // Operations on the blocks of a TupleVector. The blocks are either
+  // numbers or provide the interface of DenseVector, like nested
+  // TupleVectors do.
+
+  template<class K, std::enable_if_t<IsNumber<K>::value, int> = 0>
+  auto blockTwoNorm2(const K& k)
+  {
+    using std::abs;
+    typename FieldTraits<K>::real_type a = abs(k);
+    return a*a;
+  }
+
+  template<class B, std::enable_if_t<not IsNumber<B>::value, int> = 0>
+  auto blockTwoNorm2(const B& b)
+  {
+    return b.two_norm2();
+  }
+
+  template<class K, std::enable_if_t<IsNumber<K>::value, int> = 0>
+  auto blockOneNorm(const K& k)
+  {
+    using std::abs;
+    return typename FieldTraits<K>::real_type(abs(k));
+  }
+
+  template<class B, std::enable_if_t<not IsNumber<B>::value, int> = 0>
+  auto blockOneNorm(const B& b)
+  {
+    return b.one_norm();
+  }
+
+  template<class K, std::enable_if_t<IsNumber<K>::value, int> = 0>
+  auto blockInfinityNorm(const K& k)
+  {
+    using std::abs;
+    return typename FieldTraits<K>::real_type(abs(k));
+  }
+
+  template<class B, std::enable_if_t<not IsNumber<B>::value, int> = 0>
+  auto blockInfinityNorm(const B& b)
+  {
+    return b.infinity_norm();
+  }
+
+  template<class K1, class K2, std::enable_if_t<IsNumber<K1>::value, int> = 0>
+  auto blockDot(const K1& x, const K2& y)
+  {
+    return Dune::dot(x, y);
+  }
+
+  template<class B1, class B2, std::enable_if_t<not IsNumber<B1>::value, int> = 0>
+  auto blockDot(const B1& x, const B2& y)
+  {
+    return x.dot(y);
+  }
+
+  template<class K1, class K, class K2, std::enable_if_t<IsNumber<K1>::value, int> = 0>
+  void blockAxpy(K1& x, const K& a, const K2& y)
+  {
+    x += a*y;
+  }
+
+  template<class B1, class K, class B2, std::enable_if_t<not IsNumber<B1>::value, int> = 0>
+  void blockAxpy(B1& x, const K& a, const B2& y)
+  {
+    x.axpy(a, y);
+  }
+
+} // namespace Impl
+
 
 
 /**
  * \brief A class augmenting std::tuple by element access via operator[]
  *
  * \ingroup Utilities
+ *
+ * If all entries are numbers or vectors providing the interface of
+ * DenseVector, a TupleVector can be used as a block vector: axpy(),
+ * dot() and the norms are computed blockwise in a single pass over
+ * all blocks, unrolled at compile time.
  */
 template<class... T>
 class TupleVector : public std::tuple<T...>
@@ -66,6 +152,65 @@ public:
   {
     return std::tuple_size<Base>::value;
   }
+
+  /** \brief vector space axpy operation ( *this += a y )
+   */
+  template<class K, class... U>
+  TupleVector& axpy(const K& a, const TupleVector<U...>& y)
+  {
+    static_assert(sizeof...(U) == sizeof...(T), "TupleVectors in axpy() must have the same number of blocks");
+    Hybrid::forEach(Hybrid::zip(*this, y), [&](auto&& xy) {
+      Impl::blockAxpy(std::get<0>(xy), a, std::get<1>(xy));
+    });
+    return *this;
+  }
+
+  /** \brief vector dot product, conjugating the entries of *this
+   */
+  template<class... U>
+  auto dot(const TupleVector<U...>& y) const
+  {
+    static_assert(sizeof...(U) == sizeof...(T), "TupleVectors in dot() must have the same number of blocks");
+    using Result = std::common_type_t<decltype(Impl::blockDot(std::declval<const T&>(), std::declval<const U&>()))...>;
+    return Hybrid::transformReduce(Hybrid::zip(*this, y), Result(0), std::plus<Result>(),
+      [](const auto& xi, const auto& yi) { return Impl::blockDot(xi, yi); });
+  }
+
+  /** \brief one norm (sum over absolute values of entries)
+   */
+  auto one_norm() const
+  {
+    using Real = std::common_type_t<decltype(Impl::blockOneNorm(std::declval<const T&>()))...>;
+    return Hybrid::transformReduce(*this, Real(0), std::plus<Real>(),
+      [](const auto& b) { return Impl::blockOneNorm(b); });
+  }
+
+  /** \brief square of two norm (sum over squared values of entries)
+   */
+  auto two_norm2() const
+  {
+    using Real = std::common_type_t<decltype(Impl::blockTwoNorm2(std::declval<const T&>()))...>;
+    return Hybrid::transformReduce(*this, Real(0), std::plus<Real>(),
+      [](const auto& b) { return Impl::blockTwoNorm2(b); });
+  }
+
+  /** \brief two norm sqrt(sum over squared values of entries)
+   */
+  auto two_norm() const
+  {
+    using std::sqrt;
+    return sqrt(two_norm2());
+  }
+
+  /** \brief infinity norm (maximum of absolute values of entries)
+   */
+  auto infinity_norm() const
+  {
+    using Real = std::common_type_t<decltype(Impl::blockInfinityNorm(std::declval<const T&>()))...>;
+    return Hybrid::transformReduce(*this, Real(0),
+      [](const Real& a, const Real& b) { using std::max; return max(a, b); },
+      [](const auto& b) { return Impl::blockInfinityNorm(b); });
+  }
 };
 
 
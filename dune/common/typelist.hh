@@ -3,8 +3,10 @@
 #ifndef DUNE_COMMON_TYPELIST_HH
 #define DUNE_COMMON_TYPELIST_HH
 
+#include <cstddef>
 #include <type_traits>
 #include <tuple>
+#include <utility>
 
 
 namespace Dune {
@@ -136,6 +138,68 @@ namespace Dune {
 
 
 
+#ifndef DOXYGEN
+  namespace Impl {
+
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define DUNE_HAVE_TYPE_PACK_ELEMENT 1
+#endif
+#endif
+
+#ifdef DUNE_HAVE_TYPE_PACK_ELEMENT
+
+    template<std::size_t i, class... T>
+    struct TypePackElement
+    {
+      using type = __type_pack_element<i, T...>;
+    };
+
+#else
+
+    template<std::size_t i, class T>
+    struct IndexedType
+    {
+      using type = T;
+    };
+
+    template<class Indices, class... T>
+    struct IndexedTypes;
+
+    template<std::size_t... i, class... T>
+    struct IndexedTypes<std::index_sequence<i...>, T...> : IndexedType<i, T>...
+    {};
+
+    // selects the base class with index i by overload resolution
+    template<std::size_t i, class T>
+    IndexedType<i, T> selectIndexedType(const IndexedType<i, T>*);
+
+    template<std::size_t i, class... T>
+    struct TypePackElement
+    {
+      using type = typename decltype(selectIndexedType<i>(
+        std::declval<IndexedTypes<std::index_sequence_for<T...>, T...>*>()))::type;
+    };
+
+#endif
+#undef DUNE_HAVE_TYPE_PACK_ELEMENT
+
+  } // namespace Impl
+#endif // DOXYGEN
+
+  /**
+   * \brief Get the i-th type of a parameter pack
+   *
+   * \ingroup TypeUtilities
+   *
+   * In contrast to std::tuple_element this does not need recursive
+   * template instantiations, i.e. the cost does not grow with i.
+   */
+  template<std::size_t i, class... T>
+  using TypePackElement_t = typename Impl::TypePackElement<i, T...>::type;
+
+
+
   template<std::size_t i, class T>
   struct TypeListElement {};
 
@@ -147,17 +211,15 @@ namespace Dune {
   template<std::size_t i, class... T>
   struct TypeListElement<i, TypeList<T...>>
   {
+    static_assert(i < sizeof...(T), "TypeList index out of range");
+
     /**
      * \brief Export type of i-th element in TypeList
-     *
-     * \todo Implement without using std::tuple.
      */
-    using type = typename std::tuple_element<i, std::tuple<T...>>::type;
+    using type = TypePackElement_t<i, T...>;
 
     /**
      * \brief Export type of i-th element in TypeList
-     *
-     * \todo Implement without using std::tuple.
      */
     using Type = type;
   };